@@ -27,6 +27,7 @@ typedef long long int off_t;
 #endif
 
 #include <sys/dlist.h>
+#include <sys/slist.h>
 #include <fs/fs_interface.h>
 
 #ifdef __cplusplus
@@ -52,6 +53,17 @@ enum fs_type {
 };
 
 
+/**
+ * @brief Buffer of a vectored file read or write
+ *
+ * @param iov_base Pointer to the buffer
+ * @param iov_len Size of the buffer in bytes
+ */
+struct fs_iovec {
+	void *iov_base;
+	size_t iov_len;
+};
+
 /**
  * @brief File system mount info structure
  *
@@ -267,6 +279,38 @@ ssize_t fs_read(struct fs_file_t *zfp, void *ptr, size_t size);
  */
 ssize_t fs_write(struct fs_file_t *zfp, const void *ptr, size_t size);
 
+/**
+ * @brief Vectored file read
+ *
+ * Reads into the buffers in order, as a sequence of fs_read() calls.
+ *
+ * @param zfp Pointer to the file object
+ * @param iov Array of buffers to read into
+ * @param iovcnt Number of buffers
+ *
+ * @return Number of bytes read, less than the total size of the buffers
+ * if the end of the file is reached, or -ERRNO code if nothing could be
+ * read.
+ */
+ssize_t fs_readv(struct fs_file_t *zfp, const struct fs_iovec *iov,
+		 int iovcnt);
+
+/**
+ * @brief Vectored file write
+ *
+ * Writes the buffers in order, as a sequence of fs_write() calls.
+ *
+ * @param zfp Pointer to the file object
+ * @param iov Array of buffers to write from
+ * @param iovcnt Number of buffers
+ *
+ * @return Number of bytes written, less than the total size of the
+ * buffers if the disk got full, or -ERRNO code if nothing could be
+ * written.
+ */
+ssize_t fs_writev(struct fs_file_t *zfp, const struct fs_iovec *iov,
+		  int iovcnt);
+
 /**
  * @brief File seek
  *
@@ -333,6 +377,89 @@ int fs_truncate(struct fs_file_t *zfp, off_t length);
  */
 int fs_sync(struct fs_file_t *zfp);
 
+struct fs_async_req;
+
+/**
+ * @typedef fs_async_cb_t
+ * @brief Completion callback of an asynchronous file operation
+ *
+ * Called from the file system work queue.
+ *
+ * @param req The completed request, its result field is set
+ */
+typedef void (*fs_async_cb_t)(struct fs_async_req *req);
+
+/**
+ * @brief Asynchronous file operation request
+ *
+ * The request and its buffer belong to the file system until the request
+ * is completed. The file must stay open until then.
+ *
+ * @param node Reserved for the file system work queue
+ * @param buf Buffer to read into or write from
+ * @param size Number of bytes to read or write
+ * @param cb Called on completion if not NULL
+ * @param signal Raised with the result on completion if not NULL
+ * @param result Number of bytes read or written, 0 for a sync, or
+ * -ERRNO code on error
+ */
+struct fs_async_req {
+	sys_snode_t node;
+	void *buf;
+	size_t size;
+	fs_async_cb_t cb;
+	struct k_poll_signal *signal;
+	ssize_t result;
+	/* fields filled by file system core */
+	struct fs_file_t *zfp;
+	uint8_t op;
+};
+
+/**
+ * @brief Asynchronous file read
+ *
+ * Queues a read of req->size bytes into req->buf, done by the file system
+ * work queue. Requests are executed in the order they are submitted.
+ *
+ * @param zfp Pointer to the file object
+ * @param req Request, with buf and size set, and cb or signal to be
+ * notified of the completion
+ *
+ * @retval 0 Request queued
+ * @retval -ERRNO errno code if error
+ */
+int fs_read_async(struct fs_file_t *zfp, struct fs_async_req *req);
+
+/**
+ * @brief Asynchronous file write
+ *
+ * Queues a write of req->size bytes from req->buf, done by the file system
+ * work queue. Requests are executed in the order they are submitted, and
+ * writes queued back to back for the same file are done together.
+ *
+ * @param zfp Pointer to the file object
+ * @param req Request, with buf and size set, and cb or signal to be
+ * notified of the completion
+ *
+ * @retval 0 Request queued
+ * @retval -ERRNO errno code if error
+ */
+int fs_write_async(struct fs_file_t *zfp, struct fs_async_req *req);
+
+/**
+ * @brief Asynchronous flush of the cached writes of a file
+ *
+ * Queues a fs_sync() of the file, done by the file system work queue
+ * after the requests submitted before.
+ *
+ * @param zfp Pointer to the file object
+ * @param req Request, with cb or signal to be notified of the completion
+ *
+ * @retval 0 Request queued
+ * @retval -ERRNO errno code if error
+ */
+int fs_sync_async(struct fs_file_t *zfp, struct fs_async_req *req);
+
 /**
  * @brief Directory create
  *
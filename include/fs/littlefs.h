@@ -57,8 +57,9 @@ struct fs_littlefs {
  * values are consistent with littlefs requirements.
  *
  * @note If you use a non-default configuration for cache size, you
- * must also select :option:`CONFIG_FS_LITTLEFS_FC_MEM_POOL` to relax
- * the size constraints on per-file cache allocations.
+ * must also set :option:`CONFIG_FS_LITTLEFS_FC_HEAP_SIZE` or select
+ * :option:`CONFIG_FS_LITTLEFS_FC_MEM_POOL` to size the heap the
+ * per-file caches are allocated from.
  *
  * @param name the name for the structure.  The defined object has
  * file scope.
@@ -57,6 +57,19 @@ struct nvs_fs {
 
 	struct k_mutex nvs_lock;
 	struct device *flash_device;
+#if defined(CONFIG_NVS_LOOKUP_CACHE)
+	/* RAM index of the latest ate address of each id */
+	uint32_t lookup_cache_addr[CONFIG_NVS_LOOKUP_CACHE_SIZE];
+	uint16_t lookup_cache_id[CONFIG_NVS_LOOKUP_CACHE_SIZE];
+	bool lookup_cache_full;	/* some ids did not fit in the index */
+#endif
+#if defined(CONFIG_NVS_BACKGROUND_GC)
+	struct k_work gc_work;	/* background garbage collection */
+	struct k_sem gc_idle;	/* no background gc queued or running */
+	bool gc_stalled;	/* gc did not free enough space, wait until
+				 * the sector is full
+				 */
+#endif
 };
 
 /**
@@ -442,6 +442,45 @@ struct __thread_entry {
 };
 #endif
 
+#ifdef CONFIG_SCHED_CBS
+/**
+ * @brief Budget overrun handler of a deadline thread.
+ *
+ * Called from the system timer interrupt when @a thread used up its budget
+ * for the current period, before its deadline is postponed.
+ *
+ * @param thread Thread that overran its budget.
+ */
+typedef void (*k_thread_overrun_t)(struct k_thread *thread);
+
+/* constant bandwidth server state of a deadline thread */
+struct _thread_cbs {
+	/* overrun handler, or NULL */
+	k_thread_overrun_t overrun;
+
+	/* budget, in cycles, and period, in ticks; a zero period means no
+	 * server
+	 */
+	uint32_t budget;
+	uint32_t period;
+
+	/* reserved share of a CPU, in millionths */
+	uint32_t util;
+
+	/* budget left in the current period, in cycles */
+	int32_t budget_left;
+
+	/* release of the current job and server deadline, in ticks */
+	int64_t release;
+	int64_t deadline;
+
+	/* counters reported by k_thread_cbs_stats_get() */
+	uint32_t jobs;
+	uint32_t overruns;
+	uint32_t misses;
+};
+#endif
+
 /* can be used for creating 'dummy' threads, e.g. for pending on objects */
 struct _thread_base {
 
@@ -456,6 +495,9 @@ struct _thread_base {
 	 */
 	_wait_q_t *pended_on;
 
+	/* mutex the thread is waiting for, to propagate priority inheritance */
+	struct k_mutex *pended_mutex;
+
 	/* user facing 'thread options'; values defined in include/kernel.h */
 	uint8_t user_options;
 
@@ -493,6 +535,10 @@ struct _thread_base {
 	int prio_deadline;
 #endif
 
+#ifdef CONFIG_SCHED_CBS
+	struct _thread_cbs cbs;
+#endif
+
 	uint32_t order_key;
 
 #ifdef CONFIG_SMP
@@ -507,6 +553,11 @@ struct _thread_base {
 
 #endif
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* CPU index of the ready queue holding the thread */
+	uint8_t runq_cpu;
+#endif
+
 #ifdef CONFIG_SCHED_CPU_MASK
 	/* "May run on" bits for each CPU */
 	uint8_t cpu_mask;
@@ -559,6 +610,15 @@ struct _thread_userspace_local_data {
 };
 #endif
 
+/**
+ * @ingroup thread_apis
+ * Thread runtime statistics
+ */
+typedef struct k_thread_runtime_stats {
+	/** Cycles spent running the thread, interrupts excluded */
+	uint64_t execution_cycles;
+} k_thread_runtime_stats_t;
+
 /**
  * @ingroup thread_apis
  * Thread Structure
@@ -636,6 +696,11 @@ struct k_thread {
 	/** resource pool */
 	struct k_mem_pool *resource_pool;
 
+#if defined(CONFIG_THREAD_RUNTIME_STATS)
+	/** Runtime statistics */
+	struct k_thread_runtime_stats rt_stats;
+#endif
+
 	/** arch-specifics: must always be at the end */
 	struct _thread_arch arch;
 };
@@ -877,6 +942,25 @@ __syscall int k_thread_stack_space_get(const struct k_thread *thread,
 				       size_t *unused_ptr);
 #endif
 
+#if defined(CONFIG_THREAD_RUNTIME_STATS)
+/**
+ * @brief Get the runtime statistics of a thread
+ *
+ * The execution time of the thread is counted from the context switch
+ * hooks of the CPU stats tracing format, the time spent in interrupts
+ * is not included.  For a thread running on another CPU, the time since
+ * that CPU last switched threads or took an interrupt is not included
+ * yet.
+ *
+ * @param thread Thread to inspect
+ * @param stats Output parameter, filled in with the thread statistics
+ * @return 0 on success
+ * @return -EINVAL Invalid thread or output parameter
+ */
+int k_thread_runtime_stats_get(k_tid_t thread,
+			       k_thread_runtime_stats_t *stats);
+#endif
+
 #if (CONFIG_HEAP_MEM_POOL_SIZE > 0)
 /**
  * @brief Assign the system heap as a thread's resource pool
@@ -1034,6 +1118,9 @@ __syscall void k_thread_start(k_tid_t thread);
 
 extern k_ticks_t z_timeout_expires(struct _timeout *timeout);
 extern k_ticks_t z_timeout_remaining(struct _timeout *timeout);
+#ifdef CONFIG_TIMEOUT_SLACK
+extern void z_timeout_slack_set(struct _timeout *timeout, k_timeout_t slack);
+#endif
 
 #ifdef CONFIG_SYS_CLOCK_EXISTS
 
@@ -1233,6 +1320,89 @@ __syscall void k_thread_priority_set(k_tid_t thread, int prio);
 __syscall void k_thread_deadline_set(k_tid_t thread, int deadline);
 #endif
 
+#ifdef CONFIG_SCHED_CBS
+/**
+ * @brief Statistics of a deadline thread.
+ */
+struct k_thread_cbs_stats {
+	/** Jobs completed with k_thread_period_wait() */
+	uint32_t jobs;
+	/** Periods in which the thread used up its budget */
+	uint32_t overruns;
+	/** Jobs completed after the end of their period */
+	uint32_t misses;
+};
+
+/**
+ * @brief Make a thread periodic with a reserved CPU bandwidth
+ *
+ * The thread gets @a budget_us of CPU time every @a period_us, enforced by
+ * a constant bandwidth server (CBS). Its deadline, used to choose between
+ * threads at the same static priority, is the end of its current period.
+ * When it uses up its budget, @a overrun is called, the budget is
+ * replenished and the deadline is postponed by a period, so that the
+ * thread cannot take more than its share of the CPU from the other
+ * deadline threads.
+ *
+ * The call fails when the total bandwidth reserved by all the threads
+ * would exceed :option:`CONFIG_SCHED_CBS_MAX_UTILIZATION` percent of a
+ * CPU. The current period of the thread starts with the call.
+ *
+ * The period is rounded up to system ticks, and the budget is enforced
+ * with the granularity of the system timer.
+ *
+ * @note
+ *    @rst
+ *    You should enable :option:`CONFIG_SCHED_CBS` in your project
+ *    configuration.
+ *    @endrst
+ *
+ * @param thread Thread to operate upon
+ * @param budget_us CPU time per period, in microseconds, or 0 to release
+ *	  the bandwidth of the thread
+ * @param period_us Period, in microseconds
+ * @param overrun Budget overrun handler, or NULL
+ *
+ * @retval 0 on success
+ * @retval -EINVAL if the budget is longer than the period
+ * @retval -EBUSY if the bandwidth is not available
+ */
+int k_thread_cbs_set(k_tid_t thread, uint32_t budget_us, uint32_t period_us,
+		     k_thread_overrun_t overrun);
+
+/**
+ * @brief Wait for the next period of the current thread
+ *
+ * Ends the current job of a thread made periodic with k_thread_cbs_set(),
+ * and sleeps until the start of its next period, where its budget is
+ * replenished and its deadline set to the end of that period. A job that
+ * completes after the end of its period is counted as a deadline miss and
+ * the next one starts right away.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL if the thread is not periodic
+ */
+__syscall int k_thread_period_wait(void);
+
+/**
+ * @brief Get the statistics of a deadline thread
+ *
+ * @param thread Thread to operate upon
+ * @param stats Buffer for the statistics
+ *
+ * @retval 0 on success
+ * @retval -EINVAL if the thread is not periodic
+ */
+int k_thread_cbs_stats_get(k_tid_t thread, struct k_thread_cbs_stats *stats);
+
+/**
+ * @brief Get the CPU bandwidth reserved by all deadline threads
+ *
+ * @return Reserved share of a CPU, in millionths
+ */
+uint32_t k_sched_cbs_utilization_get(void);
+#endif
+
 #ifdef CONFIG_SCHED_CPU_MASK
 /**
  * @brief Sets all CPU enable masks to zero
@@ -1880,6 +2050,33 @@ extern void k_timer_init(struct k_timer *timer,
 __syscall void k_timer_start(struct k_timer *timer,
 			     k_timeout_t duration, k_timeout_t period);
 
+#ifdef CONFIG_TIMEOUT_SLACK
+/**
+ * @brief Allow a timer to expire late.
+ *
+ * This routine lets the timer expire up to @a slack after its nominal
+ * expiry time, so that the kernel can handle it in the same wakeup as
+ * other timeouts expiring in the meantime, rather than wake up the
+ * system for it alone.  The time of the following periodic expiries is
+ * not affected.
+ *
+ * The slack applies from the next start of the timer, and is kept until
+ * it is changed or the timer is initialized again.
+ *
+ * @note
+ *    @rst
+ *    You should enable :option:`CONFIG_TIMEOUT_SLACK` in your project
+ *    configuration.
+ *    @endrst
+ *
+ * @param timer     Address of timer.
+ * @param slack     Maximum delay of the expiries, K_NO_WAIT for none.
+ *
+ * @return N/A
+ */
+__syscall void k_timer_slack_set(struct k_timer *timer, k_timeout_t slack);
+#endif
+
 /**
  * @brief Stop a timer.
  *
@@ -3441,6 +3638,35 @@ static inline int32_t k_delayed_work_remaining_get(struct k_delayed_work *work)
 	return k_ticks_to_ms_floor32(z_timeout_remaining(&work->timeout));
 }
 
+#ifdef CONFIG_TIMEOUT_SLACK
+/**
+ * @brief Allow a delayed work item to be submitted late.
+ *
+ * This routine lets the delayed work item be submitted to its workqueue
+ * up to @a slack after its delay elapses, so that the kernel can handle
+ * it in the same wakeup as other timeouts expiring in the meantime.
+ *
+ * The slack applies from the next submission of the work item, and is kept
+ * until it is changed or the work item is initialized again.
+ *
+ * @note
+ *    @rst
+ *    You should enable :option:`CONFIG_TIMEOUT_SLACK` in your project
+ *    configuration.
+ *    @endrst
+ *
+ * @param work Delayed work item.
+ * @param slack Maximum delay of the submission, K_NO_WAIT for none.
+ *
+ * @return N/A
+ */
+static inline void k_delayed_work_slack_set(struct k_delayed_work *work,
+					    k_timeout_t slack)
+{
+	z_timeout_slack_set(&work->timeout, slack);
+}
+#endif
+
 /**
  * @brief Initialize a triggered work item.
  *
@@ -3871,6 +4097,8 @@ struct k_msgq {
 
 
 #define K_MSGQ_FLAG_ALLOC	BIT(0)
+#define K_MSGQ_FLAG_PUT_CLAIMED	BIT(1)
+#define K_MSGQ_FLAG_GET_CLAIMED	BIT(2)
 
 /**
  * @brief Message Queue Attributes
@@ -4035,6 +4263,76 @@ __syscall int k_msgq_peek(struct k_msgq *msgq, void *data);
  */
 __syscall void k_msgq_purge(struct k_msgq *msgq);
 
+/**
+ * @brief Claim a free message in a message queue.
+ *
+ * This routine gives direct access to the next free message of the
+ * queue's ring buffer, so that it can be produced there instead of being
+ * copied in by k_msgq_put(). The message is sent by k_msgq_put_finish().
+ *
+ * The queue must not be written by other means while a message is claimed.
+ *
+ * @note Can be called by ISRs.
+ * @note Not available from user mode.
+ *
+ * @param msgq Address of the message queue.
+ * @param data Address of the claimed message.
+ *
+ * @retval 0 Message claimed.
+ * @retval -ENOMSG The queue is full.
+ * @retval -EBUSY A message is already claimed.
+ */
+int k_msgq_put_claim(struct k_msgq *msgq, void **data);
+
+/**
+ * @brief Send the message claimed with k_msgq_put_claim().
+ *
+ * A thread waiting for a message receives it.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param msgq Address of the message queue.
+ *
+ * @retval 0 Message sent.
+ * @retval -EINVAL No message is claimed.
+ */
+int k_msgq_put_finish(struct k_msgq *msgq);
+
+/**
+ * @brief Claim the first message of a message queue.
+ *
+ * This routine gives direct access to the first message in the queue's
+ * ring buffer, so that it can be consumed there instead of being copied
+ * out by k_msgq_get(). The message is removed by k_msgq_get_finish().
+ *
+ * The queue must not be read by other means while a message is claimed.
+ *
+ * @note Can be called by ISRs.
+ * @note Not available from user mode.
+ *
+ * @param msgq Address of the message queue.
+ * @param data Address of the claimed message.
+ *
+ * @retval 0 Message claimed.
+ * @retval -ENOMSG The queue is empty.
+ * @retval -EBUSY A message is already claimed.
+ */
+int k_msgq_get_claim(struct k_msgq *msgq, void **data);
+
+/**
+ * @brief Remove the message claimed with k_msgq_get_claim().
+ *
+ * The message of the first thread waiting to send one takes its place.
+ *
+ * @note Can be called by ISRs.
+ *
+ * @param msgq Address of the message queue.
+ *
+ * @retval 0 Message removed.
+ * @retval -EINVAL No message is claimed, or the queue was purged.
+ */
+int k_msgq_get_finish(struct k_msgq *msgq);
+
 /**
  * @brief Get the amount of free space in a message queue.
  *
@@ -4082,6 +4380,168 @@ static inline uint32_t z_impl_k_msgq_num_used_get(struct k_msgq *msgq)
 	return msgq->used_msgs;
 }
 
+#ifdef CONFIG_MSGQ_LOCKFREE
+
+/** Lock-free message queue flag: the queue has several producers. */
+#define K_MSGQ_LF_MPSC BIT(0)
+
+/**
+ * @brief Lock-free Message Queue Structure
+ */
+struct k_msgq_lf {
+	/** Threads waiting for a message */
+	_wait_q_t get_wait_q;
+	/** Threads waiting for a free slot */
+	_wait_q_t put_wait_q;
+	/** Lock, only taken to block or to wake a thread */
+	struct k_spinlock lock;
+	/** Message slots */
+	char *buffer;
+	/** Message size */
+	size_t msg_size;
+	/** Slot size, the message and its sequence number */
+	size_t slot_size;
+	/** Maximal number of messages, a power of two */
+	uint32_t max_msgs;
+	/** Number of messages put, including the ones being written */
+	atomic_t head;
+	/** Number of messages got */
+	atomic_t tail;
+	/** Number of blocked threads */
+	atomic_t waiters;
+	/** Flags */
+	uint8_t flags;
+};
+
+/**
+ * @cond INTERNAL_HIDDEN
+ */
+
+#define Z_MSGQ_LF_SLOT_SIZE(q_msg_size) \
+	ROUND_UP(sizeof(atomic_t) + (q_msg_size), sizeof(atomic_t))
+
+#define Z_MSGQ_LF_INITIALIZER(obj, q_buffer, q_msg_size, q_max_msgs, q_flags) \
+	{ \
+	.get_wait_q = Z_WAIT_Q_INIT(&obj.get_wait_q), \
+	.put_wait_q = Z_WAIT_Q_INIT(&obj.put_wait_q), \
+	.buffer = q_buffer, \
+	.msg_size = q_msg_size, \
+	.slot_size = Z_MSGQ_LF_SLOT_SIZE(q_msg_size), \
+	.max_msgs = q_max_msgs, \
+	.flags = q_flags, \
+	}
+
+/**
+ * INTERNAL_HIDDEN @endcond
+ */
+
+/**
+ * @brief Size of the buffer of a lock-free message queue.
+ *
+ * @param q_msg_size Message size (in bytes).
+ * @param q_max_msgs Maximum number of messages that can be queued.
+ */
+#define K_MSGQ_LF_BUF_SIZE(q_msg_size, q_max_msgs) \
+	((q_max_msgs) * Z_MSGQ_LF_SLOT_SIZE(q_msg_size))
+
+/**
+ * @brief Statically define and initialize a lock-free message queue.
+ *
+ * The queue has a single consumer, and a single producer unless
+ * K_MSGQ_LF_MPSC is given in @a q_flags. Each message is stored with a
+ * sequence number and is aligned to the size of an atomic_t.
+ *
+ * @param q_name Name of the message queue.
+ * @param q_msg_size Message size (in bytes).
+ * @param q_max_msgs Maximum number of messages, a power of two of at least 2.
+ * @param q_flags 0 or K_MSGQ_LF_MPSC.
+ */
+#define K_MSGQ_LF_DEFINE(q_name, q_msg_size, q_max_msgs, q_flags)	\
+	BUILD_ASSERT((q_max_msgs) >= 2 &&				\
+		     ((q_max_msgs) & ((q_max_msgs) - 1)) == 0,		\
+		     "max_msgs must be a power of two");		\
+	static char __aligned(sizeof(atomic_t))				\
+		_k_msgq_lf_buf_##q_name[K_MSGQ_LF_BUF_SIZE(q_msg_size,	\
+							   q_max_msgs)]; \
+	struct k_msgq_lf q_name =					\
+		Z_MSGQ_LF_INITIALIZER(q_name, _k_msgq_lf_buf_##q_name,	\
+				      q_msg_size, q_max_msgs, q_flags)
+
+/**
+ * @brief Initialize a lock-free message queue.
+ *
+ * The buffer must be K_MSGQ_LF_BUF_SIZE() bytes long and aligned to the
+ * size of an atomic_t.
+ *
+ * @param q Address of the message queue.
+ * @param buffer Buffer holding the message slots.
+ * @param msg_size Message size (in bytes).
+ * @param max_msgs Maximum number of messages, a power of two of at least 2.
+ * @param flags 0 or K_MSGQ_LF_MPSC.
+ *
+ * @return N/A
+ */
+void k_msgq_lf_init(struct k_msgq_lf *q, char *buffer, size_t msg_size,
+		    uint32_t max_msgs, uint8_t flags);
+
+/**
+ * @brief Send a message to a lock-free message queue.
+ *
+ * Only one thread or ISR may send messages at a time unless the queue
+ * was created with K_MSGQ_LF_MPSC.
+ *
+ * @note Can be called by ISRs, with a timeout of K_NO_WAIT.
+ * @note Not available from user mode.
+ *
+ * @param q Address of the message queue.
+ * @param data Pointer to the message.
+ * @param timeout Non-negative waiting period to add the message,
+ *                or one of the special values K_NO_WAIT and
+ *                K_FOREVER.
+ *
+ * @retval 0 Message sent.
+ * @retval -ENOMSG Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+int k_msgq_lf_put(struct k_msgq_lf *q, const void *data,
+		  k_timeout_t timeout);
+
+/**
+ * @brief Receive a message from a lock-free message queue.
+ *
+ * Only one thread or ISR may receive messages at a time.
+ *
+ * @note Can be called by ISRs, with a timeout of K_NO_WAIT.
+ * @note Not available from user mode.
+ *
+ * @param q Address of the message queue.
+ * @param data Address of area to hold the received message.
+ * @param timeout Non-negative waiting period to receive the message,
+ *                or one of the special values K_NO_WAIT and
+ *                K_FOREVER.
+ *
+ * @retval 0 Message received.
+ * @retval -ENOMSG Returned without waiting.
+ * @retval -EAGAIN Waiting period timed out.
+ */
+int k_msgq_lf_get(struct k_msgq_lf *q, void *data, k_timeout_t timeout);
+
+/**
+ * @brief Get the number of messages in a lock-free message queue.
+ *
+ * The messages being written by a producer are included.
+ *
+ * @param q Address of the message queue.
+ *
+ * @return Number of messages.
+ */
+static inline uint32_t k_msgq_lf_num_used_get(struct k_msgq_lf *q)
+{
+	return (uint32_t)atomic_get(&q->head) - (uint32_t)atomic_get(&q->tail);
+}
+
+#endif /* CONFIG_MSGQ_LOCKFREE */
+
 /** @} */
 
 /**
@@ -4300,6 +4760,8 @@ struct k_pipe {
 	size_t         bytes_used;      /**< # bytes used in buffer */
 	size_t         read_index;      /**< Where in buffer to read from */
 	size_t         write_index;     /**< Where in buffer to write */
+	size_t         put_claimed;     /**< # bytes claimed for writing */
+	size_t         get_claimed;     /**< # bytes claimed for reading */
 	struct k_spinlock lock;		/**< Synchronization lock */
 
 	struct {
@@ -4324,6 +4786,8 @@ struct k_pipe {
 	.bytes_used = 0,                                            \
 	.read_index = 0,                                            \
 	.write_index = 0,                                           \
+	.put_claimed = 0,                                           \
+	.get_claimed = 0,                                           \
 	.lock = {},                                                 \
 	.wait_q = {                                                 \
 		.readers = Z_WAIT_Q_INIT(&obj.wait_q.readers),       \
@@ -4485,6 +4949,82 @@ __syscall size_t k_pipe_read_avail(struct k_pipe *pipe);
  */
 __syscall size_t k_pipe_write_avail(struct k_pipe *pipe);
 
+/**
+ * @brief Claim space in the buffer of a pipe for writing.
+ *
+ * This routine gives direct access to the free space of the pipe's buffer,
+ * so that data can be produced there instead of being copied in by
+ * k_pipe_put(). The space is contiguous, so less than @a size bytes can
+ * be claimed when the free space wraps around the end of the buffer; the
+ * rest can be claimed by calling the routine again. The data is made
+ * available to the readers by k_pipe_put_finish().
+ *
+ * The pipe must not be written by other means while space is claimed.
+ *
+ * @note Not available from user mode.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Address of the claimed space.
+ * @param size Number of bytes to claim.
+ *
+ * @return Number of bytes claimed, 0 when the buffer is full or the pipe
+ *         has no buffer.
+ */
+size_t k_pipe_put_claim(struct k_pipe *pipe, uint8_t **data, size_t size);
+
+/**
+ * @brief Write claimed bytes to a pipe.
+ *
+ * This routine adds the first @a size bytes of the space claimed with
+ * k_pipe_put_claim() to the pipe, the rest of the claim is released.
+ * Readers waiting for data get it.
+ *
+ * @param pipe Address of the pipe.
+ * @param size Number of bytes written.
+ *
+ * @retval 0 Bytes written.
+ * @retval -EINVAL @a size exceeds the number of claimed bytes.
+ */
+int k_pipe_put_finish(struct k_pipe *pipe, size_t size);
+
+/**
+ * @brief Claim data in the buffer of a pipe for reading.
+ *
+ * This routine gives direct access to the data in the pipe's buffer, so
+ * that it can be consumed there instead of being copied out by
+ * k_pipe_get(). The data is contiguous, so less than @a size bytes can
+ * be claimed when it wraps around the end of the buffer; the rest can be
+ * claimed by calling the routine again. The data is removed from the pipe
+ * by k_pipe_get_finish().
+ *
+ * The pipe must not be read by other means while data is claimed.
+ *
+ * @note Not available from user mode.
+ *
+ * @param pipe Address of the pipe.
+ * @param data Address of the claimed data.
+ * @param size Number of bytes to claim.
+ *
+ * @return Number of bytes claimed, 0 when the buffer is empty or the pipe
+ *         has no buffer.
+ */
+size_t k_pipe_get_claim(struct k_pipe *pipe, uint8_t **data, size_t size);
+
+/**
+ * @brief Read claimed bytes from a pipe.
+ *
+ * This routine removes the first @a size bytes of the data claimed with
+ * k_pipe_get_claim() from the pipe, the rest is left for the next read.
+ * Writers waiting for space fill the freed space.
+ *
+ * @param pipe Address of the pipe.
+ * @param size Number of bytes read.
+ *
+ * @retval 0 Bytes read.
+ * @retval -EINVAL @a size exceeds the number of claimed bytes.
+ */
+int k_pipe_get_finish(struct k_pipe *pipe, size_t size);
+
 /** @} */
 
 /**
@@ -5193,6 +5733,36 @@ static inline void k_cpu_atomic_idle(unsigned int key)
 	arch_cpu_atomic_idle(key);
 }
 
+#ifdef CONFIG_IDLE_WAKEUP_STATS
+/**
+ * @brief Idle wakeup statistics.
+ */
+struct k_idle_stats {
+	/** Wakeups of the idle threads of all the CPUs since boot */
+	uint64_t wakeups;
+	/** Wakeups per second, over the last second or more */
+	uint32_t wakeups_per_sec;
+};
+
+/**
+ * @brief Get the idle wakeup statistics.
+ *
+ * A wakeup is counted each time an idle thread returns from idling the
+ * CPU, whether because of a timeout or of another interrupt.
+ *
+ * @note
+ *    @rst
+ *    You should enable :option:`CONFIG_IDLE_WAKEUP_STATS` in your project
+ *    configuration.
+ *    @endrst
+ *
+ * @param stats Buffer for the statistics.
+ *
+ * @return N/A
+ */
+void k_idle_stats_get(struct k_idle_stats *stats);
+#endif
+
 /**
  * @}
  */
@@ -122,12 +122,28 @@ struct _cpu {
 	int slice_ticks;
 #endif
 
+#ifdef CONFIG_SCHED_CBS
+	/* deadline thread running on this CPU, charged for the time since
+	 * cbs_start
+	 */
+	struct k_thread *cbs_thread;
+	uint32_t cbs_start;
+#endif
+
 	uint8_t id;
 
 #ifdef CONFIG_SMP
 	/* True when _current is allowed to context switch */
 	uint8_t swap_ok;
 #endif
+
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* thread chosen by the last scheduling decision of this CPU */
+	struct k_thread *sched_next;
+
+	/* ready queue of the threads to run on this CPU */
+	struct _ready_q ready_q;
+#endif
 };
 
 typedef struct _cpu _cpu_t;
@@ -222,6 +238,10 @@ struct _timeout {
 	sys_dnode_t node;
 	int32_t dticks;
 	_timeout_func_t fn;
+#ifdef CONFIG_TIMEOUT_SLACK
+	/* ticks the timeout may expire late, to share a wakeup */
+	int32_t slack;
+#endif
 };
 
 /* kernel spinlock type */
@@ -148,6 +148,11 @@ struct http_response {
 	uint8_t cl_present : 1;
 	uint8_t body_found : 1;
 	uint8_t message_complete : 1;
+
+	/** Set when the response is complete if the server allows the
+	 * connection to be used for further requests.
+	 */
+	uint8_t keep_alive : 1;
 };
 
 /** HTTP client internal data that the application should not touch
@@ -284,6 +289,32 @@ struct http_request {
 int http_client_req(int sock, struct http_request *req,
 		    int32_t timeout, void *user_data);
 
+/**
+ * @brief Do several HTTP requests over one persistent connection. All the
+ * requests are sent back to back (HTTP/1.1 pipelining) before waiting for
+ * the responses, and the responses are then delivered in order to the
+ * response callbacks of the matching requests. The headers of the requests
+ * are coalesced into as few socket writes as possible.
+ *
+ * The connection is not closed by this function, so the socket can be used
+ * for further requests as long as the keep_alive flag of the last response
+ * is set. The caller must have created a connection to the server before
+ * calling this function.
+ *
+ * @param sock Socket id of the connection.
+ * @param reqs Array of HTTP requests. The requests are sent in this order.
+ * @param count Number of requests in the array.
+ * @param timeout Max timeout to wait for all the responses. The timeout value
+ *        cannot be 0 as there would be no time to receive the data.
+ *        The timeout value is in milliseconds.
+ * @param user_data User specified data that is passed to the callbacks.
+ *
+ * @return <0 if error, >=0 number of responses that were fully received.
+ *         If this is less than count, the connection should be closed.
+ */
+int http_client_req_pipeline(int sock, struct http_request **reqs,
+			     size_t count, int32_t timeout, void *user_data);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,249 @@
+/** @file
+ * @brief HTTP server API
+ *
+ * An API for applications to serve HTTP requests
+ */
+
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_
+#define ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_
+
+/**
+ * @brief HTTP server API
+ * @defgroup http_server HTTP server API
+ * @ingroup networking
+ * @{
+ */
+
+#include <kernel.h>
+#include <net/net_ip.h>
+#include <net/socket.h>
+#include <net/http_parser.h>
+
+#if defined(CONFIG_FILE_SYSTEM)
+#include <fs/fs.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if !defined(HTTP_CRLF)
+#define HTTP_CRLF "\r\n"
+#endif
+
+/** Where the content of a resource comes from */
+enum http_resource_type {
+	/** Content is a constant array in memory */
+	HTTP_RESOURCE_STATIC = 0,
+	/** Content is a file in the file system */
+	HTTP_RESOURCE_FS,
+	/** Content is generated by a callback and sent in chunks */
+	HTTP_RESOURCE_DYNAMIC,
+};
+
+/**
+ * Request information given to the callback of a dynamic resource.
+ */
+struct http_server_request {
+	/** The HTTP method of the request */
+	enum http_method method;
+
+	/** The URL of the request, without the query string */
+	char url[CONFIG_HTTP_SERVER_MAX_URL_LEN];
+
+	/** The query string of the request, empty if there is none */
+	const char *query;
+
+	/** Amount of response data generated so far */
+	size_t offset;
+};
+
+/**
+ * @typedef http_resource_cb_t
+ * @brief Callback used to generate the content of a dynamic resource.
+ *
+ * @details The callback is called repeatedly until it returns 0. Every
+ * call generates one chunk of the response which is sent to the client
+ * using the chunked transfer coding.
+ *
+ * @param req Request that is being served.
+ * @param buf Buffer where the next part of the response should be written.
+ * @param len Max amount of data that can be written into the buffer.
+ * @param user_data User data of the resource.
+ *
+ * @return >0 amount of data written, 0 if the response is complete,
+ *         <0 if there is an error and the connection should be closed.
+ */
+typedef int (*http_resource_cb_t)(struct http_server_request *req,
+				  uint8_t *buf, size_t len, void *user_data);
+
+/**
+ * HTTP server resource. The application gives an array of these to
+ * http_server_init().
+ */
+struct http_server_resource {
+	/** The path of the resource, for example: /index.html */
+	const char *path;
+
+	/** The value of the Content-Type header field, may be NULL */
+	const char *content_type;
+
+	/** Where the content comes from */
+	enum http_resource_type type;
+
+	union {
+		/** Content of a HTTP_RESOURCE_STATIC resource */
+		struct {
+			const uint8_t *data;
+			size_t len;
+		} static_data;
+
+		/** File name of a HTTP_RESOURCE_FS resource */
+		const char *fs_path;
+
+		/** Callback of a HTTP_RESOURCE_DYNAMIC resource */
+		http_resource_cb_t cb;
+	};
+
+	/** User data passed to the callback */
+	void *user_data;
+};
+
+/** HTTP server connection data that the application should not touch
+ */
+struct http_server_client {
+	/** HTTP parser context */
+	struct http_parser parser;
+
+	/** Request that is currently being received or served */
+	struct http_server_request req;
+
+	/** Resource that is being sent */
+	const struct http_server_resource *resource;
+
+#if defined(CONFIG_FILE_SYSTEM)
+	/** File of a HTTP_RESOURCE_FS resource */
+	struct fs_file_t file;
+#endif
+
+	/** Amount of static or file content still to be sent */
+	size_t body_left;
+
+	/** Time of the last activity, used to close idle connections */
+	int64_t last_activity;
+
+	/** Amount of data in rx_buf, and how much of it is parsed */
+	size_t rx_len;
+	size_t rx_parsed;
+
+	/** Amount of data in tx_buf, and how much of it is sent */
+	size_t tx_len;
+	size_t tx_pos;
+
+	/** Socket of the connection, <0 if the slot is free */
+	int sock;
+
+	/** Length of the URL received so far */
+	uint16_t url_len;
+
+	/** Status code of the response */
+	uint16_t status;
+
+	/** Is the complete request received and the response being sent */
+	uint8_t responding : 1;
+
+	/** Can the connection be reused after the response */
+	uint8_t keep_alive : 1;
+
+	/** Is the response body sent using the chunked transfer coding */
+	uint8_t chunked : 1;
+
+	/** Is all of the response placed into tx_buf */
+	uint8_t body_done : 1;
+
+	/** Is the file of the resource open */
+	uint8_t file_open : 1;
+
+	uint8_t rx_buf[CONFIG_HTTP_SERVER_CLIENT_BUF_LEN];
+	uint8_t tx_buf[CONFIG_HTTP_SERVER_CLIENT_BUF_LEN];
+};
+
+/**
+ * HTTP server context. The application allocates this and must not touch
+ * the fields after http_server_init().
+ */
+struct http_server_ctx {
+	/** Poll entries, first one is the listening socket */
+	struct zsock_pollfd fds[CONFIG_HTTP_SERVER_MAX_CLIENTS + 1];
+
+	/** Client connections */
+	struct http_server_client clients[CONFIG_HTTP_SERVER_MAX_CLIENTS];
+
+	/** HTTP parser settings shared by all the connections */
+	struct http_parser_settings parser_settings;
+
+	/** Resources served by this server */
+	const struct http_server_resource *resources;
+
+	/** Number of resources */
+	size_t resource_count;
+
+	/** Listening socket */
+	int listen_sock;
+
+	/** Set by http_server_stop() */
+	atomic_t stop;
+};
+
+/**
+ * @brief Initialize a HTTP server. This creates the listening socket but
+ * no connections are accepted until http_server_run() is called.
+ *
+ * @param ctx HTTP server context.
+ * @param addr Local address and port to listen to.
+ * @param addrlen Length of the address.
+ * @param resources Resources served by the server. The array must be valid
+ *        while the server is running.
+ * @param resource_count Number of resources.
+ *
+ * @return 0 if ok, <0 if error.
+ */
+int http_server_init(struct http_server_ctx *ctx,
+		     const struct sockaddr *addr, socklen_t addrlen,
+		     const struct http_server_resource *resources,
+		     size_t resource_count);
+
+/**
+ * @brief Run a HTTP server. All the connections are handled in the calling
+ * thread, which is blocked until http_server_stop() is called.
+ *
+ * @param ctx HTTP server context.
+ *
+ * @return 0 if the server was stopped, <0 if error.
+ */
+int http_server_run(struct http_server_ctx *ctx);
+
+/**
+ * @brief Stop a running HTTP server. All the connections and the listening
+ * socket are closed by the thread running http_server_run() before it
+ * returns.
+ *
+ * @param ctx HTTP server context.
+ */
+void http_server_stop(struct http_server_ctx *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* ZEPHYR_INCLUDE_NET_HTTP_SERVER_H_ */
@@ -119,6 +119,42 @@ struct zsock_pollfd {
  *    - 1 - server
  */
 #define TLS_DTLS_ROLE 6
+/** Socket option to enable TLS session resumption. For clients, the
+ *  session is stored after a successful handshake and offered to the same
+ *  peer (address and hostname) on the next connection, so that an
+ *  abbreviated handshake can be done. Session tickets (RFC 5077) are
+ *  requested from the server if mbedTLS supports them. For servers, session
+ *  tickets are issued and sessions are cached for session ID based
+ *  resumption. This option accepts and returns an integer:
+ *    - 0 - disabled (default)
+ *    - 1 - enabled
+ */
+#define TLS_SESSION_CACHE 7
+/** Write-only socket option to remove all the sessions from the TLS session
+ *  caches. The option value is ignored.
+ */
+#define TLS_SESSION_CACHE_PURGE 8
+/** Socket option to use the DTLS connection ID (RFC 9146), which lets
+ *  a DTLS connection survive changes of the peer address, for example
+ *  NAT rebinding, without a new handshake. This option accepts and returns
+ *  an integer:
+ *    - 0 - disabled (default)
+ *    - 1 - supported, the peer may use its own connection ID but it is not
+ *          asked to use one in the records sent to us
+ *    - 2 - enabled, the peer is asked to use a connection ID
+ *
+ *  Address changes are followed by multi-peer DTLS servers.
+ */
+#define TLS_DTLS_CID 9
+/** Socket option to serve many peers with a single DTLS server socket.
+ *  Each peer gets its own DTLS session, the source address given by
+ *  recvfrom() tells which peer sent the data, and sendto() must be given
+ *  the address of an established peer. Can only be set before the first
+ *  data is received. This option accepts and returns an integer:
+ *    - 0 - single peer (default)
+ *    - 1 - many peers
+ */
+#define TLS_DTLS_MULTI_PEER 10
 
 /** @} */
 
@@ -131,6 +167,15 @@ struct zsock_pollfd {
 #define TLS_DTLS_ROLE_CLIENT 0 /**< Client role in a DTLS session. */
 #define TLS_DTLS_ROLE_SERVER 1 /**< Server role in a DTLS session. */
 
+/* Valid values for TLS_SESSION_CACHE option */
+#define TLS_SESSION_CACHE_DISABLED 0 /**< Session caching disabled. */
+#define TLS_SESSION_CACHE_ENABLED 1 /**< Session caching enabled. */
+
+/* Valid values for TLS_DTLS_CID option */
+#define TLS_DTLS_CID_DISABLED 0 /**< Connection ID disabled. */
+#define TLS_DTLS_CID_SUPPORTED 1 /**< Peer may use a connection ID. */
+#define TLS_DTLS_CID_ENABLED 2 /**< Connection ID used in both directions. */
+
 struct zsock_addrinfo {
 	struct zsock_addrinfo *ai_next;
 	int ai_flags;
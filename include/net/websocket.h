@@ -151,6 +151,50 @@ int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 		       enum websocket_opcode opcode, bool mask, bool final,
 		       int32_t timeout);
 
+/**
+ * @typedef websocket_payload_cb_t
+ * @brief Callback used by websocket_send_stream() to fetch the payload.
+ *
+ * @param buf Buffer where the next part of the payload should be copied.
+ * @param len Max amount of data that can be copied into the buffer.
+ * @param user_data User data given to websocket_send_stream().
+ *
+ * @return >0 amount of bytes copied, <=0 if there is an error and the
+ *         sending should be aborted.
+ */
+typedef int (*websocket_payload_cb_t)(uint8_t *buf, size_t len,
+				      void *user_data);
+
+/**
+ * @brief Send websocket msg to peer without having the whole payload in
+ * memory.
+ *
+ * @details The function sends one websocket frame which has payload_len
+ * bytes of data. The payload is fetched from the callback in pieces of
+ * at most CONFIG_WEBSOCKET_TX_BUF_LEN bytes and sent (masked if needed) as
+ * soon as it is received. Very large messages can be sent as several
+ * fragments by setting final to false and using opcode
+ * WEBSOCKET_OPCODE_CONTINUE for the subsequent fragments, see
+ * websocket_send_msg(). If the callback fails after part of the frame has
+ * been sent, the connection is out of sync and should be closed.
+ *
+ * @param ws_sock Websocket id returned by websocket_connect().
+ * @param payload_len Length of the data to be sent.
+ * @param cb Callback that is called to get the payload data.
+ * @param user_data User specified data that is passed to the callback.
+ * @param opcode Operation code (text, binary, ping, pong, close)
+ * @param mask Mask the data, see RFC 6455 for details
+ * @param final Is this final message for this message send.
+ * @param timeout How long to try to send the message. The value is in
+ *        milliseconds. Value SYS_FOREVER_MS means to wait forever.
+ *
+ * @return <0 if error, >=0 amount of bytes sent
+ */
+int websocket_send_stream(int ws_sock, size_t payload_len,
+			  websocket_payload_cb_t cb, void *user_data,
+			  enum websocket_opcode opcode, bool mask, bool final,
+			  int32_t timeout);
+
 /**
  * @brief Receive websocket msg from peer.
  *
@@ -333,6 +333,15 @@ int settings_save_one(const char *name, const void *value, size_t val_len);
  */
 int settings_delete(const char *name);
 
+/**
+ * Write the settings waiting in the write-back buffer to persisted storage.
+ * Settings are buffered only if CONFIG_SETTINGS_WRITE_BACK is enabled,
+ * otherwise this does nothing.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+int settings_flush(void);
+
 /**
  * Call commit for all settings handler. This should apply all
  * settings which has been set, but not applied yet.
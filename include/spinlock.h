@@ -49,6 +49,62 @@ struct k_spinlock;
  */
 typedef struct k_spinlock_key k_spinlock_key_t;
 
+#ifdef CONFIG_SMP
+#ifdef CONFIG_SPIN_TICKET
+/* With ticket locks, the low half of the lock word is the ticket being
+ * served and the high half the next ticket to hand out.  The word goes
+ * back to zero when the last waiter releases the lock, so it reads as
+ * zero when unlocked like the simple lock.
+ */
+#define Z_SPIN_TICKET_MASK 0xffffU
+#define Z_SPIN_TICKET_NEXT_SHIFT 16
+
+static ALWAYS_INLINE void z_spin_acquire(struct k_spinlock *l)
+{
+	uint32_t ticket;
+
+	ticket = (uint32_t)atomic_add(&l->locked,
+				      1 << Z_SPIN_TICKET_NEXT_SHIFT);
+	ticket = (ticket >> Z_SPIN_TICKET_NEXT_SHIFT) & Z_SPIN_TICKET_MASK;
+
+	/* Waiters only read the lock word until their turn comes */
+	while (((uint32_t)atomic_get(&l->locked) & Z_SPIN_TICKET_MASK) !=
+	       ticket) {
+	}
+}
+
+static ALWAYS_INLINE void z_spin_release(struct k_spinlock *l)
+{
+	uint32_t old, owner, next;
+
+	do {
+		old = (uint32_t)atomic_get(&l->locked);
+		owner = (old + 1U) & Z_SPIN_TICKET_MASK;
+		next = (old >> Z_SPIN_TICKET_NEXT_SHIFT) & Z_SPIN_TICKET_MASK;
+	} while (!atomic_cas(&l->locked, old, owner == next ?
+			     0 : (old & ~Z_SPIN_TICKET_MASK) | owner));
+}
+#else
+static ALWAYS_INLINE void z_spin_acquire(struct k_spinlock *l)
+{
+	while (!atomic_cas(&l->locked, 0, 1)) {
+	}
+}
+
+static ALWAYS_INLINE void z_spin_release(struct k_spinlock *l)
+{
+	/* Strictly we don't need atomic_clear() here (which is an
+	 * exchange operation that returns the old value).  We are always
+	 * setting a zero and (because we hold the lock) know the existing
+	 * state won't change due to a race.  But some architectures need
+	 * a memory barrier when used like this, and we don't have a
+	 * Zephyr framework for that.
+	 */
+	atomic_clear(&l->locked);
+}
+#endif /* CONFIG_SPIN_TICKET */
+#endif /* CONFIG_SMP */
+
 /**
  * @brief Lock a spinlock
  *
@@ -93,8 +149,7 @@ static ALWAYS_INLINE k_spinlock_key_t k_spin_lock(struct k_spinlock *l)
 #endif
 
 #ifdef CONFIG_SMP
-	while (!atomic_cas(&l->locked, 0, 1)) {
-	}
+	z_spin_acquire(l);
 #endif
 
 #ifdef CONFIG_SPIN_VALIDATE
@@ -133,14 +188,7 @@ static ALWAYS_INLINE void k_spin_unlock(struct k_spinlock *l,
 #endif
 
 #ifdef CONFIG_SMP
-	/* Strictly we don't need atomic_clear() here (which is an
-	 * exchange operation that returns the old value).  We are always
-	 * setting a zero and (because we hold the lock) know the existing
-	 * state won't change due to a race.  But some architectures need
-	 * a memory barrier when used like this, and we don't have a
-	 * Zephyr framework for that.
-	 */
-	atomic_clear(&l->locked);
+	z_spin_release(l);
 #endif
 	arch_irq_unlock(key.key);
 }
@@ -155,7 +203,7 @@ static ALWAYS_INLINE void k_spin_release(struct k_spinlock *l)
 	__ASSERT(z_spin_unlock_valid(l), "Not my spinlock %p", l);
 #endif
 #ifdef CONFIG_SMP
-	atomic_clear(&l->locked);
+	z_spin_release(l);
 #endif
 }
 
@@ -131,6 +131,57 @@ void z_sys_power_save_idle_exit(int32_t ticks)
 }
 
 
+#ifdef CONFIG_IDLE_WAKEUP_STATS
+static struct k_spinlock idle_stats_lock;
+static uint64_t idle_wakeups;
+
+/* Wakeups since the start of the current rate window, and rate of the
+ * last complete one
+ */
+static int64_t window_start;
+static uint32_t window_wakeups;
+static uint32_t wakeups_per_sec;
+
+static uint32_t window_rate(int64_t window)
+{
+	return (uint32_t)((uint64_t)window_wakeups *
+			  CONFIG_SYS_CLOCK_TICKS_PER_SEC / window);
+}
+
+static void idle_wakeup_count(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&idle_stats_lock);
+	int64_t window = z_tick_get() - window_start;
+
+	idle_wakeups++;
+	window_wakeups++;
+
+	if (window >= CONFIG_SYS_CLOCK_TICKS_PER_SEC) {
+		wakeups_per_sec = window_rate(window);
+		window_start += window;
+		window_wakeups = 0U;
+	}
+
+	k_spin_unlock(&idle_stats_lock, key);
+}
+
+void k_idle_stats_get(struct k_idle_stats *stats)
+{
+	k_spinlock_key_t key = k_spin_lock(&idle_stats_lock);
+	int64_t window = z_tick_get() - window_start;
+
+	stats->wakeups = idle_wakeups;
+
+	/* A window that already lasts more than a second is more recent
+	 * than the last complete one, e.g. after a long idle period.
+	 */
+	stats->wakeups_per_sec = (window >= CONFIG_SYS_CLOCK_TICKS_PER_SEC) ?
+		window_rate(window) : wakeups_per_sec;
+
+	k_spin_unlock(&idle_stats_lock, key);
+}
+#endif /* CONFIG_IDLE_WAKEUP_STATS */
+
 #if K_IDLE_PRIO < 0
 #define IDLE_YIELD_IF_COOP() k_yield()
 #else
@@ -158,6 +209,9 @@ void idle(void *unused1, void *unused2, void *unused3)
 #else
 		(void)arch_irq_lock();
 		sys_power_save_idle();
+#ifdef CONFIG_IDLE_WAKEUP_STATS
+		idle_wakeup_count();
+#endif
 		IDLE_YIELD_IF_COOP();
 #endif
 	}
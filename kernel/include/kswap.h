@@ -101,6 +101,9 @@ static ALWAYS_INLINE unsigned int do_swap(unsigned int key,
 #ifdef CONFIG_TIMESLICING
 		z_reset_time_slice();
 #endif
+#ifdef CONFIG_SCHED_CBS
+		z_sched_cbs_switch(new_thread);
+#endif
 
 		old_thread->swap_retval = -EAGAIN;
 
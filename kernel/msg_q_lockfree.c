@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * @file
+ * @brief Lock-free message queues.
+ *
+ * Bounded queue where each slot holds a sequence number followed by the
+ * message. The sequence number tells whether the slot is free for the
+ * producer at a given position or holds the message of that position for
+ * the consumer, so messages are put and got with atomic operations only.
+ * The sequence number is stored relative to the slot index, allowing a
+ * zeroed buffer to be used as an empty queue.
+ */
+
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <string.h>
+#include <ksched.h>
+#include <wait_q.h>
+#include <sys/atomic.h>
+
+static inline atomic_t *slot_get(struct k_msgq_lf *q, uint32_t pos)
+{
+	return (atomic_t *)(q->buffer +
+			    (pos & (q->max_msgs - 1U)) * q->slot_size);
+}
+
+static inline uint32_t slot_lap(struct k_msgq_lf *q, uint32_t pos)
+{
+	return pos & ~(q->max_msgs - 1U);
+}
+
+static bool try_put(struct k_msgq_lf *q, const void *data)
+{
+	uint32_t pos = (uint32_t)atomic_get(&q->head);
+	atomic_t *seq;
+	int32_t diff;
+
+	while (true) {
+		seq = slot_get(q, pos);
+		diff = (int32_t)((uint32_t)atomic_get(seq) - slot_lap(q, pos));
+
+		if (diff < 0) {
+			/* message of the previous lap not got yet */
+			return false;
+		}
+
+		if (diff == 0) {
+			if ((q->flags & K_MSGQ_LF_MPSC) == 0U) {
+				atomic_set(&q->head, pos + 1U);
+				break;
+			}
+
+			if (atomic_cas(&q->head, pos, pos + 1U)) {
+				break;
+			}
+		}
+
+		/* slot taken by another producer */
+		pos = (uint32_t)atomic_get(&q->head);
+	}
+
+	(void)memcpy((char *)seq + sizeof(atomic_t), data, q->msg_size);
+
+	/* hand the message to the consumer */
+	atomic_set(seq, slot_lap(q, pos) + 1U);
+
+	return true;
+}
+
+static bool try_get(struct k_msgq_lf *q, void *data)
+{
+	uint32_t pos = (uint32_t)atomic_get(&q->tail);
+	atomic_t *seq = slot_get(q, pos);
+
+	if ((uint32_t)atomic_get(seq) != slot_lap(q, pos) + 1U) {
+		/* empty, or the message is still being written */
+		return false;
+	}
+
+	(void)memcpy(data, (char *)seq + sizeof(atomic_t), q->msg_size);
+
+	/* give the slot back to the producers for the next lap */
+	atomic_set(seq, slot_lap(q, pos) + q->max_msgs);
+	atomic_set(&q->tail, pos + 1U);
+
+	return true;
+}
+
+static bool try_op(struct k_msgq_lf *q, void *data, bool put)
+{
+	return put ? try_put(q, data) : try_get(q, data);
+}
+
+static void wake_one(struct k_msgq_lf *q, _wait_q_t *wait_q)
+{
+	struct k_thread *thread;
+	k_spinlock_key_t key;
+
+	if (atomic_get(&q->waiters) == 0) {
+		return;
+	}
+
+	key = k_spin_lock(&q->lock);
+
+	thread = z_unpend_first_thread(wait_q);
+	if (thread != NULL) {
+		arch_thread_return_value_set(thread, 0);
+		z_ready_thread(thread);
+		z_reschedule(&q->lock, key);
+	} else {
+		k_spin_unlock(&q->lock, key);
+	}
+}
+
+static int wait_op(struct k_msgq_lf *q, void *data, bool put,
+		   k_timeout_t timeout)
+{
+	_wait_q_t *wait_q = put ? &q->put_wait_q : &q->get_wait_q;
+	bool forever = K_TIMEOUT_EQ(timeout, K_FOREVER);
+	int64_t now, end = 0;
+	k_spinlock_key_t key;
+	bool done;
+
+	__ASSERT(!arch_is_in_isr() || K_TIMEOUT_EQ(timeout, K_NO_WAIT), "");
+
+	if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+		return -ENOMSG;
+	}
+
+	if (!forever) {
+		end = z_timeout_end_calc(timeout);
+	}
+
+	while (true) {
+		if (!forever) {
+			now = z_tick_get();
+			if ((end - now) <= 0) {
+				return -EAGAIN;
+			}
+
+			timeout = K_TICKS(end - now);
+		}
+
+		key = k_spin_lock(&q->lock);
+
+		/* Count the waiter before checking the queue again, so that
+		 * the thread releasing a message or a slot after the check
+		 * sees it and wakes it up.
+		 */
+		atomic_inc(&q->waiters);
+
+		done = try_op(q, data, put);
+		if (done) {
+			k_spin_unlock(&q->lock, key);
+		} else {
+			(void)z_pend_curr(&q->lock, key, wait_q, timeout);
+			done = try_op(q, data, put);
+		}
+
+		atomic_dec(&q->waiters);
+
+		if (done) {
+			return 0;
+		}
+	}
+}
+
+void k_msgq_lf_init(struct k_msgq_lf *q, char *buffer, size_t msg_size,
+		    uint32_t max_msgs, uint8_t flags)
+{
+	__ASSERT(max_msgs >= 2U && (max_msgs & (max_msgs - 1U)) == 0U,
+		 "max_msgs must be a power of two");
+	__ASSERT(((uintptr_t)buffer & (sizeof(atomic_t) - 1)) == 0U,
+		 "buffer not aligned");
+
+	z_waitq_init(&q->get_wait_q);
+	z_waitq_init(&q->put_wait_q);
+	q->buffer = buffer;
+	q->msg_size = msg_size;
+	q->slot_size = Z_MSGQ_LF_SLOT_SIZE(msg_size);
+	q->max_msgs = max_msgs;
+	q->flags = flags;
+	atomic_clear(&q->head);
+	atomic_clear(&q->tail);
+	atomic_clear(&q->waiters);
+
+	(void)memset(buffer, 0, K_MSGQ_LF_BUF_SIZE(msg_size, max_msgs));
+}
+
+int k_msgq_lf_put(struct k_msgq_lf *q, const void *data, k_timeout_t timeout)
+{
+	int ret = 0;
+
+	if (!try_put(q, data)) {
+		ret = wait_op(q, (void *)data, true, timeout);
+	}
+
+	if (ret == 0) {
+		wake_one(q, &q->get_wait_q);
+	}
+
+	return ret;
+}
+
+int k_msgq_lf_get(struct k_msgq_lf *q, void *data, k_timeout_t timeout)
+{
+	int ret = 0;
+
+	if (!try_get(q, data)) {
+		ret = wait_op(q, data, false, timeout);
+	}
+
+	if (ret == 0) {
+		wake_one(q, &q->put_wait_q);
+	}
+
+	return ret;
+}
@@ -24,6 +24,10 @@
  * When releasing the mutex, thread A must release M2 before it releases M1.
  * Failure to follow this nested model may result in threads running at
  * unexpected priority levels (too high, or too low).
+ *
+ * Inheritance is transitive: when the owning thread is itself waiting for
+ * another mutex, the owner of that mutex is boosted as well, and so on up
+ * to CONFIG_MUTEX_PI_CHAIN_DEPTH owners.
  */
 
 #include <kernel.h>
@@ -116,9 +120,99 @@ static bool adjust_owner_prio(struct k_mutex *mutex, int32_t new_prio)
 	return false;
 }
 
+/*
+ * Boost the owner of @a mutex to @a prio, and the owners of the mutexes it
+ * waits for in turn.
+ */
+static bool boost_owner_chain(struct k_mutex *mutex, int32_t prio)
+{
+	bool resched = false;
+	int32_t new_prio;
+	int depth;
+
+	for (depth = 0; depth < CONFIG_MUTEX_PI_CHAIN_DEPTH; depth++) {
+		if ((mutex == NULL) || (mutex->owner == NULL)) {
+			break;
+		}
+
+		new_prio = new_prio_for_inheritance(prio,
+						    mutex->owner->base.prio);
+		if (!z_is_prio_higher(new_prio, mutex->owner->base.prio)) {
+			break;
+		}
+
+		resched = adjust_owner_prio(mutex, new_prio) || resched;
+
+		prio = new_prio;
+		mutex = mutex->owner->base.pended_mutex;
+	}
+
+	return resched;
+}
+
+/*
+ * Give the owner of @a mutex back the priority it had when it took it, or
+ * the one of the first waiter if higher, and update the owners of the
+ * mutexes it waits for in turn.
+ */
+static bool restore_owner_chain(struct k_mutex *mutex)
+{
+	struct k_thread *waiter;
+	bool resched = false;
+	int32_t new_prio;
+	int depth;
+
+	for (depth = 0; depth < CONFIG_MUTEX_PI_CHAIN_DEPTH; depth++) {
+		if ((mutex == NULL) || (mutex->owner == NULL)) {
+			break;
+		}
+
+		waiter = z_waitq_head(&mutex->wait_q);
+
+		new_prio = (waiter != NULL) ?
+			new_prio_for_inheritance(waiter->base.prio,
+						 mutex->owner_orig_prio) :
+			mutex->owner_orig_prio;
+		if (new_prio == mutex->owner->base.prio) {
+			break;
+		}
+
+		resched = adjust_owner_prio(mutex, new_prio) || resched;
+
+		mutex = mutex->owner->base.pended_mutex;
+	}
+
+	return resched;
+}
+
+#ifdef CONFIG_MUTEX_ADAPTIVE_SPIN
+static bool owner_running(struct k_thread *owner)
+{
+	return (owner != NULL) && (owner != _current) &&
+		(_kernel.cpus[owner->base.cpu].current == owner);
+}
+
+/*
+ * Wait for the owner of @a mutex to release it while it is running on
+ * another CPU. This is only a hint read without the lock, the caller
+ * checks the mutex state again.
+ */
+static void owner_spin(struct k_mutex *mutex)
+{
+	struct k_thread *owner;
+	int i;
+
+	for (i = 0; i < CONFIG_MUTEX_ADAPTIVE_SPIN_LIMIT; i++) {
+		owner = *(struct k_thread * volatile *)&mutex->owner;
+		if (!owner_running(owner)) {
+			break;
+		}
+	}
+}
+#endif /* CONFIG_MUTEX_ADAPTIVE_SPIN */
+
 int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 {
-	int new_prio;
 	k_spinlock_key_t key;
 	bool resched = false;
 
@@ -127,6 +221,15 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 	sys_trace_void(SYS_TRACE_ID_MUTEX_LOCK);
 	key = k_spin_lock(&lock);
 
+#ifdef CONFIG_MUTEX_ADAPTIVE_SPIN
+	if ((mutex->lock_count != 0U) && !K_TIMEOUT_EQ(timeout, K_NO_WAIT) &&
+	    owner_running(mutex->owner)) {
+		k_spin_unlock(&lock, key);
+		owner_spin(mutex);
+		key = k_spin_lock(&lock);
+	}
+#endif
+
 	if (likely((mutex->lock_count == 0U) || (mutex->owner == _current))) {
 
 		mutex->owner_orig_prio = (mutex->lock_count == 0U) ?
@@ -152,14 +255,11 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 		return -EBUSY;
 	}
 
-	new_prio = new_prio_for_inheritance(_current->base.prio,
-					    mutex->owner->base.prio);
-
 	K_DEBUG("adjusting prio up on mutex %p\n", mutex);
 
-	if (z_is_prio_higher(new_prio, mutex->owner->base.prio)) {
-		resched = adjust_owner_prio(mutex, new_prio);
-	}
+	resched = boost_owner_chain(mutex, _current->base.prio);
+
+	_current->base.pended_mutex = mutex;
 
 	int got_mutex = z_pend_curr(&lock, key, &mutex->wait_q, timeout);
 
@@ -179,15 +279,11 @@ int z_impl_k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
 
 	key = k_spin_lock(&lock);
 
-	struct k_thread *waiter = z_waitq_head(&mutex->wait_q);
-
-	new_prio = (waiter != NULL) ?
-		new_prio_for_inheritance(waiter->base.prio, mutex->owner_orig_prio) :
-		mutex->owner_orig_prio;
+	_current->base.pended_mutex = NULL;
 
 	K_DEBUG("adjusting prio down on mutex %p\n", mutex);
 
-	resched = adjust_owner_prio(mutex, new_prio) || resched;
+	resched = restore_owner_chain(mutex) || resched;
 
 	if (resched) {
 		z_reschedule(&lock, key);
@@ -266,6 +362,7 @@ int z_impl_k_mutex_unlock(struct k_mutex *mutex)
 		 * ajust its priority
 		 */
 		mutex->owner_orig_prio = new_owner->base.prio;
+		new_owner->base.pended_mutex = NULL;
 		arch_thread_return_value_set(new_owner, 0);
 		z_ready_thread(new_owner);
 		z_reschedule(&lock, key);
@@ -135,6 +135,8 @@ void k_pipe_init(struct k_pipe *pipe, unsigned char *buffer, size_t size)
 	pipe->bytes_used = 0;
 	pipe->read_index = 0;
 	pipe->write_index = 0;
+	pipe->put_claimed = 0;
+	pipe->get_claimed = 0;
 	pipe->lock = (struct k_spinlock){};
 	z_waitq_init(&pipe->wait_q.writers);
 	z_waitq_init(&pipe->wait_q.readers);
@@ -806,6 +808,180 @@ void k_pipe_block_put(struct k_pipe *pipe, struct k_mem_block *block,
 }
 #endif
 
+size_t k_pipe_put_claim(struct k_pipe *pipe, uint8_t **data, size_t size)
+{
+	k_spinlock_key_t key;
+	size_t start, space;
+
+	if (pipe->buffer == NULL || pipe->size == 0) {
+		return 0;
+	}
+
+	key = k_spin_lock(&pipe->lock);
+
+	/* the claimed space follows the previous claims */
+	start = (pipe->write_index + pipe->put_claimed) % pipe->size;
+	space = pipe->size - pipe->bytes_used - pipe->put_claimed;
+	size = MIN(size, MIN(space, pipe->size - start));
+
+	*data = pipe->buffer + start;
+	pipe->put_claimed += size;
+
+	k_spin_unlock(&pipe->lock, key);
+
+	return size;
+}
+
+int k_pipe_put_finish(struct k_pipe *pipe, size_t size)
+{
+	struct k_thread    *reader;
+	struct k_pipe_desc *desc;
+	sys_dlist_t    xfer_list;
+	size_t         bytes_copied;
+
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	if (size > pipe->put_claimed) {
+		k_spin_unlock(&pipe->lock, key);
+		return -EINVAL;
+	}
+
+	pipe->put_claimed = 0;
+	if (size == 0) {
+		k_spin_unlock(&pipe->lock, key);
+		return 0;
+	}
+
+	pipe->bytes_used += size;
+	pipe->write_index = (pipe->write_index + size) % pipe->size;
+
+	/*
+	 * Readers only wait on an empty buffer, give them the new data
+	 * like k_pipe_put() would have.
+	 */
+	(void)pipe_xfer_prepare(&xfer_list, &reader, &pipe->wait_q.readers,
+				0, size, 0, K_FOREVER);
+
+	z_sched_lock();
+	k_spin_unlock(&pipe->lock, key);
+
+	struct k_thread *thread = (struct k_thread *)
+				  sys_dlist_get(&xfer_list);
+	while (thread != NULL) {
+		desc = (struct k_pipe_desc *)thread->base.swap_data;
+		bytes_copied = pipe_buffer_get(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+
+		desc->buffer        += bytes_copied;
+		desc->bytes_to_xfer -= bytes_copied;
+
+		/* The thread's read request has been satisfied. Ready it. */
+		z_ready_thread(thread);
+
+		thread = (struct k_thread *)sys_dlist_get(&xfer_list);
+	}
+
+	if (reader != NULL) {
+		desc = (struct k_pipe_desc *)reader->base.swap_data;
+		bytes_copied = pipe_buffer_get(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+
+		desc->buffer        += bytes_copied;
+		desc->bytes_to_xfer -= bytes_copied;
+	}
+
+	k_sched_unlock();
+
+	return 0;
+}
+
+size_t k_pipe_get_claim(struct k_pipe *pipe, uint8_t **data, size_t size)
+{
+	k_spinlock_key_t key;
+	size_t start, avail;
+
+	if (pipe->buffer == NULL || pipe->size == 0) {
+		return 0;
+	}
+
+	key = k_spin_lock(&pipe->lock);
+
+	/* the claimed data follows the previous claims */
+	start = (pipe->read_index + pipe->get_claimed) % pipe->size;
+	avail = pipe->bytes_used - pipe->get_claimed;
+	size = MIN(size, MIN(avail, pipe->size - start));
+
+	*data = pipe->buffer + start;
+	pipe->get_claimed += size;
+
+	k_spin_unlock(&pipe->lock, key);
+
+	return size;
+}
+
+int k_pipe_get_finish(struct k_pipe *pipe, size_t size)
+{
+	struct k_thread    *writer;
+	struct k_pipe_desc *desc;
+	sys_dlist_t    xfer_list;
+	size_t         bytes_copied;
+
+	k_spinlock_key_t key = k_spin_lock(&pipe->lock);
+
+	if (size > pipe->get_claimed) {
+		k_spin_unlock(&pipe->lock, key);
+		return -EINVAL;
+	}
+
+	pipe->get_claimed = 0;
+	if (size == 0) {
+		k_spin_unlock(&pipe->lock, key);
+		return 0;
+	}
+
+	pipe->bytes_used -= size;
+	pipe->read_index = (pipe->read_index + size) % pipe->size;
+
+	/*
+	 * Writers only wait on a full buffer, let them fill the freed space
+	 * like k_pipe_get() would have.
+	 */
+	(void)pipe_xfer_prepare(&xfer_list, &writer, &pipe->wait_q.writers,
+				0, size, 0, K_FOREVER);
+
+	z_sched_lock();
+	k_spin_unlock(&pipe->lock, key);
+
+	struct k_thread *thread = (struct k_thread *)
+				  sys_dlist_get(&xfer_list);
+	while (thread != NULL) {
+		desc = (struct k_pipe_desc *)thread->base.swap_data;
+		bytes_copied = pipe_buffer_put(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+
+		desc->buffer         += bytes_copied;
+		desc->bytes_to_xfer  -= bytes_copied;
+
+		/* Write request has been satisfied */
+		pipe_thread_ready(thread);
+
+		thread = (struct k_thread *)sys_dlist_get(&xfer_list);
+	}
+
+	if (writer != NULL) {
+		desc = (struct k_pipe_desc *)writer->base.swap_data;
+		bytes_copied = pipe_buffer_put(pipe, desc->buffer,
+						desc->bytes_to_xfer);
+
+		desc->buffer         += bytes_copied;
+		desc->bytes_to_xfer  -= bytes_copied;
+	}
+
+	k_sched_unlock();
+
+	return 0;
+}
+
 size_t z_impl_k_pipe_read_avail(struct k_pipe *pipe)
 {
 	size_t res;
@@ -176,9 +176,114 @@ static ALWAYS_INLINE struct k_thread *_priq_dumb_mask_best(sys_dlist_t *pq)
 }
 #endif
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+/* Index of the CPU whose queue gets the thread: the one it last ran on,
+ * so that it finds its cache state again, or the first one it may run on.
+ */
+static int runq_cpu_select(struct k_thread *thread)
+{
+	int cpu = thread->base.cpu;
+
+#ifdef CONFIG_SCHED_CPU_MASK
+	if ((thread->base.cpu_mask & BIT(cpu)) == 0) {
+		cpu = find_lsb_set(thread->base.cpu_mask) - 1;
+	}
+#endif
+
+	return (cpu >= 0 && cpu < CONFIG_MP_NUM_CPUS) ? cpu : 0;
+}
+
+static ALWAYS_INLINE void runq_add(struct k_thread *thread)
+{
+	thread->base.runq_cpu = runq_cpu_select(thread);
+	_priq_run_add(&_kernel.cpus[thread->base.runq_cpu].ready_q.runq,
+		      thread);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
+{
+	_priq_run_remove(&_kernel.cpus[thread->base.runq_cpu].ready_q.runq,
+			 thread);
+}
+
+/* Best thread of the local queue, unless another CPU queues a thread
+ * that may run here and has a higher priority.  An idle CPU thus steals
+ * the best thread it can find.
+ */
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+	struct k_thread *thread, *other;
+
+	thread = _priq_run_best(&_current_cpu->ready_q.runq);
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (i == _current_cpu->id) {
+			continue;
+		}
+
+		other = _priq_run_best(&_kernel.cpus[i].ready_q.runq);
+		if (other != NULL && (thread == NULL ||
+		    z_is_t1_higher_prio_than_t2(other, thread))) {
+			thread = other;
+		}
+	}
+
+	return thread;
+}
+
+#ifdef CONFIG_SCHED_IPI_SUPPORTED
+/* An IPI is only needed if another CPU allowed to run the thread is idle
+ * or would be preempted by it.
+ */
+static bool runq_need_ipi(struct k_thread *thread)
+{
+	struct k_thread *curr;
+
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (i == _current_cpu->id) {
+			continue;
+		}
+
+#ifdef CONFIG_SCHED_CPU_MASK
+		if ((thread->base.cpu_mask & BIT(i)) == 0) {
+			continue;
+		}
+#endif
+
+		curr = _kernel.cpus[i].sched_next;
+		if (curr == NULL || z_is_idle_thread_object(curr)) {
+			return true;
+		}
+
+		if ((is_preempt(curr) || is_metairq(thread)) &&
+		    z_is_t1_higher_prio_than_t2(thread, curr)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+#endif
+#else
+static ALWAYS_INLINE void runq_add(struct k_thread *thread)
+{
+	_priq_run_add(&_kernel.ready_q.runq, thread);
+}
+
+static ALWAYS_INLINE void runq_remove(struct k_thread *thread)
+{
+	_priq_run_remove(&_kernel.ready_q.runq, thread);
+}
+
+static ALWAYS_INLINE struct k_thread *runq_best(void)
+{
+	return _priq_run_best(&_kernel.ready_q.runq);
+}
+#endif
+
 static ALWAYS_INLINE struct k_thread *next_up(void)
 {
-	struct k_thread *thread = _priq_run_best(&_kernel.ready_q.runq);
+	struct k_thread *thread = runq_best();
 
 #if (CONFIG_NUM_METAIRQ_PRIORITIES > 0) && (CONFIG_NUM_COOP_PRIORITIES > 0)
 	/* MetaIRQs must always attempt to return back to a
@@ -248,16 +353,24 @@ static ALWAYS_INLINE struct k_thread *next_up(void)
 	/* Put _current back into the queue */
 	if (thread != _current && active &&
 		!z_is_idle_thread_object(_current) && !queued) {
-		_priq_run_add(&_kernel.ready_q.runq, _current);
+		runq_add(_current);
 		z_mark_thread_as_queued(_current);
 	}
 
 	/* Take the new _current out of the queue */
 	if (z_is_thread_queued(thread)) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
+		runq_remove(thread);
 	}
 	z_mark_thread_as_not_queued(thread);
 
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	/* Both callers switch to the thread, record it for the IPI
+	 * decisions of the other CPUs.
+	 */
+	thread->base.cpu = _current_cpu->id;
+	_current_cpu->sched_next = thread;
+#endif
+
 	return thread;
 #endif
 }
@@ -358,6 +471,15 @@ static void update_cache(int preempt_ok)
 		if (thread != _current) {
 			z_reset_time_slice();
 		}
+#endif
+#if defined(CONFIG_SCHED_CBS) && !defined(CONFIG_USE_SWITCH)
+		/* arch_swap() and the interrupt exit switch to the cached
+		 * thread without a scheduler hook, so the budget is charged
+		 * here.  With USE_SWITCH it is charged at the switch.
+		 */
+		if (thread != _current) {
+			z_sched_cbs_switch(thread);
+		}
 #endif
 		update_metairq_preempt(thread);
 		_kernel.ready_q.cache = thread;
@@ -380,11 +502,17 @@ static void ready_thread(struct k_thread *thread)
 {
 	if (z_is_thread_ready(thread)) {
 		sys_trace_thread_ready(thread);
-		_priq_run_add(&_kernel.ready_q.runq, thread);
+		runq_add(thread);
 		z_mark_thread_as_queued(thread);
 		update_cache(0);
 #if defined(CONFIG_SMP) &&  defined(CONFIG_SCHED_IPI_SUPPORTED)
+#ifdef CONFIG_SCHED_CPU_RUNQ
+		if (runq_need_ipi(thread)) {
+			arch_sched_ipi();
+		}
+#else
 		arch_sched_ipi();
+#endif
 #endif
 	}
 }
@@ -400,9 +528,9 @@ void z_move_thread_to_end_of_prio_q(struct k_thread *thread)
 {
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 		}
-		_priq_run_add(&_kernel.ready_q.runq, thread);
+		runq_add(thread);
 		z_mark_thread_as_queued(thread);
 		update_cache(thread == _current);
 	}
@@ -428,7 +556,7 @@ void z_impl_k_thread_suspend(struct k_thread *thread)
 
 	LOCKED(&sched_spinlock) {
 		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 			z_mark_thread_as_not_queued(thread);
 		}
 		z_mark_thread_as_suspended(thread);
@@ -468,6 +596,10 @@ static inline void z_vrfy_k_thread_resume(struct k_thread *thread)
 #include <syscalls/k_thread_resume_mrsh.c>
 #endif
 
+#ifdef CONFIG_SCHED_CBS
+static void cbs_release(struct k_thread *thread);
+#endif
+
 static _wait_q_t *pended_on(struct k_thread *thread)
 {
 	__ASSERT_NO_MSG(thread->base.pended_on);
@@ -492,8 +624,7 @@ void z_thread_single_abort(struct k_thread *thread)
 
 		if (z_is_thread_ready(thread)) {
 			if (z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq,
-						 thread);
+				runq_remove(thread);
 				z_mark_thread_as_not_queued(thread);
 			}
 			update_cache(thread == _current);
@@ -503,9 +634,14 @@ void z_thread_single_abort(struct k_thread *thread)
 						  thread);
 				z_mark_thread_as_not_pending(thread);
 				thread->base.pended_on = NULL;
+				thread->base.pended_mutex = NULL;
 			}
 		}
 
+#ifdef CONFIG_SCHED_CBS
+		cbs_release(thread);
+#endif
+
 		uint32_t mask = _THREAD_DEAD;
 
 		/* If the abort is happening in interrupt context,
@@ -557,7 +693,7 @@ void z_thread_single_abort(struct k_thread *thread)
 static void unready_thread(struct k_thread *thread)
 {
 	if (z_is_thread_queued(thread)) {
-		_priq_run_remove(&_kernel.ready_q.runq, thread);
+		runq_remove(thread);
 		z_mark_thread_as_not_queued(thread);
 	}
 	update_cache(thread == _current);
@@ -708,13 +844,19 @@ bool z_set_prio(struct k_thread *thread, int prio)
 		if (need_sched) {
 			/* Don't requeue on SMP if it's the running thread */
 			if (!IS_ENABLED(CONFIG_SMP) || z_is_thread_queued(thread)) {
-				_priq_run_remove(&_kernel.ready_q.runq, thread);
+				runq_remove(thread);
 				thread->base.prio = prio;
-				_priq_run_add(&_kernel.ready_q.runq, thread);
+				runq_add(thread);
 			} else {
 				thread->base.prio = prio;
 			}
 			update_cache(1);
+		} else if (z_is_thread_pending(thread) &&
+			   thread->base.pended_on != NULL) {
+			/* keep the wait queue sorted by priority */
+			_priq_wait_remove(&pended_on(thread)->waitq, thread);
+			thread->base.prio = prio;
+			z_priq_wait_add(&pended_on(thread)->waitq, thread);
 		} else {
 			thread->base.prio = prio;
 		}
@@ -824,6 +966,9 @@ void *z_get_next_switch_handle(void *interrupted)
 
 #ifdef CONFIG_TIMESLICING
 			z_reset_time_slice();
+#endif
+#ifdef CONFIG_SCHED_CBS
+			z_sched_cbs_switch(thread);
 #endif
 			_current_cpu->swap_ok = 0;
 			set_current(thread);
@@ -838,7 +983,14 @@ void *z_get_next_switch_handle(void *interrupted)
 		}
 	}
 #else
-	set_current(z_get_next_ready_thread());
+	struct k_thread *thread = z_get_next_ready_thread();
+
+#ifdef CONFIG_SCHED_CBS
+	if (_current != thread) {
+		z_sched_cbs_switch(thread);
+	}
+#endif
+	set_current(thread);
 #endif
 
 	wait_for_switch(_current);
@@ -1016,14 +1168,14 @@ int z_unpend_all(_wait_q_t *wait_q)
 	return need_sched;
 }
 
-void z_sched_init(void)
+static void init_ready_q(struct _ready_q *rq)
 {
 #ifdef CONFIG_SCHED_DUMB
-	sys_dlist_init(&_kernel.ready_q.runq);
+	sys_dlist_init(&rq->runq);
 #endif
 
 #ifdef CONFIG_SCHED_SCALABLE
-	_kernel.ready_q.runq = (struct _priq_rb) {
+	rq->runq = (struct _priq_rb) {
 		.tree = {
 			.lessthan_fn = z_priq_rb_lessthan,
 		}
@@ -1031,9 +1183,20 @@ void z_sched_init(void)
 #endif
 
 #ifdef CONFIG_SCHED_MULTIQ
-	for (int i = 0; i < ARRAY_SIZE(_kernel.ready_q.runq.queues); i++) {
-		sys_dlist_init(&_kernel.ready_q.runq.queues[i]);
+	for (int i = 0; i < ARRAY_SIZE(rq->runq.queues); i++) {
+		sys_dlist_init(&rq->runq.queues[i]);
+	}
+#endif
+}
+
+void z_sched_init(void)
+{
+#ifdef CONFIG_SCHED_CPU_RUNQ
+	for (int i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		init_ready_q(&_kernel.cpus[i].ready_q);
 	}
+#else
+	init_ready_q(&_kernel.ready_q);
 #endif
 
 #ifdef CONFIG_TIMESLICING
@@ -1093,8 +1256,8 @@ void z_impl_k_thread_deadline_set(k_tid_t tid, int deadline)
 	LOCKED(&sched_spinlock) {
 		thread->base.prio_deadline = k_cycle_get_32() + deadline;
 		if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
-			_priq_run_add(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
+			runq_add(thread);
 		}
 	}
 }
@@ -1115,6 +1278,287 @@ static inline void z_vrfy_k_thread_deadline_set(k_tid_t tid, int deadline)
 #endif
 #endif
 
+#ifdef CONFIG_SCHED_CBS
+/* Bandwidth admission limit, in millionths of a CPU */
+#define CBS_UTIL_MAX (CONFIG_SCHED_CBS_MAX_UTILIZATION * 10000U)
+
+/* Protects the per-CPU budget accounting, which is updated on context
+ * switches, possibly with sched_spinlock held.
+ */
+static struct k_spinlock cbs_lock;
+
+/* Bandwidth reserved by all the deadline threads, in millionths */
+static uint32_t cbs_total_util;
+
+/* Per-CPU timeouts ending the budget of the running deadline thread */
+static struct _timeout cbs_timeouts[CONFIG_MP_NUM_CPUS];
+
+static void cbs_budget_expired(struct _timeout *t);
+
+/* Charge the running deadline thread of @a cpu for the time since the
+ * last charge.  Called with cbs_lock held.
+ */
+static void cbs_charge(struct _cpu *cpu)
+{
+	struct k_thread *thread = cpu->cbs_thread;
+	uint32_t now = k_cycle_get_32();
+
+	if (thread != NULL) {
+		thread->base.cbs.budget_left -= (int32_t)(now - cpu->cbs_start);
+	}
+
+	cpu->cbs_start = now;
+}
+
+/* Arm the budget timeout of @a cpu for its running deadline thread.
+ * Called with cbs_lock held.
+ */
+static void cbs_arm(struct _cpu *cpu)
+{
+	struct _timeout *t = &cbs_timeouts[cpu->id];
+	struct k_thread *thread = cpu->cbs_thread;
+	int32_t left;
+
+	(void)z_abort_timeout(t);
+
+	if (thread != NULL) {
+		left = MAX(thread->base.cbs.budget_left, 0);
+		z_add_timeout(t, cbs_budget_expired,
+			      K_TICKS(k_cyc_to_ticks_ceil32(left)));
+	}
+}
+
+void z_sched_cbs_switch(struct k_thread *thread)
+{
+	struct _cpu *cpu = _current_cpu;
+	struct k_thread *next = (thread->base.cbs.period != 0U) ?
+		thread : NULL;
+	k_spinlock_key_t key;
+
+	if ((cpu->cbs_thread == NULL) && (next == NULL)) {
+		return;
+	}
+
+	key = k_spin_lock(&cbs_lock);
+	cbs_charge(cpu);
+	cpu->cbs_thread = next;
+	cbs_arm(cpu);
+	k_spin_unlock(&cbs_lock, key);
+}
+
+/* Set the scheduler deadline of @a thread to its server deadline.  Called
+ * with sched_spinlock held.
+ */
+static void cbs_deadline_set(struct k_thread *thread)
+{
+	int64_t left = MAX(thread->base.cbs.deadline - z_tick_get(), 0);
+	uint64_t cyc = k_ticks_to_cyc_floor64(left);
+	bool queued = z_is_thread_queued(thread);
+
+	if (queued) {
+		runq_remove(thread);
+	}
+
+	/* Deadlines are compared as signed cycle deltas from now, a farther
+	 * one is clamped so that it does not wrap around to the past.
+	 */
+	thread->base.prio_deadline = k_cycle_get_32() +
+		(uint32_t)MIN(cyc, (uint64_t)INT32_MAX);
+
+	if (queued) {
+		runq_add(thread);
+	}
+}
+
+/* Release the bandwidth of @a thread.  Called with sched_spinlock held. */
+static void cbs_release(struct k_thread *thread)
+{
+	cbs_total_util -= thread->base.cbs.util;
+	thread->base.cbs.util = 0U;
+	thread->base.cbs.period = 0U;
+}
+
+static void cbs_budget_expired(struct _timeout *t)
+{
+	struct _cpu *cpu = &_kernel.cpus[t - cbs_timeouts];
+	k_thread_overrun_t overrun = NULL;
+	struct k_thread *thread = NULL;
+	struct _thread_cbs *cbs;
+	k_spinlock_key_t key;
+	bool overran = false;
+
+	LOCKED(&sched_spinlock) {
+		key = k_spin_lock(&cbs_lock);
+
+		cbs_charge(cpu);
+		thread = cpu->cbs_thread;
+
+		if ((thread != NULL) && (thread->base.cbs.period == 0U)) {
+			/* bandwidth released while running */
+			cpu->cbs_thread = NULL;
+		} else if ((thread != NULL) &&
+			   (thread->base.cbs.budget_left <= 0)) {
+			/* Replenish the budget and postpone the deadline,
+			 * the thread now competes with the deadline of its
+			 * next period.
+			 */
+			cbs = &thread->base.cbs;
+			cbs->overruns++;
+			cbs->budget_left += cbs->budget;
+			cbs->deadline += cbs->period;
+			overrun = cbs->overrun;
+			overran = true;
+		}
+
+		cbs_arm(cpu);
+		k_spin_unlock(&cbs_lock, key);
+
+		if (overran) {
+			cbs_deadline_set(thread);
+			update_cache(thread == _current);
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_IPI_SUPPORTED)
+			if (cpu != _current_cpu) {
+				arch_sched_ipi();
+			}
+#endif
+		}
+	}
+
+	if (overrun != NULL) {
+		overrun(thread);
+	}
+}
+
+int k_thread_cbs_set(k_tid_t thread, uint32_t budget_us, uint32_t period_us,
+		     k_thread_overrun_t overrun)
+{
+	struct _thread_cbs *cbs = &thread->base.cbs;
+	uint32_t util = 0U;
+	k_spinlock_key_t key;
+
+	if (budget_us != 0U) {
+		if ((period_us == 0U) || (budget_us > period_us)) {
+			return -EINVAL;
+		}
+
+		util = (uint32_t)ceiling_fraction(budget_us * 1000000ULL,
+						  period_us);
+	}
+
+	key = k_spin_lock(&sched_spinlock);
+
+	if ((cbs_total_util - cbs->util + util) > CBS_UTIL_MAX) {
+		k_spin_unlock(&sched_spinlock, key);
+		return -EBUSY;
+	}
+
+	cbs_release(thread);
+
+	if (util != 0U) {
+		cbs_total_util += util;
+		cbs->util = util;
+		cbs->overrun = overrun;
+		cbs->budget = k_us_to_cyc_ceil32(budget_us);
+		cbs->period = k_us_to_ticks_ceil32(period_us);
+		cbs->budget_left = cbs->budget;
+		cbs->release = z_tick_get();
+		cbs->deadline = cbs->release + cbs->period;
+		cbs->jobs = 0U;
+		cbs->overruns = 0U;
+		cbs->misses = 0U;
+
+		cbs_deadline_set(thread);
+	}
+
+	if (thread == _current) {
+		z_sched_cbs_switch(thread);
+	}
+
+	update_cache(0);
+	z_reschedule(&sched_spinlock, key);
+
+	return 0;
+}
+
+int z_impl_k_thread_period_wait(void)
+{
+	struct _thread_cbs *cbs = &_current->base.cbs;
+	int64_t now, release;
+	k_spinlock_key_t key;
+
+	__ASSERT(!arch_is_in_isr(), "");
+
+	key = k_spin_lock(&sched_spinlock);
+
+	if (cbs->period == 0U) {
+		k_spin_unlock(&sched_spinlock, key);
+		return -EINVAL;
+	}
+
+	now = z_tick_get();
+	release = cbs->release + cbs->period;
+	cbs->jobs++;
+
+	if (release < now) {
+		/* the job ended after its period, start the next one now */
+		cbs->misses++;
+		release = now;
+	}
+
+	cbs->release = release;
+	k_spin_unlock(&sched_spinlock, key);
+
+	if (release > now) {
+		(void)k_sleep(K_TIMEOUT_ABS_TICKS(release));
+	}
+
+	key = k_spin_lock(&sched_spinlock);
+
+	if (cbs->period != 0U) {
+		cbs->budget_left = cbs->budget;
+		cbs->deadline = cbs->release + cbs->period;
+		cbs_deadline_set(_current);
+		z_sched_cbs_switch(_current);
+	}
+
+	update_cache(1);
+	z_reschedule(&sched_spinlock, key);
+
+	return 0;
+}
+
+#ifdef CONFIG_USERSPACE
+static inline int z_vrfy_k_thread_period_wait(void)
+{
+	return z_impl_k_thread_period_wait();
+}
+#include <syscalls/k_thread_period_wait_mrsh.c>
+#endif
+
+int k_thread_cbs_stats_get(k_tid_t thread, struct k_thread_cbs_stats *stats)
+{
+	struct _thread_cbs *cbs = &thread->base.cbs;
+	int ret = 0;
+
+	LOCKED(&sched_spinlock) {
+		if (cbs->period == 0U) {
+			ret = -EINVAL;
+		} else {
+			stats->jobs = cbs->jobs;
+			stats->overruns = cbs->overruns;
+			stats->misses = cbs->misses;
+		}
+	}
+
+	return ret;
+}
+
+uint32_t k_sched_cbs_utilization_get(void)
+{
+	return cbs_total_util;
+}
+#endif /* CONFIG_SCHED_CBS */
+
 void z_impl_k_yield(void)
 {
 	__ASSERT(!arch_is_in_isr(), "");
@@ -1123,10 +1567,9 @@ void z_impl_k_yield(void)
 		LOCKED(&sched_spinlock) {
 			if (!IS_ENABLED(CONFIG_SMP) ||
 			    z_is_thread_queued(_current)) {
-				_priq_run_remove(&_kernel.ready_q.runq,
-						 _current);
+				runq_remove(_current);
 			}
-			_priq_run_add(&_kernel.ready_q.runq, _current);
+			runq_add(_current);
 			z_mark_thread_as_queued(_current);
 			update_cache(1);
 		}
@@ -1257,7 +1700,8 @@ void z_impl_k_wakeup(k_tid_t thread)
 	z_mark_thread_as_not_suspended(thread);
 	z_ready_thread(thread);
 
-#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_IPI_SUPPORTED)
+#if defined(CONFIG_SMP) && defined(CONFIG_SCHED_IPI_SUPPORTED) && \
+	!defined(CONFIG_SCHED_CPU_RUNQ)
 	arch_sched_ipi();
 #endif
 
@@ -1304,7 +1748,7 @@ void z_sched_abort(struct k_thread *thread)
 			thread->base.thread_state |= _THREAD_DEAD;
 			k_spin_unlock(&sched_spinlock, key);
 		} else if (z_is_thread_queued(thread)) {
-			_priq_run_remove(&_kernel.ready_q.runq, thread);
+			runq_remove(thread);
 			z_mark_thread_as_not_queued(thread);
 			thread->base.thread_state |= _THREAD_DEAD;
 			k_spin_unlock(&sched_spinlock, key);
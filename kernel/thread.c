@@ -545,6 +545,9 @@ void z_setup_new_thread(struct k_thread *new_thread,
 #ifdef CONFIG_SCHED_CPU_MASK
 	new_thread->base.cpu_mask = -1;
 #endif
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	(void)memset(&new_thread->rt_stats, 0, sizeof(new_thread->rt_stats));
+#endif
 #ifdef CONFIG_ARCH_HAS_CUSTOM_SWAP_TO_MAIN
 	/* _current may be null if the dummy thread is not used */
 	if (!_current) {
@@ -731,8 +734,15 @@ void z_init_thread_base(struct _thread_base *thread_base, int priority,
 
 	thread_base->sched_locked = 0U;
 
+	thread_base->pended_mutex = NULL;
+
+#ifdef CONFIG_SCHED_CBS
+	(void)memset(&thread_base->cbs, 0, sizeof(thread_base->cbs));
+#endif
+
 #ifdef CONFIG_SMP
 	thread_base->is_idle = 0;
+	thread_base->cpu = 0U;
 #endif
 
 	/* swap_data does not need to be initialized */
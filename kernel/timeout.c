@@ -69,11 +69,38 @@ static int32_t elapsed(void)
 	return announce_remaining == 0 ? z_clock_elapsed() : 0;
 }
 
+#ifdef CONFIG_TIMEOUT_SLACK
+/* Latest expiry, in ticks from the last announced one, at which the first
+ * timeout can be handled along with the following ones without exceeding
+ * the slack of any of them.
+ */
+static int32_t batch_expiry(void)
+{
+	int64_t expiry = 0, limit = INT_MAX;
+
+	for (struct _timeout *t = first(); t != NULL; t = next(t)) {
+		expiry += t->dticks;
+		if (expiry > limit) {
+			break;
+		}
+
+		limit = MIN(limit, expiry + t->slack);
+	}
+
+	return (int32_t)limit;
+}
+#endif
+
 static int32_t next_timeout(void)
 {
 	struct _timeout *to = first();
 	int32_t ticks_elapsed = elapsed();
+#ifdef CONFIG_TIMEOUT_SLACK
+	int32_t ret = to == NULL ? MAX_WAIT :
+		MAX(0, batch_expiry() - ticks_elapsed);
+#else
 	int32_t ret = to == NULL ? MAX_WAIT : MAX(0, to->dticks - ticks_elapsed);
+#endif
 
 #ifdef CONFIG_TIMESLICING
 	if (_current_cpu->slice_ticks && _current_cpu->slice_ticks < ret) {
@@ -106,6 +133,10 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 
 	LOCKED(&timeout_lock) {
 		struct _timeout *t;
+#ifdef CONFIG_TIMEOUT_SLACK
+		/* the new timeout may end the batch of the first one */
+		int32_t prev_expiry = next_timeout();
+#endif
 
 		to->dticks = ticks + elapsed();
 		for (t = first(); t != NULL; t = next(t)) {
@@ -123,7 +154,12 @@ void z_add_timeout(struct _timeout *to, _timeout_func_t fn,
 			sys_dlist_append(&timeout_list, &to->node);
 		}
 
-		if (to == first()) {
+		bool sooner = (to == first());
+
+#ifdef CONFIG_TIMEOUT_SLACK
+		sooner = sooner || (next_timeout() != prev_expiry);
+#endif
+		if (sooner) {
 			z_clock_set_timeout(next_timeout(), false);
 		}
 	}
@@ -143,6 +179,25 @@ int z_abort_timeout(struct _timeout *to)
 	return ret;
 }
 
+#ifdef CONFIG_TIMEOUT_SLACK
+void z_timeout_slack_set(struct _timeout *timeout, k_timeout_t slack)
+{
+	k_ticks_t ticks;
+
+	__ASSERT(!K_TIMEOUT_EQ(slack, K_FOREVER), "");
+
+#ifdef CONFIG_LEGACY_TIMEOUT_API
+	ticks = k_ms_to_ticks_ceil32(slack);
+#else
+	ticks = slack.ticks;
+#endif
+
+	LOCKED(&timeout_lock) {
+		timeout->slack = (int32_t)MIN(MAX(ticks, 0), INT_MAX);
+	}
+}
+#endif
+
 /* must be locked */
 static k_ticks_t timeout_rem(struct _timeout *timeout)
 {
@@ -355,10 +355,32 @@ static int sdhc_spi_rx_block(struct sdhc_spi_data *data,
 	int err;
 	int token;
 	int i;
+	int remain;
 	/* Note the one extra byte to ensure there's an idle byte
 	 * between commands.
 	 */
 	uint8_t crc[SDHC_CRC16_SIZE + 1];
+	/* Ones are sent while the data and CRC are received */
+	struct spi_buf tx_bufs[SDMMC_DEFAULT_BLOCK_SIZE / sizeof(sdhc_ones) + 1];
+	struct spi_buf_set tx = {
+		.buffers = tx_bufs,
+	};
+	struct spi_buf rx_bufs[] = {
+		{
+			.buf = buf,
+			.len = len
+		},
+		{
+			.buf = crc,
+			.len = sizeof(crc)
+		}
+	};
+	const struct spi_buf_set rx = {
+		.buffers = rx_bufs,
+		.count = ARRAY_SIZE(rx_bufs),
+	};
+
+	__ASSERT_NO_MSG(len <= SDMMC_DEFAULT_BLOCK_SIZE);
 
 	token = sdhc_spi_skip(data, 0xFF);
 	if (token < 0) {
@@ -370,48 +392,26 @@ static int sdhc_spi_rx_block(struct sdhc_spi_data *data,
 		return -EIO;
 	}
 
-	/* Read the data in batches */
-	for (i = 0; i < len; i += sizeof(sdhc_ones)) {
-		int remain = MIN(sizeof(sdhc_ones), len - i);
-
-		struct spi_buf tx_bufs[] = {
-			{
-				.buf = (uint8_t *)sdhc_ones,
-				.len = remain
-			}
-		};
-
-		const struct spi_buf_set tx = {
-			.buffers = tx_bufs,
-			.count = 1,
-		};
-
-		struct spi_buf rx_bufs[] = {
-			{
-				.buf = &buf[i],
-				.len = remain
-			}
-		};
-
-		const struct spi_buf_set rx = {
-			.buffers = rx_bufs,
-			.count = 1,
-		};
-
-		err = sdhc_spi_trace(data, -1,
-				spi_transceive(data->spi, &data->cfg,
-				&tx, &rx),
-				&buf[i], remain);
-		if (err != 0) {
-			return err;
-		}
+	remain = len + sizeof(crc);
+	for (i = 0; remain > 0; i++) {
+		tx_bufs[i].buf = (uint8_t *)sdhc_ones;
+		tx_bufs[i].len = MIN(sizeof(sdhc_ones), remain);
+		remain -= tx_bufs[i].len;
 	}
+	tx.count = i;
 
-	err = sdhc_spi_rx_bytes(data, crc, sizeof(crc));
+	/* Read the data and the CRC in a single transfer, which the SPI
+	 * driver can do with DMA.
+	 */
+	err = sdhc_spi_trace(data, -1,
+			     spi_transceive(data->spi, &data->cfg, &tx, &rx),
+			     buf, len);
 	if (err != 0) {
 		return err;
 	}
 
+	sdhc_spi_trace(data, -1, 0, crc, sizeof(crc));
+
 	if (sys_get_be16(crc) != crc16_itu_t(0, buf, len)) {
 		/* Bad CRC */
 		return -EILSEQ;
@@ -420,33 +420,42 @@ static int sdhc_spi_rx_block(struct sdhc_spi_data *data,
 	return 0;
 }
 
-/* Transmits a SDHC data block */
-static int sdhc_spi_tx_block(struct sdhc_spi_data *data,
-	uint8_t *send, int len)
+/* Transmits a SDHC data block starting with the given token */
+static int sdhc_spi_tx_block(struct sdhc_spi_data *data, uint8_t token,
+	const uint8_t *send, int len)
 {
-	uint8_t buf[SDHC_CRC16_SIZE];
+	uint8_t crc[SDHC_CRC16_SIZE];
 	int err;
+	struct spi_buf tx_bufs[] = {
+		{
+			.buf = &token,
+			.len = 1
+		},
+		{
+			.buf = (uint8_t *)send,
+			.len = len
+		},
+		{
+			.buf = crc,
+			.len = sizeof(crc)
+		}
+	};
+	const struct spi_buf_set tx = {
+		.buffers = tx_bufs,
+		.count = ARRAY_SIZE(tx_bufs),
+	};
 
-	/* Start the block */
-	buf[0] = SDHC_TOKEN_SINGLE;
-	err = sdhc_spi_tx(data, buf, 1);
-	if (err != 0) {
-		return err;
-	}
+	sys_put_be16(crc16_itu_t(0, send, len), crc);
 
-	/* Write the payload */
-	err = sdhc_spi_tx(data, send, len);
+	/* Write the token, the payload and the CRC in a single transfer */
+	err = spi_write(data->spi, &data->cfg, &tx);
 	if (err != 0) {
-		return err;
+		return sdhc_spi_trace(data, 1, err, NULL, 0);
 	}
 
-	/* Build and write the trailing CRC */
-	sys_put_be16(crc16_itu_t(0, send, len), buf);
-
-	err = sdhc_spi_tx(data, buf, sizeof(buf));
-	if (err != 0) {
-		return err;
-	}
+	sdhc_spi_trace(data, 1, 0, &token, 1);
+	sdhc_spi_trace(data, 1, 0, send, len);
+	sdhc_spi_trace(data, 1, 0, crc, sizeof(crc));
 
 	return sdhc_map_data_status(sdhc_spi_rx_u8(data));
 }
@@ -653,30 +662,34 @@ static int sdhc_spi_detect(struct sdhc_spi_data *data)
 	return 0;
 }
 
+/* Translates a sector number to a data address.
+ * SDSC cards use byte addressing, SDHC cards use block addressing.
+ */
+static uint32_t sdhc_spi_sector_addr(struct sdhc_spi_data *data,
+	uint32_t sector)
+{
+	if (data->high_capacity) {
+		return sector;
+	}
+
+	return sector * SDMMC_DEFAULT_BLOCK_SIZE;
+}
+
 static int sdhc_spi_read(struct sdhc_spi_data *data,
 	uint8_t *buf, uint32_t sector, uint32_t count)
 {
 	int err;
-	uint32_t addr;
 
 	err = sdhc_map_disk_status(data->status);
 	if (err != 0) {
 		return err;
 	}
 
-	/* Translate sector number to data address.
-	 * SDSC cards use byte addressing, SDHC cards use block addressing.
-	 */
-	if (data->high_capacity) {
-		addr = sector;
-	} else {
-		addr = sector * SDMMC_DEFAULT_BLOCK_SIZE;
-	}
-
 	sdhc_spi_set_cs(data, 0);
 
 	/* Send the start read command */
-	err = sdhc_spi_cmd_r1(data, SDHC_READ_MULTIPLE_BLOCK, addr);
+	err = sdhc_spi_cmd_r1(data, SDHC_READ_MULTIPLE_BLOCK,
+			      sdhc_spi_sector_addr(data, sector));
 	if (err != 0) {
 		goto error;
 	}
@@ -703,57 +716,107 @@ error:
 	return err;
 }
 
-static int sdhc_spi_write(struct sdhc_spi_data *data,
-	const uint8_t *buf, uint32_t sector, uint32_t count)
+/* Writes a single block */
+static int sdhc_spi_write_single(struct sdhc_spi_data *data,
+	const uint8_t *buf, uint32_t sector)
 {
 	int err;
-	uint32_t addr;
 
-	err = sdhc_map_disk_status(data->status);
+	err = sdhc_spi_cmd_r1(data, SDHC_WRITE_BLOCK,
+			      sdhc_spi_sector_addr(data, sector));
+	if (err < 0) {
+		return err;
+	}
+
+	err = sdhc_spi_tx_block(data, SDHC_TOKEN_SINGLE, buf,
+				SDMMC_DEFAULT_BLOCK_SIZE);
 	if (err != 0) {
 		return err;
 	}
 
-	sdhc_spi_set_cs(data, 0);
+	/* Wait for the card to finish programming */
+	return sdhc_spi_skip_until_ready(data);
+}
 
-	/* Write the blocks one-by-one */
-	for (; count != 0U; count--) {
-		/* Translate sector number to data address.
-		 * SDSC cards use byte addressing, SDHC cards use block addressing.
-		 */
-		if (data->high_capacity) {
-			addr = sector;
-		} else {
-			addr = sector * SDMMC_DEFAULT_BLOCK_SIZE;
-		}
+/* Writes consecutive blocks with a single command */
+static int sdhc_spi_write_multi(struct sdhc_spi_data *data,
+	const uint8_t *buf, uint32_t sector, uint32_t count)
+{
+	uint8_t token = SDHC_TOKEN_STOP_TRAN;
+	int err, err2;
 
-		err = sdhc_spi_cmd_r1(data, SDHC_WRITE_BLOCK, addr);
-		if (err < 0) {
-			goto error;
-		}
+	/* Tell the card how many blocks are coming so that it can erase
+	 * them in advance.
+	 */
+	err = sdhc_spi_cmd_r1(data, SDHC_APP_CMD, 0);
+	if (err != 0) {
+		return err;
+	}
 
-		err = sdhc_spi_tx_block(data, (uint8_t *)buf,
-			SDMMC_DEFAULT_BLOCK_SIZE);
+	err = sdhc_spi_cmd_r1(data, SDHC_APP_SET_WRITE_BLK_ERASE_CNT, count);
+	if (err != 0) {
+		return err;
+	}
+
+	err = sdhc_spi_cmd_r1(data, SDHC_WRITE_MULTIPLE_BLOCK,
+			      sdhc_spi_sector_addr(data, sector));
+	if (err != 0) {
+		return err;
+	}
+
+	for (; count != 0U; count--) {
+		err = sdhc_spi_tx_block(data, SDHC_TOKEN_MULTI_WRITE, buf,
+					SDMMC_DEFAULT_BLOCK_SIZE);
 		if (err != 0) {
-			goto error;
+			break;
 		}
 
 		/* Wait for the card to finish programming */
 		err = sdhc_spi_skip_until_ready(data);
 		if (err != 0) {
-			goto error;
-		}
-
-		err = sdhc_spi_cmd_r2(data, SDHC_SEND_STATUS, 0);
-		if (err != 0) {
-			goto error;
+			break;
 		}
 
 		buf += SDMMC_DEFAULT_BLOCK_SIZE;
-		sector++;
 	}
 
-	err = 0;
+	/* End the transfer, also after an error. One byte is skipped
+	 * before the card signals busy.
+	 */
+	err2 = sdhc_spi_tx(data, &token, 1);
+	if (err2 == 0) {
+		sdhc_spi_rx_u8(data);
+		err2 = sdhc_spi_skip_until_ready(data);
+	}
+
+	return (err != 0) ? err : err2;
+}
+
+static int sdhc_spi_write(struct sdhc_spi_data *data,
+	const uint8_t *buf, uint32_t sector, uint32_t count)
+{
+	int err;
+
+	err = sdhc_map_disk_status(data->status);
+	if (err != 0) {
+		return err;
+	}
+
+	sdhc_spi_set_cs(data, 0);
+
+	if (count == 1U) {
+		err = sdhc_spi_write_single(data, buf, sector);
+	} else {
+		err = sdhc_spi_write_multi(data, buf, sector, count);
+	}
+
+	if (err != 0) {
+		goto error;
+	}
+
+	/* Check that the programming succeeded */
+	err = sdhc_spi_cmd_r2(data, SDHC_SEND_STATUS, 0);
+
 error:
 	sdhc_spi_set_cs(data, 1);
 
@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/types.h>
+#include <kernel.h>
+#include <disk/disk_access.h>
+#include <errno.h>
+
+#include "disk_cache.h"
+
+#define LOG_LEVEL CONFIG_DISK_LOG_LEVEL
+#include <logging/log.h>
+LOG_MODULE_DECLARE(disk);
+
+#define SECTOR_SIZE CONFIG_DISK_CACHE_SECTOR_SIZE
+
+/* Accesses larger than this bypass the cache */
+#define MAX_CACHED_ACCESS (CONFIG_DISK_CACHE_SECTORS / 2)
+
+struct disk_cache_entry {
+	struct disk_info *disk;	/* NULL if the entry is not used */
+	uint32_t sector;
+	uint32_t last_use;
+	bool dirty;
+	uint8_t data[SECTOR_SIZE];
+};
+
+static struct disk_cache_entry cache[CONFIG_DISK_CACHE_SECTORS];
+static uint32_t use_count;
+
+/* disk and sector following the last read, to detect sequential reads */
+static struct disk_info *seq_disk;
+static uint32_t seq_sector;
+
+#if CONFIG_DISK_CACHE_READ_AHEAD > 0
+static uint8_t read_ahead_buf[CONFIG_DISK_CACHE_READ_AHEAD * SECTOR_SIZE];
+#endif
+
+static K_MUTEX_DEFINE(cache_lock);
+
+static bool disk_cache_usable(struct disk_info *disk)
+{
+	uint32_t sector_size;
+
+	if (disk->ops->ioctl == NULL ||
+	    disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_SIZE, &sector_size)) {
+		return false;
+	}
+
+	return sector_size == SECTOR_SIZE;
+}
+
+static struct disk_cache_entry *disk_cache_find(struct disk_info *disk,
+						uint32_t sector)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache[i].disk == disk && cache[i].sector == sector) {
+			return &cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+static int disk_cache_write_entry(struct disk_cache_entry *entry)
+{
+	int rc;
+
+	rc = entry->disk->ops->write(entry->disk, entry->data, entry->sector,
+				     1);
+	if (rc) {
+		LOG_ERR("Cannot write sector %u (%d)", entry->sector, rc);
+		return rc;
+	}
+
+	entry->dirty = false;
+
+	return 0;
+}
+
+/* Get an unused entry or the least recently used one, which is written to
+ * the disk first if modified.
+ */
+static struct disk_cache_entry *disk_cache_alloc(void)
+{
+	struct disk_cache_entry *entry = &cache[0];
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache[i].disk == NULL) {
+			entry = &cache[i];
+			break;
+		}
+
+		if (cache[i].last_use < entry->last_use) {
+			entry = &cache[i];
+		}
+	}
+
+	if (entry->disk != NULL && entry->dirty) {
+		if (disk_cache_write_entry(entry)) {
+			return NULL;
+		}
+	}
+
+	entry->disk = NULL;
+
+	return entry;
+}
+
+static int disk_cache_insert(struct disk_info *disk, uint32_t sector,
+			     const uint8_t *data, bool dirty)
+{
+	struct disk_cache_entry *entry;
+
+	entry = disk_cache_find(disk, sector);
+	if (entry == NULL) {
+		entry = disk_cache_alloc();
+		if (entry == NULL) {
+			return -EIO;
+		}
+
+		entry->disk = disk;
+		entry->sector = sector;
+		entry->dirty = false;
+	}
+
+	memcpy(entry->data, data, SECTOR_SIZE);
+	entry->dirty |= dirty;
+	entry->last_use = ++use_count;
+
+	return 0;
+}
+
+#if CONFIG_DISK_CACHE_READ_AHEAD > 0
+/* Read the sectors following a sequential read into the cache. Errors are
+ * ignored, the sectors are read again when they are needed.
+ */
+static void disk_cache_read_ahead(struct disk_info *disk, uint32_t sector)
+{
+	uint32_t sector_count;
+	uint32_t count, i;
+	int rc;
+
+	if (disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_COUNT,
+			     &sector_count)) {
+		return;
+	}
+
+	for (count = 0; count < CONFIG_DISK_CACHE_READ_AHEAD; count++) {
+		if (sector + count >= sector_count ||
+		    disk_cache_find(disk, sector + count) != NULL) {
+			break;
+		}
+	}
+
+	if (count == 0) {
+		return;
+	}
+
+	rc = disk->ops->read(disk, read_ahead_buf, sector, count);
+	if (rc) {
+		return;
+	}
+
+	for (i = 0; i < count; i++) {
+		(void)disk_cache_insert(disk, sector + i,
+					&read_ahead_buf[i * SECTOR_SIZE],
+					false);
+	}
+}
+#endif
+
+int disk_cache_read(struct disk_info *disk, uint8_t *data_buf,
+		    uint32_t start_sector, uint32_t num_sector)
+{
+	struct disk_cache_entry *entry;
+	uint32_t i, j, n;
+	int rc = 0;
+
+	if (!disk_cache_usable(disk)) {
+		return disk->ops->read(disk, data_buf, start_sector,
+				       num_sector);
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	for (i = 0; i < num_sector; i += n) {
+		entry = disk_cache_find(disk, start_sector + i);
+		if (entry != NULL) {
+			memcpy(&data_buf[i * SECTOR_SIZE], entry->data,
+			       SECTOR_SIZE);
+			entry->last_use = ++use_count;
+			n = 1;
+			continue;
+		}
+
+		/* read all the following sectors missing from the cache with
+		 * a single access.
+		 */
+		for (n = 1; i + n < num_sector; n++) {
+			if (disk_cache_find(disk, start_sector + i + n)) {
+				break;
+			}
+		}
+
+		rc = disk->ops->read(disk, &data_buf[i * SECTOR_SIZE],
+				     start_sector + i, n);
+		if (rc) {
+			goto end;
+		}
+
+		if (num_sector > MAX_CACHED_ACCESS) {
+			continue;
+		}
+
+		for (j = i; j < i + n; j++) {
+			(void)disk_cache_insert(disk, start_sector + j,
+						&data_buf[j * SECTOR_SIZE],
+						false);
+		}
+	}
+
+#if CONFIG_DISK_CACHE_READ_AHEAD > 0
+	if (disk == seq_disk && start_sector == seq_sector) {
+		disk_cache_read_ahead(disk, start_sector + num_sector);
+	}
+#endif
+
+	seq_disk = disk;
+	seq_sector = start_sector + num_sector;
+
+end:
+	k_mutex_unlock(&cache_lock);
+	return rc;
+}
+
+int disk_cache_write(struct disk_info *disk, const uint8_t *data_buf,
+		     uint32_t start_sector, uint32_t num_sector)
+{
+	struct disk_cache_entry *entry;
+	uint32_t i;
+	int rc = 0;
+
+	if (!disk_cache_usable(disk)) {
+		return disk->ops->write(disk, data_buf, start_sector,
+					num_sector);
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (IS_ENABLED(CONFIG_DISK_CACHE_WRITE_BACK) &&
+	    num_sector <= MAX_CACHED_ACCESS) {
+		for (i = 0; i < num_sector; i++) {
+			rc = disk_cache_insert(disk, start_sector + i,
+					       &data_buf[i * SECTOR_SIZE],
+					       true);
+			if (rc) {
+				goto end;
+			}
+		}
+
+		goto end;
+	}
+
+	rc = disk->ops->write(disk, data_buf, start_sector, num_sector);
+	if (rc) {
+		goto end;
+	}
+
+	/* the cached copies, modified or not, are replaced by the new data */
+	for (i = 0; i < num_sector; i++) {
+		entry = disk_cache_find(disk, start_sector + i);
+		if (entry != NULL) {
+			memcpy(entry->data, &data_buf[i * SECTOR_SIZE],
+			       SECTOR_SIZE);
+			entry->dirty = false;
+		}
+	}
+
+end:
+	k_mutex_unlock(&cache_lock);
+	return rc;
+}
+
+int disk_cache_sync(struct disk_info *disk)
+{
+	int rc = 0, rc2;
+	int i;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache[i].disk != disk || !cache[i].dirty) {
+			continue;
+		}
+
+		rc2 = disk_cache_write_entry(&cache[i]);
+		if (rc2 && !rc) {
+			rc = rc2;
+		}
+	}
+
+	k_mutex_unlock(&cache_lock);
+	return rc;
+}
+
+void disk_cache_invalidate(struct disk_info *disk)
+{
+	int i;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache[i].disk == disk) {
+			cache[i].disk = NULL;
+			cache[i].dirty = false;
+		}
+	}
+
+	if (seq_disk == disk) {
+		seq_disk = NULL;
+	}
+
+	k_mutex_unlock(&cache_lock);
+}
+
+int disk_cache_release(struct disk_info *disk)
+{
+	int rc;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	rc = disk_cache_sync(disk);
+	disk_cache_invalidate(disk);
+
+	k_mutex_unlock(&cache_lock);
+	return rc;
+}
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_SUBSYS_DISK_DISK_CACHE_H_
+#define ZEPHYR_SUBSYS_DISK_DISK_CACHE_H_
+
+#include <disk/disk_access.h>
+
+/* Read sectors through the cache */
+int disk_cache_read(struct disk_info *disk, uint8_t *data_buf,
+		    uint32_t start_sector, uint32_t num_sector);
+
+/* Write sectors through the cache */
+int disk_cache_write(struct disk_info *disk, const uint8_t *data_buf,
+		     uint32_t start_sector, uint32_t num_sector);
+
+/* Write the modified sectors of the disk */
+int disk_cache_sync(struct disk_info *disk);
+
+/* Drop all the sectors of the disk, without writing the modified ones */
+void disk_cache_invalidate(struct disk_info *disk);
+
+/* Write the modified sectors of the disk and drop all its sectors */
+int disk_cache_release(struct disk_info *disk);
+
+#endif /* ZEPHYR_SUBSYS_DISK_DISK_CACHE_H_ */
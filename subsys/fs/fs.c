@@ -29,21 +29,23 @@ static int fs_get_mnt_point(struct fs_mount_t **mnt_pntp,
 			    const char *name, size_t *match_len)
 {
 	struct fs_mount_t *mnt_p = NULL, *itr;
-	size_t longest_match = 0;
 	size_t len, name_len = strlen(name);
 	sys_dnode_t *node;
 
 	k_mutex_lock(&mutex, K_FOREVER);
+	/*
+	 * The mount list is sorted by decreasing mount point length, the
+	 * first match is the longest one.
+	 */
 	SYS_DLIST_FOR_EACH_NODE(&fs_mnt_list, node) {
 		itr = CONTAINER_OF(node, struct fs_mount_t, node);
 		len = itr->mountp_len;
 
 		/*
-		 * Move to next node if mount point length is
-		 * shorter than longest_match match or if path
-		 * name is shorter than the mount point name.
+		 * Move to next node if path name is shorter than the
+		 * mount point name.
 		 */
-		if ((len < longest_match) || (len > name_len)) {
+		if (len > name_len) {
 			continue;
 		}
 
@@ -58,7 +60,7 @@ static int fs_get_mnt_point(struct fs_mount_t **mnt_pntp,
 		/* Check for mount point match */
 		if (strncmp(name, itr->mnt_point, len) == 0) {
 			mnt_p = itr;
-			longest_match = len;
+			break;
 		}
 	}
 	k_mutex_unlock(&mutex);
@@ -74,6 +76,179 @@ static int fs_get_mnt_point(struct fs_mount_t **mnt_pntp,
 	return 0;
 }
 
+/* Kinds of cached lookup results */
+#define PATH_CACHE_MISSING	BIT(0)	/* path does not exist */
+#define PATH_CACHE_DIR		BIT(1)	/* path is a directory */
+#define PATH_CACHE_ALL		(PATH_CACHE_MISSING | PATH_CACHE_DIR)
+
+#if defined(CONFIG_FS_PATH_CACHE)
+struct fs_path_cache_entry {
+	char path[CONFIG_FS_PATH_CACHE_PATH_LEN];	/* empty if not used */
+	struct fs_mount_t *mp;
+	uint8_t kind;
+	uint32_t last_use;
+};
+
+static struct fs_path_cache_entry path_cache[CONFIG_FS_PATH_CACHE_SIZE];
+static uint32_t path_cache_use;
+
+/*
+ * Incremented by every invalidation. Invalidations are done after the file
+ * system is modified, a stat result is not cached if the cache was
+ * invalidated while the file system was accessed as it may be outdated.
+ */
+static uint32_t path_cache_gen;
+
+/* Find a cached path, mutex must be held. */
+static struct fs_path_cache_entry *fs_path_cache_find(const char *path)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(path_cache); i++) {
+		if (path_cache[i].path[0] != '\0' &&
+		    strcmp(path_cache[i].path, path) == 0) {
+			return &path_cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Return 0 and fill the entry for a cached directory, -ENOENT for a cached
+ * missing path, or -EAGAIN if the file system must be accessed. In the last
+ * case gen is set to the generation the result may be cached for.
+ */
+static int fs_path_cache_lookup(const char *path, struct fs_dirent *entry,
+				uint32_t *gen)
+{
+	struct fs_path_cache_entry *pce;
+	int rc = -EAGAIN;
+
+	k_mutex_lock(&mutex, K_FOREVER);
+
+	pce = fs_path_cache_find(path);
+	if (pce == NULL) {
+		*gen = path_cache_gen;
+		goto end;
+	}
+
+	pce->last_use = ++path_cache_use;
+
+	if (pce->kind == PATH_CACHE_MISSING) {
+		rc = -ENOENT;
+		goto end;
+	}
+
+	entry->type = FS_DIR_ENTRY_DIR;
+	strncpy(entry->name, strrchr(pce->path, '/') + 1,
+		sizeof(entry->name) - 1);
+	entry->name[sizeof(entry->name) - 1] = 0;
+	entry->size = 0;
+	rc = 0;
+
+end:
+	k_mutex_unlock(&mutex);
+	return rc;
+}
+
+/* Cache the result of a stat, replacing the least recently used entry. */
+static void fs_path_cache_insert(const char *path, struct fs_mount_t *mp,
+				 int rc, const struct fs_dirent *entry,
+				 uint32_t gen)
+{
+	struct fs_path_cache_entry *pce = &path_cache[0];
+	size_t len = strlen(path);
+	uint8_t kind;
+	int i;
+
+	/*
+	 * File sizes change when written, only missing paths and
+	 * directories are cached. A path ending with a separator does not
+	 * give the directory name.
+	 */
+	if (rc == -ENOENT) {
+		kind = PATH_CACHE_MISSING;
+	} else if (rc == 0 && entry->type == FS_DIR_ENTRY_DIR) {
+		kind = PATH_CACHE_DIR;
+	} else {
+		return;
+	}
+
+	if (len >= sizeof(pce->path) || path[len - 1] == '/') {
+		return;
+	}
+
+	k_mutex_lock(&mutex, K_FOREVER);
+
+	if (gen != path_cache_gen || fs_path_cache_find(path) != NULL) {
+		goto end;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(path_cache); i++) {
+		if (path_cache[i].path[0] == '\0') {
+			pce = &path_cache[i];
+			break;
+		}
+
+		if (path_cache[i].last_use < pce->last_use) {
+			pce = &path_cache[i];
+		}
+	}
+
+	memcpy(pce->path, path, len + 1);
+	pce->mp = mp;
+	pce->kind = kind;
+	pce->last_use = ++path_cache_use;
+
+end:
+	k_mutex_unlock(&mutex);
+}
+
+/*
+ * Drop the cached results of the given kinds for a mount point, or for all
+ * of them if mp is NULL. Paths are not normalized and may be case
+ * insensitive, so all the matching entries of the mount point are dropped
+ * rather than only the modified path.
+ */
+static void fs_path_cache_invalidate(struct fs_mount_t *mp, uint8_t kinds)
+{
+	int i;
+
+	k_mutex_lock(&mutex, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(path_cache); i++) {
+		if ((mp == NULL || path_cache[i].mp == mp) &&
+		    (path_cache[i].kind & kinds)) {
+			path_cache[i].path[0] = '\0';
+		}
+	}
+
+	path_cache_gen++;
+
+	k_mutex_unlock(&mutex);
+}
+#else
+static inline int fs_path_cache_lookup(const char *path,
+				       struct fs_dirent *entry, uint32_t *gen)
+{
+	*gen = 0U;
+	return -EAGAIN;
+}
+
+static inline void fs_path_cache_insert(const char *path,
+					struct fs_mount_t *mp, int rc,
+					const struct fs_dirent *entry,
+					uint32_t gen)
+{
+}
+
+static inline void fs_path_cache_invalidate(struct fs_mount_t *mp,
+					    uint8_t kinds)
+{
+}
+#endif
+
 /* File operations */
 int fs_open(struct fs_file_t *zfp, const char *file_name)
 {
@@ -96,6 +271,8 @@ int fs_open(struct fs_file_t *zfp, const char *file_name)
 
 	if (zfp->mp->fs->open != NULL) {
 		rc = zfp->mp->fs->open(zfp, file_name);
+		/* The file is created if it does not exist */
+		fs_path_cache_invalidate(mp, PATH_CACHE_MISSING);
 		if (rc < 0) {
 			LOG_ERR("file open error (%d)", rc);
 			return rc;
@@ -150,6 +327,52 @@ ssize_t fs_write(struct fs_file_t *zfp, const void *ptr, size_t size)
 	return rc;
 }
 
+ssize_t fs_readv(struct fs_file_t *zfp, const struct fs_iovec *iov,
+		 int iovcnt)
+{
+	ssize_t rc, total = 0;
+	int i;
+
+	for (i = 0; i < iovcnt; i++) {
+		rc = fs_read(zfp, iov[i].iov_base, iov[i].iov_len);
+		if (rc < 0) {
+			return total ? total : rc;
+		}
+
+		total += rc;
+
+		/* end of file */
+		if (rc < iov[i].iov_len) {
+			break;
+		}
+	}
+
+	return total;
+}
+
+ssize_t fs_writev(struct fs_file_t *zfp, const struct fs_iovec *iov,
+		  int iovcnt)
+{
+	ssize_t rc, total = 0;
+	int i;
+
+	for (i = 0; i < iovcnt; i++) {
+		rc = fs_write(zfp, iov[i].iov_base, iov[i].iov_len);
+		if (rc < 0) {
+			return total ? total : rc;
+		}
+
+		total += rc;
+
+		/* disk full */
+		if (rc < iov[i].iov_len) {
+			break;
+		}
+	}
+
+	return total;
+}
+
 int fs_seek(struct fs_file_t *zfp, off_t offset, int whence)
 {
 	int rc = -EINVAL;
@@ -369,6 +592,7 @@ int fs_mkdir(const char *abs_path)
 
 	if (mp->fs->mkdir != NULL) {
 		rc = mp->fs->mkdir(mp, abs_path);
+		fs_path_cache_invalidate(mp, PATH_CACHE_MISSING);
 		if (rc < 0) {
 			LOG_ERR("failed to create directory (%d)", rc);
 		}
@@ -396,6 +620,7 @@ int fs_unlink(const char *abs_path)
 
 	if (mp->fs->unlink != NULL) {
 		rc = mp->fs->unlink(mp, abs_path);
+		fs_path_cache_invalidate(mp, PATH_CACHE_DIR);
 		if (rc < 0) {
 			LOG_ERR("failed to unlink path (%d)", rc);
 		}
@@ -430,6 +655,7 @@ int fs_rename(const char *from, const char *to)
 
 	if (mp->fs->rename != NULL) {
 		rc = mp->fs->rename(mp, from, to);
+		fs_path_cache_invalidate(mp, PATH_CACHE_ALL);
 		if (rc < 0) {
 			LOG_ERR("failed to rename file or dir (%d)", rc);
 		}
@@ -441,6 +667,7 @@ int fs_rename(const char *from, const char *to)
 int fs_stat(const char *abs_path, struct fs_dirent *entry)
 {
 	struct fs_mount_t *mp;
+	uint32_t gen;
 	int rc = -EINVAL;
 
 	if ((abs_path == NULL) ||
@@ -449,6 +676,11 @@ int fs_stat(const char *abs_path, struct fs_dirent *entry)
 		return -EINVAL;
 	}
 
+	rc = fs_path_cache_lookup(abs_path, entry, &gen);
+	if (rc != -EAGAIN) {
+		return rc;
+	}
+
 	rc = fs_get_mnt_point(&mp, abs_path, NULL);
 	if (rc < 0) {
 		LOG_ERR("%s:mount point not found!!", __func__);
@@ -457,6 +689,7 @@ int fs_stat(const char *abs_path, struct fs_dirent *entry)
 
 	if (mp->fs->stat != NULL) {
 		rc = mp->fs->stat(mp, abs_path, entry);
+		fs_path_cache_insert(abs_path, mp, rc, entry, gen);
 		if (rc < 0) {
 			LOG_ERR("failed get file or dir stat (%d)", rc);
 		}
@@ -491,6 +724,14 @@ int fs_statvfs(const char *abs_path, struct fs_statvfs *stat)
 	return rc;
 }
 
+static int fs_mnt_is_shorter(sys_dnode_t *node, void *data)
+{
+	struct fs_mount_t *itr = CONTAINER_OF(node, struct fs_mount_t, node);
+	struct fs_mount_t *mp = data;
+
+	return itr->mountp_len < mp->mountp_len;
+}
+
 int fs_mount(struct fs_mount_t *mp)
 {
 	struct fs_mount_t *itr;
@@ -554,8 +795,9 @@ int fs_mount(struct fs_mount_t *mp)
 	/* set mount point fs interface */
 	mp->fs = fs;
 
-	/*  append to the mount list */
-	sys_dlist_append(&fs_mnt_list, &mp->node);
+	/* insert in the mount list, sorted by decreasing length */
+	sys_dlist_insert_at(&fs_mnt_list, &mp->node, fs_mnt_is_shorter, mp);
+	fs_path_cache_invalidate(NULL, PATH_CACHE_ALL);
 	LOG_DBG("fs mounted at %s", log_strdup(mp->mnt_point));
 
 mount_err:
@@ -592,6 +834,7 @@ int fs_unmount(struct fs_mount_t *mp)
 
 	/* remove mount node from the list */
 	sys_dlist_remove(&mp->node);
+	fs_path_cache_invalidate(NULL, PATH_CACHE_ALL);
 	LOG_DBG("fs unmounted from %s", log_strdup(mp->mnt_point));
 
 unmount_err:
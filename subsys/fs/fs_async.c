@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <zephyr/types.h>
+#include <errno.h>
+#include <init.h>
+#include <kernel.h>
+#include <fs/fs.h>
+
+enum fs_async_op {
+	FS_ASYNC_READ,
+	FS_ASYNC_WRITE,
+	FS_ASYNC_SYNC,
+};
+
+static K_THREAD_STACK_DEFINE(fs_async_stack, CONFIG_FS_ASYNC_STACK_SIZE);
+static struct k_work_q fs_async_work_q;
+static struct k_work fs_async_work;
+
+/* requests waiting to be executed, in submission order */
+static sys_slist_t fs_async_list;
+static struct k_spinlock fs_async_lock;
+
+static void fs_async_complete(struct fs_async_req *req, ssize_t result)
+{
+	/* the request may be reused by the callback */
+	struct k_poll_signal *signal = req->signal;
+
+	req->result = result;
+
+	if (req->cb != NULL) {
+		req->cb(req);
+	}
+
+	if (signal != NULL) {
+		k_poll_signal_raise(signal, result);
+	}
+}
+
+/* writes coalesced by the work queue, only used from its thread */
+static uint8_t fs_async_buf[CONFIG_FS_ASYNC_BATCH_BUF_SIZE];
+
+/*
+ * Take the writes following the first one for the same file, as long as
+ * they fit in the buffer with it, so that they are done with a single
+ * write of the file system.
+ */
+static int fs_async_take_writes(struct fs_async_req **reqs)
+{
+	struct fs_async_req *req;
+	k_spinlock_key_t key;
+	size_t total = reqs[0]->size;
+	int count = 1;
+
+	if (total > sizeof(fs_async_buf)) {
+		return count;
+	}
+
+	key = k_spin_lock(&fs_async_lock);
+
+	while (count < CONFIG_FS_ASYNC_BATCH_SIZE) {
+		req = SYS_SLIST_PEEK_HEAD_CONTAINER(&fs_async_list, req, node);
+		if (req == NULL || req->op != FS_ASYNC_WRITE ||
+		    req->zfp != reqs[0]->zfp ||
+		    req->size > sizeof(fs_async_buf) - total) {
+			break;
+		}
+
+		(void)sys_slist_get(&fs_async_list);
+
+		reqs[count] = req;
+		total += req->size;
+		count++;
+	}
+
+	k_spin_unlock(&fs_async_lock, key);
+
+	return count;
+}
+
+static void fs_async_write(struct fs_async_req *req)
+{
+	struct fs_async_req *reqs[CONFIG_FS_ASYNC_BATCH_SIZE];
+	size_t total = 0;
+	ssize_t rc, len;
+	int count, i;
+
+	reqs[0] = req;
+	count = fs_async_take_writes(reqs);
+
+	if (count == 1) {
+		fs_async_complete(req, fs_write(req->zfp, req->buf,
+						req->size));
+		return;
+	}
+
+	for (i = 0; i < count; i++) {
+		memcpy(&fs_async_buf[total], reqs[i]->buf, reqs[i]->size);
+		total += reqs[i]->size;
+	}
+
+	rc = fs_write(req->zfp, fs_async_buf, total);
+
+	/* Split the written size between the requests, the ones after a
+	 * short write get 0 like a write to a full disk.
+	 */
+	for (i = 0; i < count; i++) {
+		if (rc < 0) {
+			fs_async_complete(reqs[i], rc);
+			continue;
+		}
+
+		len = MIN(rc, reqs[i]->size);
+		rc -= len;
+		fs_async_complete(reqs[i], len);
+	}
+}
+
+static void fs_async_handler(struct k_work *work)
+{
+	struct fs_async_req *req;
+	k_spinlock_key_t key;
+	sys_snode_t *node;
+
+	while (true) {
+		key = k_spin_lock(&fs_async_lock);
+		node = sys_slist_get(&fs_async_list);
+		k_spin_unlock(&fs_async_lock, key);
+
+		if (node == NULL) {
+			break;
+		}
+
+		req = CONTAINER_OF(node, struct fs_async_req, node);
+
+		switch (req->op) {
+		case FS_ASYNC_READ:
+			fs_async_complete(req, fs_read(req->zfp, req->buf,
+						       req->size));
+			break;
+		case FS_ASYNC_WRITE:
+			fs_async_write(req);
+			break;
+		case FS_ASYNC_SYNC:
+			fs_async_complete(req, fs_sync(req->zfp));
+			break;
+		}
+	}
+}
+
+static int fs_async_submit(struct fs_file_t *zfp, struct fs_async_req *req,
+			   enum fs_async_op op)
+{
+	k_spinlock_key_t key;
+
+	if (zfp == NULL || zfp->mp == NULL || req == NULL) {
+		return -EINVAL;
+	}
+
+	if (op != FS_ASYNC_SYNC && req->buf == NULL && req->size != 0) {
+		return -EINVAL;
+	}
+
+	req->zfp = zfp;
+	req->op = op;
+	req->result = 0;
+
+	key = k_spin_lock(&fs_async_lock);
+	sys_slist_append(&fs_async_list, &req->node);
+	k_spin_unlock(&fs_async_lock, key);
+
+	k_work_submit_to_queue(&fs_async_work_q, &fs_async_work);
+
+	return 0;
+}
+
+int fs_read_async(struct fs_file_t *zfp, struct fs_async_req *req)
+{
+	return fs_async_submit(zfp, req, FS_ASYNC_READ);
+}
+
+int fs_write_async(struct fs_file_t *zfp, struct fs_async_req *req)
+{
+	return fs_async_submit(zfp, req, FS_ASYNC_WRITE);
+}
+
+int fs_sync_async(struct fs_file_t *zfp, struct fs_async_req *req)
+{
+	return fs_async_submit(zfp, req, FS_ASYNC_SYNC);
+}
+
+static int fs_async_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	sys_slist_init(&fs_async_list);
+	k_work_init(&fs_async_work, fs_async_handler);
+
+	k_work_q_start(&fs_async_work_q, fs_async_stack,
+		       K_THREAD_STACK_SIZEOF(fs_async_stack),
+		       K_PRIO_PREEMPT(CONFIG_FS_ASYNC_PRIORITY));
+	k_thread_name_set(&fs_async_work_q.thread, "fs_async");
+
+	return 0;
+}
+
+SYS_INIT(fs_async_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
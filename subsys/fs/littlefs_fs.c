@@ -25,7 +25,7 @@
 struct lfs_file_data {
 	struct lfs_file file;
 	struct lfs_file_config config;
-	struct k_mem_block cache_block;
+	void *cache_block;
 };
 
 #define LFS_FILEP(fp) (&((struct lfs_file_data *)(fp->filep))->file)
@@ -36,20 +36,51 @@ K_MEM_SLAB_DEFINE(file_data_pool, sizeof(struct lfs_file_data),
 K_MEM_SLAB_DEFINE(lfs_dir_pool, sizeof(struct lfs_dir),
 		  CONFIG_FS_LITTLEFS_NUM_DIRS, 4);
 
-/* If not explicitly customizing provide a default that's appropriate
- * based on other configuration options.
+/* If not explicitly sized provide a heap that's appropriate based on
+ * other configuration options.
  */
-#ifndef CONFIG_FS_LITTLEFS_FC_MEM_POOL
+#if CONFIG_FS_LITTLEFS_FC_HEAP_SIZE > 0
+#define FC_HEAP_SIZE CONFIG_FS_LITTLEFS_FC_HEAP_SIZE
+#else
+#ifdef CONFIG_FS_LITTLEFS_FC_MEM_POOL
+#define FC_HEAP_CACHE_SIZE CONFIG_FS_LITTLEFS_FC_MEM_POOL_MAX_SIZE
+#define FC_HEAP_CACHE_COUNT CONFIG_FS_LITTLEFS_FC_MEM_POOL_NUM_BLOCKS
+#else
 BUILD_ASSERT(CONFIG_FS_LITTLEFS_CACHE_SIZE >= 4);
-#define CONFIG_FS_LITTLEFS_FC_MEM_POOL_MIN_SIZE 4
-#define CONFIG_FS_LITTLEFS_FC_MEM_POOL_MAX_SIZE CONFIG_FS_LITTLEFS_CACHE_SIZE
-#define CONFIG_FS_LITTLEFS_FC_MEM_POOL_NUM_BLOCKS CONFIG_FS_LITTLEFS_NUM_FILES
+#define FC_HEAP_CACHE_SIZE CONFIG_FS_LITTLEFS_CACHE_SIZE
+#define FC_HEAP_CACHE_COUNT CONFIG_FS_LITTLEFS_NUM_FILES
 #endif
 
-K_MEM_POOL_DEFINE(file_cache_pool,
-		  CONFIG_FS_LITTLEFS_FC_MEM_POOL_MIN_SIZE,
-		  CONFIG_FS_LITTLEFS_FC_MEM_POOL_MAX_SIZE,
-		  CONFIG_FS_LITTLEFS_FC_MEM_POOL_NUM_BLOCKS, 4);
+/* The heap is managed in chunks of 8 bytes.  Its memory is aligned up to a
+ * chunk, and starts with the heap state followed by one free list bucket of
+ * two words per bit of the heap size in chunks: 15 bits for a heap below
+ * 256 KiB on 32-bit targets, 31 bits otherwise.  Each allocation is
+ * prefixed with a chunk header of at most 8 bytes and rounded up to chunks.
+ */
+#define FC_HEAP_CHUNK 8
+#define FC_HEAP_CHUNK_HEADER 8
+
+#define FC_HEAP_ALLOC_SIZE(bytes) \
+	ROUND_UP((bytes) + FC_HEAP_CHUNK_HEADER, FC_HEAP_CHUNK)
+#define FC_HEAP_CACHES_SIZE \
+	(FC_HEAP_CACHE_COUNT * FC_HEAP_ALLOC_SIZE(FC_HEAP_CACHE_SIZE))
+
+#define FC_HEAP_BUCKETS \
+	((sizeof(size_t) == 4 && FC_HEAP_CACHES_SIZE < KB(255)) ? 15 : 31)
+#define FC_HEAP_STATE_SIZE						\
+	(ROUND_UP(2 * sizeof(void *) + 4 * sizeof(uint32_t), FC_HEAP_CHUNK) + \
+	 ROUND_UP(FC_HEAP_BUCKETS * 2 * sizeof(size_t), FC_HEAP_CHUNK))
+
+#define FC_HEAP_SIZE \
+	(FC_HEAP_CHUNK + FC_HEAP_STATE_SIZE + FC_HEAP_CACHES_SIZE)
+#endif
+
+/* File caches are allocated with the cache size of each mount, from a
+ * heap shared by all the mounts.  The limit on open files is global
+ * (FS_LITTLEFS_NUM_FILES), so an arena per mount would have to reserve
+ * caches for all of them on each mount.
+ */
+K_HEAP_DEFINE(file_cache_heap, FC_HEAP_SIZE);
 
 static inline void fs_lock(struct fs_littlefs *fs)
 {
@@ -173,8 +204,8 @@ static void release_file_data(struct fs_file_t *fp)
 {
 	struct lfs_file_data *fdp = fp->filep;
 
-	if (fdp->config.buffer) {
-		k_mem_pool_free(&fdp->cache_block);
+	if (fdp->cache_block) {
+		k_heap_free(&file_cache_heap, fdp->cache_block);
 	}
 
 	k_mem_slab_free(&file_data_pool, &fp->filep);
@@ -197,14 +228,16 @@ static int littlefs_open(struct fs_file_t *fp, const char *path)
 
 	memset(fdp, 0, sizeof(*fdp));
 
-	ret = k_mem_pool_alloc(&file_cache_pool, &fdp->cache_block,
-			       lfs->cfg->cache_size, K_NO_WAIT);
-	LOG_DBG("alloc %u file cache: %d", lfs->cfg->cache_size, ret);
-	if (ret != 0) {
+	fdp->cache_block = k_heap_alloc(&file_cache_heap, lfs->cfg->cache_size,
+					K_NO_WAIT);
+	LOG_DBG("alloc %u file cache: %p", lfs->cfg->cache_size,
+		fdp->cache_block);
+	if (fdp->cache_block == NULL) {
+		ret = LFS_ERR_NOMEM;
 		goto out;
 	}
 
-	fdp->config.buffer = fdp->cache_block.data;
+	fdp->config.buffer = fdp->cache_block;
 	path = fs_impl_strip_prefix(path, fp->mp);
 
 	fs_lock(fs);
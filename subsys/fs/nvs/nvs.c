@@ -6,6 +6,7 @@
  */
 
 #include <drivers/flash.h>
+#include <init.h>
 #include <string.h>
 #include <errno.h>
 #include <inttypes.h>
@@ -287,6 +288,134 @@ static int nvs_ate_cmp_const(const struct nvs_ate *entry, uint8_t value)
 	return 0;
 }
 
+/* lookup cache routines */
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+
+BUILD_ASSERT((CONFIG_NVS_LOOKUP_CACHE_SIZE &
+	      (CONFIG_NVS_LOOKUP_CACHE_SIZE - 1)) == 0,
+	     "Lookup cache size must be a power of two");
+
+static void nvs_lookup_cache_clear(struct nvs_fs *fs)
+{
+	(void)memset(fs->lookup_cache_addr, 0xff,
+		     sizeof(fs->lookup_cache_addr));
+	fs->lookup_cache_full = false;
+}
+
+/* find the slot of id in the lookup cache using linear probing, a new slot
+ * is taken if insert is true. returns the slot, -ENOENT if not found.
+ */
+static int nvs_lookup_cache_slot(struct nvs_fs *fs, uint16_t id, bool insert)
+{
+	uint32_t pos;
+	int i;
+
+	/* multiplicative hash, the high bits depend on all the id bits */
+	pos = ((id * 0x9E3779B1U) >> 16) & (CONFIG_NVS_LOOKUP_CACHE_SIZE - 1);
+
+	for (i = 0; i < CONFIG_NVS_LOOKUP_CACHE_SIZE; i++) {
+		if (fs->lookup_cache_addr[pos] == NVS_LOOKUP_CACHE_EMPTY) {
+			if (!insert) {
+				return -ENOENT;
+			}
+			fs->lookup_cache_id[pos] = id;
+			fs->lookup_cache_addr[pos] = NVS_LOOKUP_CACHE_NO_ADDR;
+			return pos;
+		}
+		if (fs->lookup_cache_id[pos] == id) {
+			return pos;
+		}
+		pos = (pos + 1) & (CONFIG_NVS_LOOKUP_CACHE_SIZE - 1);
+	}
+
+	if (insert && !fs->lookup_cache_full) {
+		/* from now on ids missing from the cache can be in flash */
+		LOG_WRN("Lookup cache full, id %d is not cached", id);
+		fs->lookup_cache_full = true;
+	}
+	return -ENOENT;
+}
+
+/* nvs_lookup_cache_find updates addr to the latest ate of id, a walk
+ * starting from there finds it with one read. addr is not modified if id
+ * is not in the cache. returns 0 if the entry can exist, -ENOENT if there
+ * is no entry with id in flash.
+ */
+static int nvs_lookup_cache_find(struct nvs_fs *fs, uint16_t id,
+				 uint32_t *addr)
+{
+	int slot;
+
+	slot = nvs_lookup_cache_slot(fs, id, false);
+	if (slot < 0) {
+		return fs->lookup_cache_full ? 0 : -ENOENT;
+	}
+
+	if (fs->lookup_cache_addr[slot] == NVS_LOOKUP_CACHE_NO_ADDR) {
+		return -ENOENT;
+	}
+
+	*addr = fs->lookup_cache_addr[slot];
+	return 0;
+}
+
+/* set the latest ate address of id */
+static void nvs_lookup_cache_update(struct nvs_fs *fs, uint16_t id,
+				    uint32_t addr)
+{
+	int slot;
+
+	slot = nvs_lookup_cache_slot(fs, id, true);
+	if (slot >= 0) {
+		fs->lookup_cache_addr[slot] = addr;
+	}
+}
+
+/* forget the addresses in an erased sector. the ids stay in the cache as
+ * the entries still pointing to the sector were deleted entries.
+ */
+static void nvs_lookup_cache_invalidate(struct nvs_fs *fs, uint32_t addr)
+{
+	uint32_t cache_addr;
+	int i;
+
+	addr &= ADDR_SECT_MASK;
+
+	for (i = 0; i < CONFIG_NVS_LOOKUP_CACHE_SIZE; i++) {
+		cache_addr = fs->lookup_cache_addr[i];
+		if (cache_addr != NVS_LOOKUP_CACHE_EMPTY &&
+		    cache_addr != NVS_LOOKUP_CACHE_NO_ADDR &&
+		    (cache_addr & ADDR_SECT_MASK) == addr) {
+			fs->lookup_cache_addr[i] = NVS_LOOKUP_CACHE_NO_ADDR;
+		}
+	}
+}
+
+#else
+
+static inline void nvs_lookup_cache_clear(struct nvs_fs *fs)
+{
+}
+
+static inline int nvs_lookup_cache_find(struct nvs_fs *fs, uint16_t id,
+					uint32_t *addr)
+{
+	return 0;
+}
+
+static inline void nvs_lookup_cache_update(struct nvs_fs *fs, uint16_t id,
+					   uint32_t addr)
+{
+}
+
+static inline void nvs_lookup_cache_invalidate(struct nvs_fs *fs,
+					       uint32_t addr)
+{
+}
+
+#endif /* CONFIG_NVS_LOOKUP_CACHE */
+/* end of lookup cache routines */
+
 /* store an entry in flash */
 static int nvs_flash_wrt_entry(struct nvs_fs *fs, uint16_t id, const void *data,
 				size_t len)
@@ -294,6 +423,7 @@ static int nvs_flash_wrt_entry(struct nvs_fs *fs, uint16_t id, const void *data,
 	int rc;
 	struct nvs_ate entry;
 	size_t ate_size;
+	uint32_t ate_addr;
 
 	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
 
@@ -308,11 +438,14 @@ static int nvs_flash_wrt_entry(struct nvs_fs *fs, uint16_t id, const void *data,
 	if (rc) {
 		return rc;
 	}
+	ate_addr = fs->ate_wra;
 	rc = nvs_flash_ate_wrt(fs, &entry);
 	if (rc) {
 		return rc;
 	}
 
+	nvs_lookup_cache_update(fs, id, ate_addr);
+
 	return 0;
 }
 /* end of flash routines */
@@ -444,7 +577,7 @@ static int nvs_gc(struct nvs_fs *fs)
 	int rc;
 	struct nvs_ate close_ate, gc_ate, wlk_ate;
 	uint32_t sec_addr, gc_addr, gc_prev_addr, wlk_addr, wlk_prev_addr,
-	      data_addr, stop_addr;
+	      data_addr, stop_addr, ate_addr;
 	size_t ate_size;
 
 	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
@@ -466,6 +599,7 @@ static int nvs_gc(struct nvs_fs *fs)
 		if (rc) {
 			return rc;
 		}
+		nvs_lookup_cache_invalidate(fs, sec_addr);
 		return 0;
 	}
 
@@ -515,10 +649,13 @@ static int nvs_gc(struct nvs_fs *fs)
 				return rc;
 			}
 
+			ate_addr = fs->ate_wra;
 			rc = nvs_flash_ate_wrt(fs, &gc_ate);
 			if (rc) {
 				return rc;
 			}
+
+			nvs_lookup_cache_update(fs, gc_ate.id, ate_addr);
 		}
 
 		/* stop gc at end of the sector */
@@ -531,9 +668,137 @@ static int nvs_gc(struct nvs_fs *fs)
 	if (rc) {
 		return rc;
 	}
+	nvs_lookup_cache_invalidate(fs, sec_addr);
 	return 0;
 }
 
+/* background garbage collection routines */
+#ifdef CONFIG_NVS_BACKGROUND_GC
+
+K_THREAD_STACK_DEFINE(nvs_gc_stack, CONFIG_NVS_BACKGROUND_GC_STACK_SIZE);
+static struct k_work_q nvs_gc_work_q;
+
+static inline bool nvs_bg_gc_needed(struct nvs_fs *fs)
+{
+	return (fs->ate_wra - fs->data_wra) < CONFIG_NVS_BACKGROUND_GC_THRESHOLD;
+}
+
+/* close the write sector ahead of time and gc the next one, the writes
+ * then find an empty sector with the live data already copied to it.
+ */
+static void nvs_bg_gc_handler(struct k_work *work)
+{
+	struct nvs_fs *fs = CONTAINER_OF(work, struct nvs_fs, gc_work);
+	int rc;
+
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
+	if (!fs->ready || fs->gc_stalled || !nvs_bg_gc_needed(fs)) {
+		goto end;
+	}
+
+	rc = nvs_sector_close(fs);
+	if (!rc) {
+		rc = nvs_gc(fs);
+	}
+
+	if (rc) {
+		LOG_ERR("Background gc failed (%d)", rc);
+		goto end;
+	}
+
+	/* the live data nearly fills a sector, doing the gc again would
+	 * only wear the flash.
+	 */
+	if (nvs_bg_gc_needed(fs)) {
+		fs->gc_stalled = true;
+	}
+
+end:
+	k_mutex_unlock(&fs->nvs_lock);
+	k_sem_give(&fs->gc_idle);
+}
+
+/* called with nvs_lock held after a write */
+static void nvs_bg_gc_check(struct nvs_fs *fs)
+{
+	/* gc_idle is taken while the work is queued or running */
+	if (!fs->gc_stalled && nvs_bg_gc_needed(fs) &&
+	    k_sem_take(&fs->gc_idle, K_NO_WAIT) == 0) {
+		k_work_submit_to_queue(&nvs_gc_work_q, &fs->gc_work);
+	}
+}
+
+/* wait until the background gc of the filesystem is done, if any */
+static void nvs_bg_gc_wait(struct nvs_fs *fs)
+{
+	(void)k_sem_take(&fs->gc_idle, K_FOREVER);
+	k_sem_give(&fs->gc_idle);
+}
+
+static int nvs_bg_gc_init(struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	k_work_q_start(&nvs_gc_work_q, nvs_gc_stack,
+		       K_THREAD_STACK_SIZEOF(nvs_gc_stack),
+		       K_PRIO_PREEMPT(CONFIG_NVS_BACKGROUND_GC_PRIORITY));
+	k_thread_name_set(&nvs_gc_work_q.thread, "nvs_gc");
+
+	return 0;
+}
+
+SYS_INIT(nvs_bg_gc_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+#else
+
+static inline void nvs_bg_gc_check(struct nvs_fs *fs)
+{
+}
+
+static inline void nvs_bg_gc_wait(struct nvs_fs *fs)
+{
+}
+
+#endif /* CONFIG_NVS_BACKGROUND_GC */
+/* end of background garbage collection routines */
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+/* fill the lookup cache walking through all the ate's, the first one found
+ * for each id is the latest.
+ */
+static int nvs_lookup_cache_rebuild(struct nvs_fs *fs)
+{
+	int rc, slot;
+	struct nvs_ate wlk_ate;
+	uint32_t wlk_addr, rd_addr;
+
+	nvs_lookup_cache_clear(fs);
+
+	wlk_addr = fs->ate_wra;
+
+	while (1) {
+		rd_addr = wlk_addr;
+		rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
+		if (rc) {
+			return rc;
+		}
+		if (!nvs_ate_crc8_check(&wlk_ate)) {
+			slot = nvs_lookup_cache_slot(fs, wlk_ate.id, true);
+			if (slot >= 0 && fs->lookup_cache_addr[slot] ==
+					 NVS_LOOKUP_CACHE_NO_ADDR) {
+				fs->lookup_cache_addr[slot] = rd_addr;
+			}
+		}
+		if (wlk_addr == fs->ate_wra) {
+			break;
+		}
+	}
+
+	return 0;
+}
+#endif
+
 static int nvs_startup(struct nvs_fs *fs)
 {
 	int rc;
@@ -548,6 +813,8 @@ static int nvs_startup(struct nvs_fs *fs)
 
 	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
 
+	nvs_lookup_cache_clear(fs);
+
 	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
 	/* step through the sectors to find a open sector following
 	 * a closed sector, this is where NVS can to write.
@@ -666,6 +933,10 @@ static int nvs_startup(struct nvs_fs *fs)
 		}
 	}
 
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	rc = nvs_lookup_cache_rebuild(fs);
+#endif
+
 end:
 	k_mutex_unlock(&fs->nvs_lock);
 	return rc;
@@ -681,6 +952,8 @@ int nvs_clear(struct nvs_fs *fs)
 		return -EACCES;
 	}
 
+	nvs_bg_gc_wait(fs);
+
 	for (uint16_t i = 0; i < fs->sector_count; i++) {
 		addr = i << ADDR_SECT_SHIFT;
 		rc = nvs_flash_erase_sector(fs, addr);
@@ -688,6 +961,7 @@ int nvs_clear(struct nvs_fs *fs)
 			return rc;
 		}
 	}
+	nvs_lookup_cache_clear(fs);
 	return 0;
 }
 
@@ -698,7 +972,20 @@ int nvs_init(struct nvs_fs *fs, const char *dev_name)
 	struct flash_pages_info info;
 	size_t write_block_size;
 
+	/* the background gc of a previous init must not run while the
+	 * filesystem is initialized again.
+	 */
+	if (fs->ready) {
+		nvs_bg_gc_wait(fs);
+		fs->ready = false;
+	}
+
 	k_mutex_init(&fs->nvs_lock);
+#ifdef CONFIG_NVS_BACKGROUND_GC
+	k_work_init(&fs->gc_work, nvs_bg_gc_handler);
+	k_sem_init(&fs->gc_idle, 1, 1);
+	fs->gc_stalled = false;
+#endif
 
 	fs->flash_device = device_get_binding(dev_name);
 	if (!fs->flash_device) {
@@ -781,7 +1068,12 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 	wlk_addr = fs->ate_wra;
 	rd_addr = wlk_addr;
 
-	while (1) {
+	/* the lookup cache knows when there is no entry, or lets the walk
+	 * start from the latest one.
+	 */
+	rc = nvs_lookup_cache_find(fs, id, &wlk_addr);
+
+	while (!rc) {
 		rd_addr = wlk_addr;
 		rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
 		if (rc) {
@@ -848,6 +1140,7 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 			if (rc) {
 				goto end;
 			}
+			nvs_bg_gc_check(fs);
 			break;
 		}
 
@@ -861,6 +1154,10 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		if (rc) {
 			goto end;
 		}
+#ifdef CONFIG_NVS_BACKGROUND_GC
+		/* a full sector was collected, worth trying again */
+		fs->gc_stalled = false;
+#endif
 		gc_count++;
 	}
 	rc = len;
@@ -899,6 +1196,11 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 	wlk_addr = fs->ate_wra;
 	rd_addr = wlk_addr;
 
+	rc = nvs_lookup_cache_find(fs, id, &wlk_addr);
+	if (rc) {
+		return rc;
+	}
+
 	while (cnt_his <= cnt) {
 		rd_addr = wlk_addr;
 		rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
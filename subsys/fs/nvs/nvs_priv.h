@@ -28,6 +28,12 @@ extern "C" {
 
 #define NVS_BLOCK_SIZE 32
 
+/*
+ * Special addresses in the lookup cache
+ */
+#define NVS_LOOKUP_CACHE_EMPTY 0xFFFFFFFF	/* slot is not used */
+#define NVS_LOOKUP_CACHE_NO_ADDR 0xFFFFFFFE	/* id has no entry in flash */
+
 /* Allocation Table Entry */
 struct nvs_ate {
 	uint16_t id;	/* data id */
@@ -27,7 +27,7 @@ LOG_MODULE_REGISTER(net_http, CONFIG_NET_HTTP_LOG_LEVEL);
 #include "net_private.h"
 
 #define HTTP_CONTENT_LEN_SIZE 6
-#define MAX_SEND_BUF_LEN 192
+#define MAX_SEND_BUF_LEN CONFIG_HTTP_CLIENT_SEND_BUF_LEN
 
 static ssize_t sendall(int sock, const void *buf, size_t len)
 {
@@ -53,6 +53,7 @@ static int http_send_data(int sock, char *send_buf,
 	va_list va;
 	int ret, end_of_send = *send_buf_pos;
 	int end_of_data, remaining_len;
+	int total = 0;
 
 	va_start(va, send_buf_pos);
 
@@ -75,6 +76,7 @@ static int http_send_data(int sock, char *send_buf,
 				end_of_send += to_be_copied;
 				end_of_data += to_be_copied;
 				remaining_len -= to_be_copied;
+				total += to_be_copied;
 
 				LOG_HEXDUMP_DBG(send_buf, end_of_send,
 						"Data to send");
@@ -93,6 +95,7 @@ static int http_send_data(int sock, char *send_buf,
 					data + end_of_data,
 					remaining_len);
 				end_of_send += remaining_len;
+				total += remaining_len;
 				remaining_len = 0;
 			}
 		} while (remaining_len > 0);
@@ -110,7 +113,7 @@ static int http_send_data(int sock, char *send_buf,
 
 	*send_buf_pos = end_of_send;
 
-	return end_of_send;
+	return total;
 
 err:
 	va_end(va);
@@ -251,6 +254,13 @@ static int on_body(struct http_parser *parser, const char *at, size_t length)
 						struct http_request,
 						internal.parser);
 
+	/* The body of a server error is read to keep the connection in sync
+	 * but not passed to the application.
+	 */
+	if (parser->status_code >= 500 && parser->status_code < 600) {
+		return 0;
+	}
+
 	req->internal.response.body_found = 1;
 	req->internal.response.processed += length;
 
@@ -303,23 +313,16 @@ static int on_headers_complete(struct http_parser *parser)
 		req->internal.response.http_cb->on_headers_complete(parser);
 	}
 
-	if (parser->status_code >= 500 && parser->status_code < 600) {
-		NET_DBG("Status %d, skipping body", parser->status_code);
-		return 1;
-	}
-
-	if ((req->method == HTTP_HEAD || req->method == HTTP_OPTIONS) &&
+	/* Only the body of a HEAD response is announced but not sent. Any
+	 * other body is read by the parser, otherwise its data would be taken
+	 * for the start of the next response on the connection.
+	 */
+	if (req->method == HTTP_HEAD &&
 	    req->internal.response.content_length > 0) {
 		NET_DBG("No body expected");
 		return 1;
 	}
 
-	if ((req->method == HTTP_PUT || req->method == HTTP_POST) &&
-	    req->internal.response.content_length == 0) {
-		NET_DBG("No body expected");
-		return 1;
-	}
-
 	NET_DBG("Headers complete");
 
 	return 0;
@@ -357,6 +360,12 @@ static int on_message_complete(struct http_parser *parser)
 		http_method_str(req->method));
 
 	req->internal.response.message_complete = 1;
+	req->internal.response.keep_alive = http_should_keep_alive(parser);
+
+	/* Stop parsing here so that any data after this response is left
+	 * for the next pipelined request on the same connection.
+	 */
+	http_parser_pause(parser, 1);
 
 	if (req->internal.response.cb) {
 		req->internal.response.cb(&req->internal.response,
@@ -412,11 +421,88 @@ static void http_client_init_parser(struct http_parser *parser,
 	settings->on_url = on_url;
 }
 
-static int http_wait_data(int sock, struct http_request *req)
+static int http_parse_data(struct http_request *req, const uint8_t *data,
+			   size_t len)
+{
+	size_t parsed;
+
+	parsed = http_parser_execute(&req->internal.parser,
+				     &req->internal.parser_settings,
+				     data, len);
+
+	if (HTTP_PARSER_ERRNO(&req->internal.parser) != HPE_OK &&
+	    HTTP_PARSER_ERRNO(&req->internal.parser) != HPE_PAUSED) {
+		NET_DBG("HTTP parse error %s",
+			http_errno_name(HTTP_PARSER_ERRNO(
+						&req->internal.parser)));
+		return -EBADMSG;
+	}
+
+	return parsed;
+}
+
+/* Feed the data that was received together with the previous response on
+ * a pipelined connection to the parser of this request. When returning, the
+ * pending pointer and length describe the data that belongs to the next
+ * response, if any.
+ */
+static int http_parse_pending(struct http_request *req,
+			      const uint8_t **pending, size_t *pending_len)
+{
+	uint8_t *recv_buf = req->internal.response.recv_buf;
+	size_t recv_buf_len = req->internal.response.recv_buf_len;
+	int total_received = 0;
+	size_t len;
+	int parsed;
+
+	while (*pending_len > 0 &&
+	       !req->internal.response.message_complete) {
+		len = MIN(*pending_len, recv_buf_len);
+
+		memmove(recv_buf, *pending, len);
+
+		/* If the data was already in this buffer, it has now been
+		 * moved to the start of it.
+		 */
+		if (*pending >= recv_buf && *pending < recv_buf + recv_buf_len) {
+			*pending = recv_buf;
+		}
+
+		req->internal.response.data_len += len;
+
+		parsed = http_parse_data(req, recv_buf, len);
+		if (parsed < 0) {
+			return parsed;
+		}
+
+		total_received += parsed;
+		*pending += parsed;
+		*pending_len -= parsed;
+	}
+
+	return total_received;
+}
+
+static int http_wait_data(int sock, struct http_request *req,
+			  const uint8_t **pending, size_t *pending_len)
 {
 	int total_received = 0;
 	size_t offset = 0;
 	int received, ret;
+	int parsed = 0;
+
+	if (*pending_len > 0) {
+		ret = http_parse_pending(req, pending, pending_len);
+		if (ret < 0) {
+			return ret;
+		}
+
+		total_received += ret;
+
+		if (req->internal.response.message_complete) {
+			return total_received;
+		}
+	}
 
 	do {
 		received = recv(sock, req->internal.response.recv_buf + offset,
@@ -435,25 +521,35 @@ static int http_wait_data(int sock, struct http_request *req)
 		} else {
 			req->internal.response.data_len += received;
 
-			(void)http_parser_execute(
-				&req->internal.parser,
-				&req->internal.parser_settings,
-				req->internal.response.recv_buf + offset,
+			parsed = http_parse_data(
+				req, req->internal.response.recv_buf + offset,
 				received);
+			if (parsed < 0) {
+				ret = parsed;
+				break;
+			}
 		}
 
 		total_received += received;
-		offset += received;
-
-		if (offset >= req->internal.response.recv_buf_len) {
-			offset = 0;
-		}
 
 		if (req->internal.response.message_complete) {
+			/* The data after the end of this response belongs to
+			 * the next one.
+			 */
+			*pending = req->internal.response.recv_buf + offset +
+				   parsed;
+			*pending_len = received - parsed;
+
 			ret = total_received;
 			break;
 		}
 
+		offset += received;
+
+		if (offset >= req->internal.response.recv_buf_len) {
+			offset = 0;
+		}
+
 	} while (true);
 
 	return ret;
@@ -467,22 +563,33 @@ static void http_timeout(struct k_work *work)
 	(void)close(data->sock);
 }
 
-int http_client_req(int sock, struct http_request *req,
-		    int32_t timeout, void *user_data)
+static void http_start_timeout(struct http_request *req)
 {
-	/* Utilize the network usage by sending data in bigger blocks */
-	char send_buf[MAX_SEND_BUF_LEN];
-	const size_t send_buf_max_len = sizeof(send_buf);
-	size_t send_buf_pos = 0;
-	int total_sent = 0;
-	int ret, total_recv, i;
-	const char *method;
+	if (!K_TIMEOUT_EQ(req->internal.timeout, K_FOREVER) &&
+	    !K_TIMEOUT_EQ(req->internal.timeout, K_NO_WAIT)) {
+		k_delayed_work_init(&req->internal.work, http_timeout);
+		(void)k_delayed_work_submit(&req->internal.work,
+					    req->internal.timeout);
+	}
+}
 
-	if (sock < 0 || req == NULL || req->response == NULL ||
-	    req->recv_buf == NULL || req->recv_buf_len == 0) {
-		return -EINVAL;
+static void http_stop_timeout(struct http_request *req)
+{
+	if (!K_TIMEOUT_EQ(req->internal.timeout, K_FOREVER) &&
+	    !K_TIMEOUT_EQ(req->internal.timeout, K_NO_WAIT)) {
+		(void)k_delayed_work_cancel(&req->internal.work);
 	}
+}
+
+static bool http_req_is_valid(struct http_request *req)
+{
+	return req != NULL && req->response != NULL &&
+	       req->recv_buf != NULL && req->recv_buf_len > 0;
+}
 
+static void http_req_init(int sock, struct http_request *req,
+			  int32_t timeout, void *user_data)
+{
 	memset(&req->internal.response, 0, sizeof(req->internal.response));
 
 	req->internal.response.http_cb = req->http_cb;
@@ -493,9 +600,26 @@ int http_client_req(int sock, struct http_request *req,
 	req->internal.sock = sock;
 	req->internal.timeout = SYS_TIMEOUT_MS(timeout);
 
+	http_client_init_parser(&req->internal.parser,
+				&req->internal.parser_settings);
+}
+
+/* Place the request into the send buffer. The buffer is flushed only when it
+ * gets full, or before the data that the user callbacks send directly to the
+ * socket, so that the headers (and a small payload) of the request, or of
+ * several pipelined requests, are sent in as few segments as possible.
+ */
+static int http_send_request(int sock, struct http_request *req,
+			     char *send_buf, size_t send_buf_max_len,
+			     size_t *send_buf_pos, void *user_data)
+{
+	int total_sent = 0;
+	int ret, i;
+	const char *method;
+
 	method = http_method_str(req->method);
 
-	ret = http_send_data(sock, send_buf, send_buf_max_len, &send_buf_pos,
+	ret = http_send_data(sock, send_buf, send_buf_max_len, send_buf_pos,
 			     method, " ", req->url, " ", req->protocol,
 			     HTTP_CRLF, NULL);
 	if (ret < 0) {
@@ -506,7 +630,7 @@ int http_client_req(int sock, struct http_request *req,
 
 	if (req->port) {
 		ret = http_send_data(sock, send_buf, send_buf_max_len,
-				     &send_buf_pos, "Host", ": ", req->host,
+				     send_buf_pos, "Host", ": ", req->host,
 				     ":", req->port, HTTP_CRLF, NULL);
 
 		if (ret < 0) {
@@ -516,7 +640,7 @@ int http_client_req(int sock, struct http_request *req,
 		total_sent += ret;
 	} else {
 		ret = http_send_data(sock, send_buf, send_buf_max_len,
-				     &send_buf_pos, "Host", ": ", req->host,
+				     send_buf_pos, "Host", ": ", req->host,
 				     HTTP_CRLF, NULL);
 
 		if (ret < 0) {
@@ -527,13 +651,12 @@ int http_client_req(int sock, struct http_request *req,
 	}
 
 	if (req->optional_headers_cb) {
-		ret = http_flush_data(sock, send_buf, send_buf_pos);
+		ret = http_flush_data(sock, send_buf, *send_buf_pos);
 		if (ret < 0) {
 			goto out;
 		}
 
-		send_buf_pos = 0;
-		total_sent += ret;
+		*send_buf_pos = 0;
 
 		ret = req->optional_headers_cb(sock, req, user_data);
 		if (ret < 0) {
@@ -545,7 +668,7 @@ int http_client_req(int sock, struct http_request *req,
 		for (i = 0; req->optional_headers && req->optional_headers[i];
 		     i++) {
 			ret = http_send_data(sock, send_buf, send_buf_max_len,
-					     &send_buf_pos,
+					     send_buf_pos,
 					     req->optional_headers[i], NULL);
 			if (ret < 0) {
 				goto out;
@@ -557,7 +680,7 @@ int http_client_req(int sock, struct http_request *req,
 
 	for (i = 0; req->header_fields && req->header_fields[i]; i++) {
 		ret = http_send_data(sock, send_buf, send_buf_max_len,
-				     &send_buf_pos, req->header_fields[i],
+				     send_buf_pos, req->header_fields[i],
 				     NULL);
 		if (ret < 0) {
 			goto out;
@@ -568,7 +691,7 @@ int http_client_req(int sock, struct http_request *req,
 
 	if (req->content_type_value) {
 		ret = http_send_data(sock, send_buf, send_buf_max_len,
-				     &send_buf_pos, "Content-Type", ": ",
+				     send_buf_pos, "Content-Type", ": ",
 				     req->content_type_value, HTTP_CRLF, NULL);
 		if (ret < 0) {
 			goto out;
@@ -589,12 +712,12 @@ int http_client_req(int sock, struct http_request *req,
 			}
 
 			ret = http_send_data(sock, send_buf, send_buf_max_len,
-					     &send_buf_pos, "Content-Length", ": ",
+					     send_buf_pos, "Content-Length", ": ",
 					     content_len_str, HTTP_CRLF,
 					     HTTP_CRLF, NULL);
 		} else {
 			ret = http_send_data(sock, send_buf, send_buf_max_len,
-				     &send_buf_pos, HTTP_CRLF, NULL);
+				     send_buf_pos, HTTP_CRLF, NULL);
 		}
 
 		if (ret < 0) {
@@ -603,15 +726,14 @@ int http_client_req(int sock, struct http_request *req,
 
 		total_sent += ret;
 
-		ret = http_flush_data(sock, send_buf, send_buf_pos);
-		if (ret < 0) {
-			goto out;
-		}
+		if (req->payload_cb) {
+			ret = http_flush_data(sock, send_buf, *send_buf_pos);
+			if (ret < 0) {
+				goto out;
+			}
 
-		send_buf_pos = 0;
-		total_sent += ret;
+			*send_buf_pos = 0;
 
-		if (req->payload_cb) {
 			ret = req->payload_cb(sock, req, user_data);
 			if (ret < 0) {
 				goto out;
@@ -627,57 +749,176 @@ int http_client_req(int sock, struct http_request *req,
 				length = req->payload_len;
 			}
 
-			ret = sendall(sock, req->payload, length);
-			if (ret < 0) {
-				goto out;
+			if (length <= send_buf_max_len - *send_buf_pos) {
+				/* Small payload is sent together with
+				 * the headers.
+				 */
+				memcpy(send_buf + *send_buf_pos, req->payload,
+				       length);
+				*send_buf_pos += length;
+			} else {
+				ret = http_flush_data(sock, send_buf,
+						      *send_buf_pos);
+				if (ret < 0) {
+					goto out;
+				}
+
+				*send_buf_pos = 0;
+
+				ret = sendall(sock, req->payload, length);
+				if (ret < 0) {
+					goto out;
+				}
 			}
 
 			total_sent += length;
 		}
 	} else {
 		ret = http_send_data(sock, send_buf, send_buf_max_len,
-				     &send_buf_pos, HTTP_CRLF, NULL);
+				     send_buf_pos, HTTP_CRLF, NULL);
 		if (ret < 0) {
 			goto out;
 		}
+
+		total_sent += ret;
+	}
+
+	return total_sent;
+
+out:
+	return ret;
+}
+
+int http_client_req(int sock, struct http_request *req,
+		    int32_t timeout, void *user_data)
+{
+	/* Utilize the network usage by sending data in bigger blocks */
+	char send_buf[MAX_SEND_BUF_LEN];
+	const size_t send_buf_max_len = sizeof(send_buf);
+	size_t send_buf_pos = 0;
+	const uint8_t *pending = NULL;
+	size_t pending_len = 0;
+	int total_sent;
+	int ret, total_recv;
+
+	if (sock < 0 || !http_req_is_valid(req)) {
+		return -EINVAL;
+	}
+
+	http_req_init(sock, req, timeout, user_data);
+
+	total_sent = http_send_request(sock, req, send_buf, send_buf_max_len,
+				       &send_buf_pos, user_data);
+	if (total_sent < 0) {
+		return total_sent;
 	}
 
 	if (send_buf_pos > 0) {
 		ret = http_flush_data(sock, send_buf, send_buf_pos);
 		if (ret < 0) {
-			goto out;
+			return ret;
 		}
-
-		total_sent += ret;
 	}
 
 	NET_DBG("Sent %d bytes", total_sent);
 
-	http_client_init_parser(&req->internal.parser,
-				&req->internal.parser_settings);
-
-	if (!K_TIMEOUT_EQ(req->internal.timeout, K_FOREVER) &&
-	    !K_TIMEOUT_EQ(req->internal.timeout, K_NO_WAIT)) {
-		k_delayed_work_init(&req->internal.work, http_timeout);
-		(void)k_delayed_work_submit(&req->internal.work,
-					    req->internal.timeout);
-	}
+	http_start_timeout(req);
 
 	/* Request is sent, now wait data to be received */
-	total_recv = http_wait_data(sock, req);
+	total_recv = http_wait_data(sock, req, &pending, &pending_len);
 	if (total_recv < 0) {
 		NET_DBG("Wait data failure (%d)", total_recv);
 	} else {
 		NET_DBG("Received %d bytes", total_recv);
 	}
 
-	if (!K_TIMEOUT_EQ(req->internal.timeout, K_FOREVER) &&
-	    !K_TIMEOUT_EQ(req->internal.timeout, K_NO_WAIT)) {
-		(void)k_delayed_work_cancel(&req->internal.work);
+	if (pending_len > 0) {
+		NET_DBG("Dropping %zd bytes after the response", pending_len);
 	}
 
+	http_stop_timeout(req);
+
 	return total_sent;
+}
 
-out:
-	return ret;
+int http_client_req_pipeline(int sock, struct http_request **reqs,
+			     size_t count, int32_t timeout, void *user_data)
+{
+	char send_buf[MAX_SEND_BUF_LEN];
+	const size_t send_buf_max_len = sizeof(send_buf);
+	size_t send_buf_pos = 0;
+	const uint8_t *pending = NULL;
+	size_t pending_len = 0;
+	int completed = 0;
+	int ret = 0;
+	size_t i;
+
+	if (sock < 0 || reqs == NULL || count == 0) {
+		return -EINVAL;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (!http_req_is_valid(reqs[i])) {
+			return -EINVAL;
+		}
+	}
+
+	/* Send all the requests before waiting any of the responses */
+	for (i = 0; i < count; i++) {
+		http_req_init(sock, reqs[i], timeout, user_data);
+
+		ret = http_send_request(sock, reqs[i], send_buf,
+					send_buf_max_len, &send_buf_pos,
+					user_data);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	if (send_buf_pos > 0) {
+		ret = http_flush_data(sock, send_buf, send_buf_pos);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	NET_DBG("Sent %zd requests", count);
+
+	/* The timeout covers the whole pipeline */
+	http_start_timeout(reqs[0]);
+
+	/* The server returns the responses in the order the requests were
+	 * sent, so deliver them one by one to the matching request.
+	 */
+	for (i = 0; i < count; i++) {
+		ret = http_wait_data(sock, reqs[i], &pending, &pending_len);
+		if (ret < 0) {
+			NET_DBG("Wait data failure (%d)", ret);
+			break;
+		}
+
+		if (!reqs[i]->internal.response.message_complete) {
+			NET_DBG("Connection closed before response %zd", i);
+			break;
+		}
+
+		completed++;
+
+		if (!reqs[i]->internal.response.keep_alive) {
+			NET_DBG("Server is closing the connection");
+			break;
+		}
+	}
+
+	if (pending_len > 0) {
+		NET_DBG("Dropping %zd bytes after the responses", pending_len);
+	}
+
+	http_stop_timeout(reqs[0]);
+
+	if (completed == 0 && ret < 0) {
+		return ret;
+	}
+
+	return completed;
 }
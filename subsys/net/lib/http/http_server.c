@@ -0,0 +1,740 @@
+/** @file
+ * @brief HTTP server API
+ *
+ * A small event driven HTTP/1.1 server that serves all the connections
+ * from one thread.
+ */
+
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_http_server, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
+
+#include <kernel.h>
+#include <string.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdarg.h>
+
+#include <net/net_ip.h>
+#include <net/socket.h>
+#include <net/http_server.h>
+
+#include "net_private.h"
+
+BUILD_ASSERT(CONFIG_NET_SOCKETS_POLL_MAX >= CONFIG_HTTP_SERVER_MAX_CLIENTS + 1,
+	     "CONFIG_NET_SOCKETS_POLL_MAX is too small for the HTTP server");
+
+/* How often the stop request and idle connections are checked */
+#define POLL_TIMEOUT_MS 100
+
+/* Space reserved in front of the data for the chunk size line, and after
+ * it for the CRLF that ends the chunk.
+ */
+#define CHUNK_HDR_LEN 8
+#define CHUNK_TRAILER_LEN 2
+
+#define LAST_CHUNK "0" HTTP_CRLF HTTP_CRLF
+
+static const char *http_status_str(int status)
+{
+	switch (status) {
+	case 200:
+		return "OK";
+	case 400:
+		return "Bad Request";
+	case 404:
+		return "Not Found";
+	case 405:
+		return "Method Not Allowed";
+	case 414:
+		return "URI Too Long";
+	default:
+		break;
+	}
+
+	return "Internal Server Error";
+}
+
+static inline struct http_server_client *client_get(struct http_parser *parser)
+{
+	return CONTAINER_OF(parser, struct http_server_client, parser);
+}
+
+static int on_message_begin(struct http_parser *parser)
+{
+	struct http_server_client *client = client_get(parser);
+
+	client->url_len = 0;
+	client->req.url[0] = '\0';
+	client->status = 200;
+
+	return 0;
+}
+
+static int on_url(struct http_parser *parser, const char *at, size_t length)
+{
+	struct http_server_client *client = client_get(parser);
+
+	if (client->url_len + length >= sizeof(client->req.url)) {
+		client->status = 414;
+		return 0;
+	}
+
+	memcpy(&client->req.url[client->url_len], at, length);
+	client->url_len += length;
+	client->req.url[client->url_len] = '\0';
+
+	return 0;
+}
+
+static int on_message_complete(struct http_parser *parser)
+{
+	struct http_server_client *client = client_get(parser);
+
+	client->req.method = parser->method;
+	client->keep_alive = http_should_keep_alive(parser);
+	client->responding = 1;
+
+	/* Any pipelined request after this one is parsed only after the
+	 * response to this one is sent.
+	 */
+	http_parser_pause(parser, 1);
+
+	return 0;
+}
+
+static const struct http_server_resource *
+resource_find(struct http_server_ctx *ctx, const char *path)
+{
+	size_t i;
+
+	for (i = 0; i < ctx->resource_count; i++) {
+		if (strcmp(ctx->resources[i].path, path) == 0) {
+			return &ctx->resources[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void client_reset(struct http_server_client *client)
+{
+#if defined(CONFIG_FILE_SYSTEM)
+	if (client->file_open) {
+		(void)fs_close(&client->file);
+		client->file_open = 0;
+	}
+#endif
+
+	client->resource = NULL;
+	client->body_left = 0;
+	client->tx_len = 0;
+	client->tx_pos = 0;
+	client->responding = 0;
+	client->chunked = 0;
+	client->body_done = 0;
+	client->req.offset = 0;
+}
+
+static void client_close(struct http_server_ctx *ctx, int idx)
+{
+	struct http_server_client *client = &ctx->clients[idx];
+
+	NET_DBG("[%d] Closing connection (sock %d)", idx, client->sock);
+
+#if defined(CONFIG_FILE_SYSTEM)
+	if (client->file_open) {
+		(void)fs_close(&client->file);
+		client->file_open = 0;
+	}
+#endif
+
+	(void)zsock_close(client->sock);
+
+	client->sock = -1;
+	ctx->fds[idx + 1].fd = -1;
+	ctx->fds[idx + 1].events = 0;
+}
+
+static void server_accept(struct http_server_ctx *ctx)
+{
+	struct http_server_client *client;
+	int sock, i;
+
+	sock = zsock_accept(ctx->listen_sock, NULL, NULL);
+	if (sock < 0) {
+		NET_DBG("Accept failed (%d)", -errno);
+		return;
+	}
+
+	for (i = 0; i < ARRAY_SIZE(ctx->clients); i++) {
+		if (ctx->clients[i].sock < 0) {
+			break;
+		}
+	}
+
+	if (i == ARRAY_SIZE(ctx->clients)) {
+		NET_DBG("No free connection slots, dropping sock %d", sock);
+		(void)zsock_close(sock);
+		return;
+	}
+
+	client = &ctx->clients[i];
+
+	client_reset(client);
+	http_parser_init(&client->parser, HTTP_REQUEST);
+
+	client->sock = sock;
+	client->rx_len = 0;
+	client->rx_parsed = 0;
+	client->last_activity = k_uptime_get();
+
+	ctx->fds[i + 1].fd = sock;
+	ctx->fds[i + 1].events = ZSOCK_POLLIN;
+
+	NET_DBG("[%d] New connection (sock %d)", i, sock);
+}
+
+static void client_tx_printf(struct http_server_client *client,
+			     const char *fmt, ...)
+{
+	va_list ap;
+	int ret;
+
+	if (client->tx_len >= sizeof(client->tx_buf) - 1) {
+		return;
+	}
+
+	va_start(ap, fmt);
+	ret = vsnprintk((char *)client->tx_buf + client->tx_len,
+			sizeof(client->tx_buf) - client->tx_len, fmt, ap);
+	va_end(ap);
+
+	if (ret > 0) {
+		client->tx_len = MIN(client->tx_len + ret,
+				     sizeof(client->tx_buf) - 1);
+	}
+}
+
+static int client_open_resource(struct http_server_client *client)
+{
+	const struct http_server_resource *res = client->resource;
+
+	switch (res->type) {
+	case HTTP_RESOURCE_STATIC:
+		client->body_left = res->static_data.len;
+		return 0;
+
+#if defined(CONFIG_FILE_SYSTEM)
+	case HTTP_RESOURCE_FS: {
+		struct fs_dirent entry;
+		int ret;
+
+		ret = fs_stat(res->fs_path, &entry);
+		if (ret < 0) {
+			return ret;
+		}
+
+		/* An empty file has no body to read, so it is not opened */
+		if (entry.size == 0) {
+			client->body_left = 0;
+			client->body_done = 1;
+			return 0;
+		}
+
+		ret = fs_open(&client->file, res->fs_path);
+		if (ret < 0) {
+			return ret;
+		}
+
+		client->file_open = 1;
+		client->body_left = entry.size;
+		return 0;
+	}
+#endif
+
+	case HTTP_RESOURCE_DYNAMIC:
+		/* HTTP/1.0 clients do not understand chunked transfer coding,
+		 * so the end of the body is told to them by closing the
+		 * connection.
+		 */
+		if (client->parser.http_major == 1 &&
+		    client->parser.http_minor == 0) {
+			client->keep_alive = 0;
+		} else {
+			client->chunked = 1;
+		}
+
+		return 0;
+
+	default:
+		break;
+	}
+
+	return -ENOTSUP;
+}
+
+static void client_start_response(struct http_server_ctx *ctx, int idx)
+{
+	struct http_server_client *client = &ctx->clients[idx];
+	const char *content_type = "text/plain";
+	char *query;
+	int ret;
+
+	client_reset(client);
+	client->responding = 1;
+
+	query = strchr(client->req.url, '?');
+	if (query) {
+		*query++ = '\0';
+		client->req.query = query;
+	} else {
+		client->req.query = "";
+	}
+
+	NET_DBG("[%d] %s %s", idx, http_method_str(client->req.method),
+		log_strdup(client->req.url));
+
+	if (client->status == 200 && client->req.method != HTTP_GET &&
+	    client->req.method != HTTP_HEAD) {
+		client->status = 405;
+	}
+
+	if (client->status == 200) {
+		client->resource = resource_find(ctx, client->req.url);
+		if (client->resource == NULL) {
+			client->status = 404;
+		}
+	}
+
+	if (client->status == 200) {
+		ret = client_open_resource(client);
+		if (ret < 0) {
+			NET_DBG("[%d] Cannot open resource (%d)", idx, ret);
+			client->resource = NULL;
+			client->status = ret == -ENOENT ? 404 : 500;
+		}
+	}
+
+	if (client->status != 200) {
+		/* Error responses have a short text body */
+		client->body_left = strlen(http_status_str(client->status)) +
+				    sizeof(HTTP_CRLF) - 1;
+	} else if (client->resource->content_type) {
+		content_type = client->resource->content_type;
+	}
+
+	client_tx_printf(client, "HTTP/1.1 %d %s" HTTP_CRLF
+			 "Content-Type: %s" HTTP_CRLF,
+			 client->status, http_status_str(client->status),
+			 content_type);
+
+	if (client->chunked) {
+		client_tx_printf(client,
+				 "Transfer-Encoding: chunked" HTTP_CRLF);
+	} else if (client->resource == NULL ||
+		   client->resource->type != HTTP_RESOURCE_DYNAMIC) {
+		client_tx_printf(client, "Content-Length: %zu" HTTP_CRLF,
+				 client->body_left);
+	}
+
+	if (!client->keep_alive) {
+		client_tx_printf(client, "Connection: close" HTTP_CRLF);
+	} else if (client->parser.http_minor == 0) {
+		client_tx_printf(client, "Connection: keep-alive" HTTP_CRLF);
+	}
+
+	client_tx_printf(client, HTTP_CRLF);
+
+	if (client->status != 200) {
+		client_tx_printf(client, "%s" HTTP_CRLF,
+				 http_status_str(client->status));
+		client->body_left = 0;
+		client->body_done = 1;
+	}
+
+	if (client->req.method == HTTP_HEAD) {
+		client->body_done = 1;
+	}
+
+	ctx->fds[idx + 1].events = ZSOCK_POLLOUT;
+}
+
+/* Place the next part of the response body into tx_buf. The static content
+ * is not copied but sent directly from the resource array.
+ */
+static int client_fill_body(struct http_server_client *client)
+{
+	const struct http_server_resource *res = client->resource;
+	int ret;
+
+	client->tx_pos = 0;
+	client->tx_len = 0;
+
+	switch (res->type) {
+#if defined(CONFIG_FILE_SYSTEM)
+	case HTTP_RESOURCE_FS:
+		ret = fs_read(&client->file, client->tx_buf,
+			      MIN(client->body_left, sizeof(client->tx_buf)));
+		if (ret <= 0) {
+			return ret < 0 ? ret : -EIO;
+		}
+
+		client->tx_len = ret;
+		client->body_left -= ret;
+
+		if (client->body_left == 0) {
+			(void)fs_close(&client->file);
+			client->file_open = 0;
+			client->body_done = 1;
+		}
+
+		return 0;
+#endif
+
+	case HTTP_RESOURCE_DYNAMIC:
+		if (!client->chunked) {
+			ret = res->cb(&client->req, client->tx_buf,
+				      sizeof(client->tx_buf), res->user_data);
+			if (ret < 0) {
+				return ret;
+			}
+
+			if (ret == 0) {
+				client->body_done = 1;
+			}
+
+			client->tx_len = ret;
+			client->req.offset += ret;
+
+			return 0;
+		}
+
+		ret = res->cb(&client->req, client->tx_buf + CHUNK_HDR_LEN,
+			      sizeof(client->tx_buf) - CHUNK_HDR_LEN -
+							CHUNK_TRAILER_LEN,
+			      res->user_data);
+		if (ret < 0) {
+			return ret;
+		}
+
+		if (ret == 0) {
+			memcpy(client->tx_buf, LAST_CHUNK,
+			       sizeof(LAST_CHUNK) - 1);
+			client->tx_len = sizeof(LAST_CHUNK) - 1;
+			client->body_done = 1;
+		} else {
+			char size[CHUNK_HDR_LEN + 1];
+			int len;
+
+			len = snprintk(size, sizeof(size), "%x" HTTP_CRLF, ret);
+
+			/* Place the chunk size right in front of the data */
+			client->tx_pos = CHUNK_HDR_LEN - len;
+			memcpy(client->tx_buf + client->tx_pos, size, len);
+
+			client->tx_len = CHUNK_HDR_LEN + ret;
+			memcpy(client->tx_buf + client->tx_len, HTTP_CRLF,
+			       CHUNK_TRAILER_LEN);
+			client->tx_len += CHUNK_TRAILER_LEN;
+
+			client->req.offset += ret;
+		}
+
+		return 0;
+
+	default:
+		break;
+	}
+
+	return -ENOTSUP;
+}
+
+static int client_parse(struct http_server_ctx *ctx, int idx)
+{
+	struct http_server_client *client = &ctx->clients[idx];
+	enum http_errno err;
+	size_t parsed;
+
+	parsed = http_parser_execute(&client->parser, &ctx->parser_settings,
+				     client->rx_buf + client->rx_parsed,
+				     client->rx_len - client->rx_parsed);
+	client->rx_parsed += parsed;
+
+	err = HTTP_PARSER_ERRNO(&client->parser);
+	if (err != HPE_OK && err != HPE_PAUSED) {
+		NET_DBG("[%d] Invalid request (%s)", idx,
+			http_errno_name(err));
+
+		client->status = 400;
+		client->req.method = HTTP_GET;
+		client->keep_alive = 0;
+		client->responding = 1;
+	}
+
+	if (client->rx_parsed == client->rx_len) {
+		client->rx_len = 0;
+		client->rx_parsed = 0;
+	}
+
+	if (client->responding) {
+		client_start_response(ctx, idx);
+	}
+
+	return 0;
+}
+
+static int client_recv(struct http_server_ctx *ctx, int idx)
+{
+	struct http_server_client *client = &ctx->clients[idx];
+	int ret;
+
+	ret = zsock_recv(client->sock, client->rx_buf + client->rx_len,
+			 sizeof(client->rx_buf) - client->rx_len,
+			 ZSOCK_MSG_DONTWAIT);
+	if (ret < 0) {
+		return errno == EAGAIN ? 0 : -errno;
+	}
+
+	if (ret == 0) {
+		/* Connection closed by peer */
+		return -ENOTCONN;
+	}
+
+	client->rx_len += ret;
+	client->last_activity = k_uptime_get();
+
+	return client_parse(ctx, idx);
+}
+
+static int client_response_done(struct http_server_ctx *ctx, int idx)
+{
+	struct http_server_client *client = &ctx->clients[idx];
+
+	NET_DBG("[%d] Response %d sent", idx, client->status);
+
+	if (!client->keep_alive) {
+		return -ECONNRESET;
+	}
+
+	client_reset(client);
+
+	ctx->fds[idx + 1].events = ZSOCK_POLLIN;
+
+	/* Continue with the pipelined requests, if any */
+	http_parser_pause(&client->parser, 0);
+
+	if (client->rx_len > 0) {
+		return client_parse(ctx, idx);
+	}
+
+	return 0;
+}
+
+/* Send the next part of the response. If the socket is not ready, the same
+ * data is sent again on the next POLLOUT. Returns <0 if the connection
+ * should be closed.
+ */
+static int client_send(struct http_server_ctx *ctx, int idx)
+{
+	struct http_server_client *client = &ctx->clients[idx];
+	const struct http_server_resource *res = client->resource;
+	const uint8_t *data;
+	bool from_res = false;
+	size_t len;
+	int ret;
+
+	if (client->tx_pos == client->tx_len) {
+		if (client->body_done) {
+			return client_response_done(ctx, idx);
+		}
+
+		if (res->type == HTTP_RESOURCE_STATIC) {
+			from_res = true;
+		} else {
+			ret = client_fill_body(client);
+			if (ret < 0) {
+				NET_DBG("[%d] Cannot get response data (%d)",
+					idx, ret);
+				return ret;
+			}
+		}
+	}
+
+	if (from_res) {
+		data = res->static_data.data + res->static_data.len -
+			client->body_left;
+		len = client->body_left;
+	} else {
+		data = client->tx_buf + client->tx_pos;
+		len = client->tx_len - client->tx_pos;
+	}
+
+	if (len > 0) {
+		ret = zsock_send(client->sock, data, len, ZSOCK_MSG_DONTWAIT);
+		if (ret < 0) {
+			return errno == EAGAIN ? 0 : -errno;
+		}
+
+		client->last_activity = k_uptime_get();
+	} else {
+		ret = 0;
+	}
+
+	if (from_res) {
+		client->body_left -= ret;
+		if (client->body_left == 0) {
+			client->body_done = 1;
+		}
+	} else {
+		client->tx_pos += ret;
+	}
+
+	if (client->tx_pos == client->tx_len && client->body_done) {
+		ret = client_response_done(ctx, idx);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+int http_server_init(struct http_server_ctx *ctx,
+		     const struct sockaddr *addr, socklen_t addrlen,
+		     const struct http_server_resource *resources,
+		     size_t resource_count)
+{
+	int sock, ret, i;
+
+	if (ctx == NULL || addr == NULL ||
+	    (resources == NULL && resource_count > 0)) {
+		return -EINVAL;
+	}
+
+	memset(ctx, 0, sizeof(*ctx));
+
+	ctx->resources = resources;
+	ctx->resource_count = resource_count;
+
+	http_parser_settings_init(&ctx->parser_settings);
+	ctx->parser_settings.on_message_begin = on_message_begin;
+	ctx->parser_settings.on_url = on_url;
+	ctx->parser_settings.on_message_complete = on_message_complete;
+
+	sock = zsock_socket(addr->sa_family, SOCK_STREAM, IPPROTO_TCP);
+	if (sock < 0) {
+		return -errno;
+	}
+
+	ret = zsock_bind(sock, addr, addrlen);
+	if (ret < 0) {
+		ret = -errno;
+		NET_DBG("Cannot bind (%d)", ret);
+		goto fail;
+	}
+
+	ret = zsock_listen(sock, CONFIG_HTTP_SERVER_MAX_CLIENTS);
+	if (ret < 0) {
+		ret = -errno;
+		NET_DBG("Cannot listen (%d)", ret);
+		goto fail;
+	}
+
+	ctx->listen_sock = sock;
+	ctx->fds[0].fd = sock;
+	ctx->fds[0].events = ZSOCK_POLLIN;
+
+	for (i = 0; i < ARRAY_SIZE(ctx->clients); i++) {
+		ctx->clients[i].sock = -1;
+		ctx->fds[i + 1].fd = -1;
+	}
+
+	return 0;
+
+fail:
+	(void)zsock_close(sock);
+	return ret;
+}
+
+int http_server_run(struct http_server_ctx *ctx)
+{
+	struct http_server_client *client;
+	int64_t now;
+	int ret = 0;
+	int i;
+
+	if (ctx == NULL || ctx->fds[0].fd < 0) {
+		return -EINVAL;
+	}
+
+	while (!atomic_get(&ctx->stop)) {
+		ret = zsock_poll(ctx->fds, ARRAY_SIZE(ctx->fds),
+				 POLL_TIMEOUT_MS);
+		if (ret < 0) {
+			ret = -errno;
+			NET_ERR("Poll failed (%d)", ret);
+			break;
+		}
+
+		ret = 0;
+
+		if (ctx->fds[0].revents & ZSOCK_POLLIN) {
+			server_accept(ctx);
+		}
+
+		now = k_uptime_get();
+
+		for (i = 0; i < ARRAY_SIZE(ctx->clients); i++) {
+			struct zsock_pollfd *pfd = &ctx->fds[i + 1];
+			int status = 0;
+
+			client = &ctx->clients[i];
+			if (client->sock < 0) {
+				continue;
+			}
+
+			if (pfd->revents & ZSOCK_POLLIN) {
+				status = client_recv(ctx, i);
+			} else if (pfd->revents & ZSOCK_POLLOUT) {
+				status = client_send(ctx, i);
+			} else if (pfd->revents &
+				   (ZSOCK_POLLERR | ZSOCK_POLLHUP |
+				    ZSOCK_POLLNVAL)) {
+				status = -ENOTCONN;
+			} else if (CONFIG_HTTP_SERVER_IDLE_TIMEOUT > 0 &&
+				   !client->responding &&
+				   now - client->last_activity >
+					CONFIG_HTTP_SERVER_IDLE_TIMEOUT) {
+				NET_DBG("[%d] Idle timeout", i);
+				status = -ETIMEDOUT;
+			}
+
+			if (status < 0) {
+				client_close(ctx, i);
+			}
+		}
+	}
+
+	for (i = 0; i < ARRAY_SIZE(ctx->clients); i++) {
+		if (ctx->clients[i].sock >= 0) {
+			client_close(ctx, i);
+		}
+	}
+
+	(void)zsock_close(ctx->listen_sock);
+	ctx->listen_sock = -1;
+	ctx->fds[0].fd = -1;
+
+	return ret;
+}
+
+void http_server_stop(struct http_server_ctx *ctx)
+{
+	atomic_set(&ctx->stop, 1);
+}
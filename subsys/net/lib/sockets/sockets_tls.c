@@ -18,6 +18,7 @@ LOG_MODULE_REGISTER(net_sock_tls, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <net/socket.h>
 #include <syscall_handler.h>
 #include <sys/fdtable.h>
+#include <sys/crc.h>
 
 #if defined(CONFIG_MBEDTLS)
 #if !defined(CONFIG_MBEDTLS_CFG_FILE)
@@ -32,6 +33,8 @@ LOG_MODULE_REGISTER(net_sock_tls, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <mbedtls/x509_crt.h>
 #include <mbedtls/ssl.h>
 #include <mbedtls/ssl_cookie.h>
+#include <mbedtls/ssl_cache.h>
+#include <mbedtls/ssl_ticket.h>
 #include <mbedtls/error.h>
 #include <mbedtls/debug.h>
 #endif /* CONFIG_MBEDTLS */
@@ -39,6 +42,14 @@ LOG_MODULE_REGISTER(net_sock_tls, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include "sockets_internal.h"
 #include "tls_internal.h"
 
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+#if !defined(MBEDTLS_SSL_DTLS_CONNECTION_ID)
+#error "DTLS connection ID requires MBEDTLS_SSL_DTLS_CONNECTION_ID"
+#endif
+BUILD_ASSERT(CONFIG_NET_SOCKETS_DTLS_CID_LEN <= MBEDTLS_SSL_CID_IN_LEN_MAX,
+	     "DTLS connection ID too long for mbedTLS configuration");
+#endif
+
 extern const struct socket_op_vtable sock_fd_op_vtable;
 
 static const struct socket_op_vtable tls_sock_fd_op_vtable;
@@ -68,6 +79,10 @@ struct dtls_timing_context {
 	uint32_t fin_ms;
 };
 
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+struct dtls_peer;
+#endif
+
 /** TLS context information. */
 struct tls_context {
 	/** Information whether TLS context is used. */
@@ -102,8 +117,28 @@ struct tls_context {
 
 		/** DTLS role, client by default. */
 		int8_t role;
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+		/** Information if session caching is enabled. */
+		bool cache_enabled;
+#endif
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+		/** DTLS connection ID usage, disabled by default. */
+		int8_t dtls_cid;
+#endif
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+		/** Information if DTLS server serves many peers. */
+		bool dtls_multi_peer;
+#endif
 	} options;
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	/** Information if a cached session was offered to the server. */
+	bool session_offered;
+#endif
+
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 	/** Context information for DTLS timing. */
 	struct dtls_timing_context dtls_timing;
@@ -116,6 +151,11 @@ struct tls_context {
 
 	/** DTLS peer address length. */
 	socklen_t dtls_peer_addrlen;
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+	/** Peer the next datagram in the receive queue belongs to. */
+	struct dtls_peer *rx_peer;
+#endif
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
 #if defined(CONFIG_MBEDTLS)
@@ -139,6 +179,66 @@ struct tls_context {
 #endif /* CONFIG_MBEDTLS */
 };
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+/** A session stored by a TLS client for resuming it later. */
+struct tls_session_cache {
+	/** mbedTLS session, including the session ticket if one was
+	 *  issued by the server.
+	 */
+	mbedtls_ssl_session session;
+
+	/** Address of the peer the session was established with. */
+	struct sockaddr peer_addr;
+
+	/** CRC of the hostname used with the session, 0 if none. */
+	uint32_t hostname_crc;
+
+	/** Time of the last use, the least recently used entry is replaced
+	 *  when the cache is full.
+	 */
+	uint32_t timestamp;
+
+	/** Information whether the entry is used. */
+	bool is_used;
+};
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_CACHE */
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+/** State of one peer of a multi-peer DTLS server socket. The mbedTLS
+ *  configuration and the credentials are shared with the socket.
+ */
+struct dtls_peer {
+	/** mbedTLS context of the peer. */
+	mbedtls_ssl_context ssl;
+
+	/** Context information for DTLS timing. */
+	struct dtls_timing_context timing;
+
+	/** Socket the peer belongs to. */
+	struct net_context *net_ctx;
+
+	/** Peer address. */
+	struct sockaddr addr;
+
+	/** Peer address length. */
+	socklen_t addrlen;
+
+	/** Time of the last datagram processed for the peer. */
+	uint32_t last_activity;
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+	/** Connection ID the peer uses in the records sent to us. */
+	uint8_t cid[CONFIG_NET_SOCKETS_DTLS_CID_LEN];
+#endif
+
+	/** Information whether the peer is used. */
+	bool is_used;
+
+	/** Information whether DTLS handshake is complete. */
+	bool is_established;
+};
+#endif /* CONFIG_NET_SOCKETS_DTLS_MULTI_PEER */
+
 static mbedtls_ctr_drbg_context tls_ctr_drbg;
 
 /* A global pool of TLS contexts. */
@@ -147,6 +247,33 @@ static struct tls_context tls_contexts[CONFIG_NET_SOCKETS_TLS_MAX_CONTEXTS];
 /* A mutex for protecting TLS context allocation. */
 static struct k_mutex context_lock;
 
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+/* A global pool of DTLS peers, allocated under context_lock. */
+static struct dtls_peer dtls_peers[CONFIG_NET_SOCKETS_DTLS_MAX_PEERS];
+#endif
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+/* Sessions stored by TLS clients. */
+static struct tls_session_cache client_cache[
+				CONFIG_NET_SOCKETS_TLS_SESSION_CACHE_SIZE];
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+/* Sessions stored by TLS servers, for session ID based resumption. */
+static mbedtls_ssl_cache_context server_cache;
+#endif
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+/* Keys used by TLS servers to protect session tickets (RFC 5077). */
+static mbedtls_ssl_ticket_context server_ticket;
+static bool server_ticket_initialized;
+#endif
+
+/* A mutex for protecting the session caches and the ticket keys, which are
+ * shared by all TLS contexts.
+ */
+static struct k_mutex session_cache_lock;
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_CACHE */
+
 #define IS_LISTENING(context) (net_context_get_state(context) == \
 			       NET_CONTEXT_LISTENING)
 
@@ -250,6 +377,346 @@ static int dtls_timing_get_delay(void *data)
 }
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
+#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS) || \
+	defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+/* Compare address family, address and port of two socket addresses. */
+static bool tls_addr_cmp(const struct sockaddr *addr1,
+			 const struct sockaddr *addr2)
+{
+	if (addr1->sa_family != addr2->sa_family) {
+		return false;
+	}
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && addr1->sa_family == AF_INET6) {
+		return (net_sin6(addr1)->sin6_port ==
+			net_sin6(addr2)->sin6_port) &&
+			net_ipv6_addr_cmp(&net_sin6(addr1)->sin6_addr,
+					  &net_sin6(addr2)->sin6_addr);
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
+		   addr1->sa_family == AF_INET) {
+		return (net_sin(addr1)->sin_port ==
+			net_sin(addr2)->sin_port) &&
+			net_ipv4_addr_cmp(&net_sin(addr1)->sin_addr,
+					  &net_sin(addr2)->sin_addr);
+	}
+
+	return false;
+}
+#endif
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+static void tls_session_cache_init(void)
+{
+	int i;
+
+	k_mutex_init(&session_cache_lock);
+
+	for (i = 0; i < ARRAY_SIZE(client_cache); i++) {
+		mbedtls_ssl_session_init(&client_cache[i].session);
+	}
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+	mbedtls_ssl_cache_init(&server_cache);
+	mbedtls_ssl_cache_set_max_entries(
+		&server_cache, CONFIG_NET_SOCKETS_TLS_SESSION_CACHE_SIZE);
+#endif
+}
+
+static const struct sockaddr *tls_session_peer_addr(
+					struct net_context *context)
+{
+#if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
+	if (net_context_get_type(context) == SOCK_DGRAM) {
+		return &context->tls->dtls_peer_addr;
+	}
+#endif
+
+	return &context->remote;
+}
+
+static uint32_t tls_session_hostname_crc(struct net_context *context)
+{
+#if defined(MBEDTLS_X509_CRT_PARSE_C)
+	const char *hostname = context->tls->ssl.hostname;
+
+	if (hostname != NULL && hostname[0] != '\0') {
+		return crc32_ieee((const uint8_t *)hostname, strlen(hostname));
+	}
+#endif
+
+	return 0;
+}
+
+/* Find the cached session for the peer of the context. Must be called with
+ * session_cache_lock held.
+ */
+static struct tls_session_cache *tls_session_find(struct net_context *context)
+{
+	const struct sockaddr *peer_addr = tls_session_peer_addr(context);
+	uint32_t hostname_crc = tls_session_hostname_crc(context);
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(client_cache); i++) {
+		if (client_cache[i].is_used &&
+		    client_cache[i].hostname_crc == hostname_crc &&
+		    tls_addr_cmp(&client_cache[i].peer_addr, peer_addr)) {
+			return &client_cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void tls_session_free(struct tls_session_cache *entry)
+{
+	mbedtls_ssl_session_free(&entry->session);
+	entry->is_used = false;
+}
+
+/* Offer the cached session, if any, to the server in the ClientHello. */
+static void tls_session_restore(struct net_context *context)
+{
+	struct tls_session_cache *entry;
+	int ret;
+
+	context->tls->session_offered = false;
+
+	k_mutex_lock(&session_cache_lock, K_FOREVER);
+
+	entry = tls_session_find(context);
+	if (entry != NULL) {
+		ret = mbedtls_ssl_set_session(&context->tls->ssl,
+					      &entry->session);
+		if (ret == 0) {
+			entry->timestamp = k_uptime_get_32();
+			context->tls->session_offered = true;
+		} else {
+			NET_DBG("Cannot restore TLS session: -%x", -ret);
+			tls_session_free(entry);
+		}
+	}
+
+	k_mutex_unlock(&session_cache_lock);
+}
+
+/* Store the session of a completed handshake, replacing the previous session
+ * with the same peer or the least recently used one.
+ */
+static void tls_session_store(struct net_context *context)
+{
+	struct tls_session_cache *entry;
+	uint32_t now = k_uptime_get_32();
+	int ret, i;
+
+	k_mutex_lock(&session_cache_lock, K_FOREVER);
+
+	entry = tls_session_find(context);
+	if (entry != NULL) {
+		const mbedtls_ssl_session *session = context->tls->ssl.session;
+
+		if (context->tls->session_offered &&
+		    session->id_len == entry->session.id_len &&
+		    session->id_len > 0 &&
+		    memcmp(session->id, entry->session.id,
+			   session->id_len) == 0) {
+			NET_DBG("TLS session resumed");
+		}
+	} else {
+		for (i = 0; i < ARRAY_SIZE(client_cache); i++) {
+			if (!client_cache[i].is_used) {
+				entry = &client_cache[i];
+				break;
+			}
+
+			if (entry == NULL || now - client_cache[i].timestamp >
+					     now - entry->timestamp) {
+				entry = &client_cache[i];
+			}
+		}
+	}
+
+	/* mbedtls_ssl_get_session() frees the previous content. */
+	ret = mbedtls_ssl_get_session(&context->tls->ssl, &entry->session);
+	if (ret == 0) {
+		memcpy(&entry->peer_addr, tls_session_peer_addr(context),
+		       sizeof(entry->peer_addr));
+		entry->hostname_crc = tls_session_hostname_crc(context);
+		entry->timestamp = now;
+		entry->is_used = true;
+	} else {
+		NET_DBG("Cannot store TLS session: -%x", -ret);
+		tls_session_free(entry);
+	}
+
+	k_mutex_unlock(&session_cache_lock);
+}
+
+/* Forget the session of the peer, used when resuming it failed. */
+static void tls_session_delete(struct net_context *context)
+{
+	struct tls_session_cache *entry;
+
+	k_mutex_lock(&session_cache_lock, K_FOREVER);
+
+	entry = tls_session_find(context);
+	if (entry != NULL) {
+		tls_session_free(entry);
+	}
+
+	k_mutex_unlock(&session_cache_lock);
+}
+
+static void tls_session_purge(void)
+{
+	int i;
+
+	k_mutex_lock(&session_cache_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(client_cache); i++) {
+		if (client_cache[i].is_used) {
+			tls_session_free(&client_cache[i]);
+		}
+	}
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+	mbedtls_ssl_cache_free(&server_cache);
+	mbedtls_ssl_cache_init(&server_cache);
+	mbedtls_ssl_cache_set_max_entries(
+		&server_cache, CONFIG_NET_SOCKETS_TLS_SESSION_CACHE_SIZE);
+#endif
+
+	k_mutex_unlock(&session_cache_lock);
+}
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+/* mbedTLS is built without MBEDTLS_THREADING_C, so the server cache shared
+ * by the sockets is locked here.
+ */
+static int tls_server_cache_get(void *data, mbedtls_ssl_session *session)
+{
+	int ret;
+
+	k_mutex_lock(&session_cache_lock, K_FOREVER);
+	ret = mbedtls_ssl_cache_get(data, session);
+	k_mutex_unlock(&session_cache_lock);
+
+	return ret;
+}
+
+static int tls_server_cache_set(void *data,
+				const mbedtls_ssl_session *session)
+{
+	int ret;
+
+	k_mutex_lock(&session_cache_lock, K_FOREVER);
+	ret = mbedtls_ssl_cache_set(data, session);
+	k_mutex_unlock(&session_cache_lock);
+
+	return ret;
+}
+#endif /* MBEDTLS_SSL_CACHE_C */
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+static int tls_server_ticket_write(void *data,
+				   const mbedtls_ssl_session *session,
+				   unsigned char *start,
+				   const unsigned char *end,
+				   size_t *tlen, uint32_t *lifetime)
+{
+	int ret;
+
+	k_mutex_lock(&session_cache_lock, K_FOREVER);
+	ret = mbedtls_ssl_ticket_write(data, session, start, end, tlen,
+				       lifetime);
+	k_mutex_unlock(&session_cache_lock);
+
+	return ret;
+}
+
+static int tls_server_ticket_parse(void *data, mbedtls_ssl_session *session,
+				   unsigned char *buf, size_t len)
+{
+	int ret;
+
+	k_mutex_lock(&session_cache_lock, K_FOREVER);
+	ret = mbedtls_ssl_ticket_parse(data, session, buf, len);
+	k_mutex_unlock(&session_cache_lock);
+
+	return ret;
+}
+
+/* Ticket keys are generated when the first server needs them. */
+static int tls_server_ticket_init(void)
+{
+	int ret = 0;
+
+	k_mutex_lock(&session_cache_lock, K_FOREVER);
+
+	if (!server_ticket_initialized) {
+		mbedtls_ssl_ticket_init(&server_ticket);
+
+		ret = mbedtls_ssl_ticket_setup(
+			&server_ticket, mbedtls_ctr_drbg_random, &tls_ctr_drbg,
+#if defined(MBEDTLS_GCM_C)
+			MBEDTLS_CIPHER_AES_256_GCM,
+#else
+			MBEDTLS_CIPHER_AES_256_CCM,
+#endif
+			CONFIG_NET_SOCKETS_TLS_SESSION_TICKET_LIFETIME);
+		if (ret == 0) {
+			server_ticket_initialized = true;
+		} else {
+			mbedtls_ssl_ticket_free(&server_ticket);
+		}
+	}
+
+	k_mutex_unlock(&session_cache_lock);
+
+	return ret;
+}
+#endif /* MBEDTLS_SSL_SESSION_TICKETS && MBEDTLS_SSL_TICKET_C */
+
+/* Configure session resumption for a TLS context, called before
+ * mbedtls_ssl_setup().
+ */
+static int tls_session_conf(struct net_context *context, bool is_server)
+{
+	bool enabled = context->tls->options.cache_enabled;
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS)
+	if (!is_server) {
+		/* Do not ask for tickets that would not be stored. */
+		mbedtls_ssl_conf_session_tickets(&context->tls->config,
+			enabled ? MBEDTLS_SSL_SESSION_TICKETS_ENABLED :
+				  MBEDTLS_SSL_SESSION_TICKETS_DISABLED);
+	}
+#endif
+
+	if (!is_server || !enabled) {
+		return 0;
+	}
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+	if (tls_server_ticket_init() != 0) {
+		return -ENOMEM;
+	}
+
+	mbedtls_ssl_conf_session_tickets_cb(&context->tls->config,
+					    tls_server_ticket_write,
+					    tls_server_ticket_parse,
+					    &server_ticket);
+#endif
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+	mbedtls_ssl_conf_session_cache(&context->tls->config, &server_cache,
+				       tls_server_cache_get,
+				       tls_server_cache_set);
+#endif
+
+	return 0;
+}
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_CACHE */
+
 /* Initialize TLS internals. */
 static int tls_init(struct device *unused)
 {
@@ -275,6 +742,10 @@ static int tls_init(struct device *unused)
 
 	k_mutex_init(&context_lock);
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	tls_session_cache_init();
+#endif
+
 	mbedtls_ctr_drbg_init(&tls_ctr_drbg);
 
 	ret = mbedtls_ctr_drbg_seed(&tls_ctr_drbg, tls_entropy_func, dev,
@@ -411,29 +882,11 @@ static bool dtls_is_peer_addr_valid(struct net_context *context,
 				    const struct sockaddr *peer_addr,
 				    socklen_t addrlen)
 {
-	if (context->tls->dtls_peer_addrlen != addrlen ||
-	    context->tls->dtls_peer_addr.sa_family != peer_addr->sa_family) {
+	if (context->tls->dtls_peer_addrlen != addrlen) {
 		return false;
 	}
 
-	if (IS_ENABLED(CONFIG_NET_IPV6) && peer_addr->sa_family == AF_INET6) {
-		struct sockaddr_in6 *addr1 = net_sin6(peer_addr);
-		struct sockaddr_in6 *addr2 =
-				net_sin6(&context->tls->dtls_peer_addr);
-
-		return (addr1->sin6_port == addr2->sin6_port) &&
-			net_ipv6_addr_cmp(&addr1->sin6_addr, &addr2->sin6_addr);
-	} else if (IS_ENABLED(CONFIG_NET_IPV4) &&
-		   peer_addr->sa_family == AF_INET) {
-		struct sockaddr_in *addr1 = net_sin(peer_addr);
-		struct sockaddr_in *addr2 =
-				net_sin(&context->tls->dtls_peer_addr);
-
-		return (addr1->sin_port == addr2->sin_port) &&
-			net_ipv4_addr_cmp(&addr1->sin_addr, &addr2->sin_addr);
-	}
-
-	return false;
+	return tls_addr_cmp(&context->tls->dtls_peer_addr, peer_addr);
 }
 
 static void dtls_peer_address_set(struct net_context *context,
@@ -545,17 +998,447 @@ static int dtls_rx(void *ctx, unsigned char *buf, size_t len,
 				/* Recalculate the timeout value. */
 				int64_t remaining = end - z_tick_get();
 
-				if (remaining <= 0) {
-					return MBEDTLS_ERR_SSL_TIMEOUT;
-				}
+				if (remaining <= 0) {
+					return MBEDTLS_ERR_SSL_TIMEOUT;
+				}
+
+				timeout = Z_TIMEOUT_TICKS(remaining);
+			}
+		}
+	} while (retry);
+
+	return received;
+}
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+/* Enable the DTLS connection ID on an mbedTLS context. With
+ * TLS_DTLS_CID_SUPPORTED an empty connection ID is used, so the peer can use
+ * its own connection ID but we do not ask for one.
+ */
+static int dtls_cid_set(struct tls_context *tls, mbedtls_ssl_context *ssl,
+			const uint8_t *cid)
+{
+	size_t cid_len = 0;
+
+	if (tls->options.dtls_cid == TLS_DTLS_CID_DISABLED) {
+		return 0;
+	}
+
+	if (tls->options.dtls_cid == TLS_DTLS_CID_ENABLED) {
+		cid_len = CONFIG_NET_SOCKETS_DTLS_CID_LEN;
+	}
+
+	return mbedtls_ssl_set_cid(ssl, MBEDTLS_SSL_CID_ENABLED,
+				   cid_len ? cid : NULL, cid_len);
+}
+#endif /* CONFIG_NET_SOCKETS_DTLS_CID */
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+/* DTLS 1.2 record header fields used to find the peer of a datagram. */
+#define DTLS_CONTENT_TYPE_HANDSHAKE 22
+#define DTLS_CONTENT_TYPE_CID 25
+#define DTLS_HDR_CID_OFFSET 11
+#define DTLS_HDR_HS_TYPE_OFFSET 13
+#define DTLS_HS_TYPE_CLIENT_HELLO 1
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+#define DTLS_PEEK_LEN MAX(DTLS_HDR_HS_TYPE_OFFSET + 1, \
+			  DTLS_HDR_CID_OFFSET + CONFIG_NET_SOCKETS_DTLS_CID_LEN)
+#else
+#define DTLS_PEEK_LEN (DTLS_HDR_HS_TYPE_OFFSET + 1)
+#endif
+
+static inline bool is_dtls_multi_peer(struct net_context *ctx)
+{
+	return ctx->tls->options.dtls_multi_peer &&
+	       ctx->tls->options.role == MBEDTLS_SSL_IS_SERVER;
+}
+
+static int dtls_peer_tx(void *ctx, const unsigned char *buf, size_t len)
+{
+	struct dtls_peer *peer = ctx;
+	struct net_context *net_ctx = peer->net_ctx;
+	ssize_t sent;
+
+	sent = sock_fd_op_vtable.sendto(net_ctx, buf, len, net_ctx->tls->flags,
+					&peer->addr, peer->addrlen);
+	if (sent < 0) {
+		if (errno == EAGAIN) {
+			return MBEDTLS_ERR_SSL_WANT_WRITE;
+		}
+
+		return MBEDTLS_ERR_NET_SEND_FAILED;
+	}
+
+	return sent;
+}
+
+/* Peers only get the datagram which the socket found to be theirs, all the
+ * other reads return MBEDTLS_ERR_SSL_WANT_READ.
+ */
+static int dtls_peer_rx(void *ctx, unsigned char *buf, size_t len)
+{
+	struct dtls_peer *peer = ctx;
+	struct net_context *net_ctx = peer->net_ctx;
+	ssize_t received;
+
+	if (net_ctx->tls->rx_peer != peer) {
+		return MBEDTLS_ERR_SSL_WANT_READ;
+	}
+
+	net_ctx->tls->rx_peer = NULL;
+
+	received = sock_fd_op_vtable.recvfrom(net_ctx, buf, len,
+					      ZSOCK_MSG_DONTWAIT, NULL, NULL);
+	if (received < 0) {
+		if (errno == EAGAIN) {
+			return MBEDTLS_ERR_SSL_WANT_READ;
+		}
+
+		return MBEDTLS_ERR_NET_RECV_FAILED;
+	}
+
+	return received;
+}
+
+static void dtls_peer_free(struct dtls_peer *peer)
+{
+	NET_DBG("Releasing DTLS peer %p", peer);
+
+	mbedtls_ssl_free(&peer->ssl);
+	peer->is_used = false;
+}
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+static struct dtls_peer *dtls_peer_find_cid(struct net_context *ctx,
+					    const uint8_t *cid,
+					    struct dtls_peer *exclude)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(dtls_peers); i++) {
+		if (dtls_peers[i].is_used && dtls_peers[i].net_ctx == ctx &&
+		    &dtls_peers[i] != exclude &&
+		    memcmp(dtls_peers[i].cid, cid,
+			   CONFIG_NET_SOCKETS_DTLS_CID_LEN) == 0) {
+			return &dtls_peers[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Pick a random connection ID which no other peer of the socket uses. */
+static int dtls_peer_cid_generate(struct dtls_peer *peer)
+{
+	int ret;
+
+	do {
+		ret = mbedtls_ctr_drbg_random(&tls_ctr_drbg, peer->cid,
+					      sizeof(peer->cid));
+		if (ret != 0) {
+			return ret;
+		}
+	} while (dtls_peer_find_cid(peer->net_ctx, peer->cid, peer) != NULL);
+
+	return 0;
+}
+#endif /* CONFIG_NET_SOCKETS_DTLS_CID */
+
+static struct dtls_peer *dtls_peer_find_addr(struct net_context *ctx,
+					     const struct sockaddr *addr,
+					     socklen_t addrlen)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(dtls_peers); i++) {
+		if (dtls_peers[i].is_used && dtls_peers[i].net_ctx == ctx &&
+		    dtls_peers[i].addrlen == addrlen &&
+		    tls_addr_cmp(&dtls_peers[i].addr, addr)) {
+			return &dtls_peers[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Find the peer of a received datagram, using the connection ID of the
+ * first record if there is one, and the source address otherwise.
+ */
+static struct dtls_peer *dtls_peer_find(struct net_context *ctx,
+					const uint8_t *hdr, size_t len,
+					const struct sockaddr *addr,
+					socklen_t addrlen, bool *by_cid)
+{
+	*by_cid = false;
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+	if (ctx->tls->options.dtls_cid == TLS_DTLS_CID_ENABLED &&
+	    hdr[0] == DTLS_CONTENT_TYPE_CID &&
+	    len >= DTLS_HDR_CID_OFFSET + CONFIG_NET_SOCKETS_DTLS_CID_LEN) {
+		*by_cid = true;
+
+		return dtls_peer_find_cid(ctx, &hdr[DTLS_HDR_CID_OFFSET],
+					  NULL);
+	}
+#endif
+
+	return dtls_peer_find_addr(ctx, addr, addrlen);
+}
+
+/* Allocate a peer for a new handshake. The number of peers in the middle of
+ * a handshake is limited, so that a flood of ClientHello messages cannot
+ * push out the established peers. A peer whose ClientHello has no valid
+ * cookie is released right after the HelloVerifyRequest is sent.
+ */
+static struct dtls_peer *dtls_peer_alloc(struct net_context *ctx,
+					 const struct sockaddr *addr,
+					 socklen_t addrlen)
+{
+	struct dtls_peer *peer = NULL;
+	int i, handshakes = 0;
+	int ret;
+
+	k_mutex_lock(&context_lock, K_FOREVER);
+
+	for (i = 0; i < ARRAY_SIZE(dtls_peers); i++) {
+		if (dtls_peers[i].is_used) {
+			if (!dtls_peers[i].is_established) {
+				handshakes++;
+			}
+		} else if (peer == NULL) {
+			peer = &dtls_peers[i];
+		}
+	}
+
+	if (handshakes >= CONFIG_NET_SOCKETS_DTLS_MAX_HANDSHAKES) {
+		peer = NULL;
+	}
+
+	if (peer != NULL) {
+		(void)memset(peer, 0, sizeof(*peer));
+		peer->is_used = true;
+	}
+
+	k_mutex_unlock(&context_lock);
+
+	if (peer == NULL) {
+		NET_DBG("No room for a new DTLS peer");
+		return NULL;
+	}
+
+	peer->net_ctx = ctx;
+	memcpy(&peer->addr, addr, addrlen);
+	peer->addrlen = addrlen;
+	peer->last_activity = k_uptime_get_32();
+
+	mbedtls_ssl_init(&peer->ssl);
+
+	ret = mbedtls_ssl_setup(&peer->ssl, &ctx->tls->config);
+	if (ret != 0) {
+		goto fail;
+	}
+
+	mbedtls_ssl_set_bio(&peer->ssl, peer, dtls_peer_tx, dtls_peer_rx,
+			    NULL);
+	mbedtls_ssl_set_timer_cb(&peer->ssl, &peer->timing,
+				 dtls_timing_set_delay,
+				 dtls_timing_get_delay);
+
+	ret = mbedtls_ssl_set_client_transport_id(
+			&peer->ssl, (const unsigned char *)addr, addrlen);
+	if (ret != 0) {
+		goto fail;
+	}
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+	if (ctx->tls->options.dtls_cid == TLS_DTLS_CID_ENABLED) {
+		ret = dtls_peer_cid_generate(peer);
+		if (ret != 0) {
+			goto fail;
+		}
+	}
+
+	ret = dtls_cid_set(ctx->tls, &peer->ssl, peer->cid);
+	if (ret != 0) {
+		goto fail;
+	}
+#endif
+
+	NET_DBG("Allocated DTLS peer %p", peer);
+
+	return peer;
+
+fail:
+	NET_ERR("DTLS peer setup failed: -%x", -ret);
+	dtls_peer_free(peer);
+
+	return NULL;
+}
+
+static void dtls_peer_handshake(struct dtls_peer *peer)
+{
+	int ret;
+
+	ret = mbedtls_ssl_handshake(&peer->ssl);
+	switch (ret) {
+	case 0:
+		NET_DBG("DTLS handshake with peer %p complete", peer);
+		peer->is_established = true;
+		peer->last_activity = k_uptime_get_32();
+		break;
+
+	case MBEDTLS_ERR_SSL_WANT_READ:
+	case MBEDTLS_ERR_SSL_WANT_WRITE:
+		break;
+
+	case MBEDTLS_ERR_SSL_HELLO_VERIFY_REQUIRED:
+		/* The cookie is sent, nothing is kept until the client
+		 * comes back with it.
+		 */
+		dtls_peer_free(peer);
+		break;
+
+	default:
+		NET_DBG("DTLS handshake with peer %p failed: -%x", peer,
+			-ret);
+		dtls_peer_free(peer);
+		break;
+	}
+}
+
+/* Read application data of an established peer. Returns -EAGAIN if there
+ * was none, also when the peer was released.
+ */
+static ssize_t dtls_peer_read(struct dtls_peer *peer, void *buf,
+			      size_t max_len, struct sockaddr *src_addr,
+			      socklen_t *addrlen)
+{
+	int ret;
+
+	ret = mbedtls_ssl_read(&peer->ssl, buf, max_len);
+	if (ret >= 0) {
+		peer->last_activity = k_uptime_get_32();
+
+		if (src_addr && addrlen) {
+			*addrlen = MIN(*addrlen, peer->addrlen);
+			memcpy(src_addr, &peer->addr, *addrlen);
+		}
+
+		return ret;
+	}
+
+	switch (ret) {
+	case MBEDTLS_ERR_SSL_WANT_READ:
+	case MBEDTLS_ERR_SSL_WANT_WRITE:
+		break;
+
+	case MBEDTLS_ERR_SSL_CLIENT_RECONNECT:
+		/* mbedTLS kept the new ClientHello, continue with it. */
+		peer->is_established = false;
+		dtls_peer_handshake(peer);
+		break;
+
+	case MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY:
+	default:
+		dtls_peer_free(peer);
+		break;
+	}
+
+	return -EAGAIN;
+}
+
+static struct dtls_peer *dtls_peer_find_pending(struct net_context *ctx)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(dtls_peers); i++) {
+		if (dtls_peers[i].is_used && dtls_peers[i].net_ctx == ctx &&
+		    dtls_peers[i].is_established &&
+		    mbedtls_ssl_get_bytes_avail(&dtls_peers[i].ssl) > 0) {
+			return &dtls_peers[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Retransmit handshake flights and release the peers which have been idle
+ * for too long. Returns the time in milliseconds until this should be done
+ * again, or -1 if there is nothing to wait for.
+ */
+static int32_t dtls_peers_service(struct net_context *ctx)
+{
+	uint32_t now = k_uptime_get_32();
+	int32_t next = -1, left;
+	struct dtls_peer *peer;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(dtls_peers); i++) {
+		peer = &dtls_peers[i];
+
+		if (!peer->is_used || peer->net_ctx != ctx) {
+			continue;
+		}
+
+		if (CONFIG_NET_SOCKETS_DTLS_TIMEOUT > 0) {
+			left = CONFIG_NET_SOCKETS_DTLS_TIMEOUT -
+			       (int32_t)(now - peer->last_activity);
+			if (left <= 0) {
+				if (peer->is_established) {
+					(void)mbedtls_ssl_close_notify(
+								&peer->ssl);
+				}
+
+				dtls_peer_free(peer);
+				continue;
+			}
+
+			next = (next < 0) ? left : MIN(next, left);
+		}
+
+		if (peer->is_established) {
+			continue;
+		}
+
+		if (dtls_timing_get_delay(&peer->timing) == 2) {
+			/* The timer is checked before reading, so this
+			 * retransmits the last flight.
+			 */
+			dtls_peer_handshake(peer);
+			if (!peer->is_used) {
+				continue;
+			}
+		}
+
+		if (peer->timing.fin_ms != 0U) {
+			left = peer->timing.fin_ms -
+			       (int32_t)(now - peer->timing.snapshot);
+			left = MAX(left, 1);
+			next = (next < 0) ? left : MIN(next, left);
+		}
+	}
+
+	return next;
+}
+
+/* Release all the peers of a socket which is being closed. */
+static void dtls_peers_close(struct net_context *ctx)
+{
+	int i;
 
-				timeout = Z_TIMEOUT_TICKS(remaining);
+	for (i = 0; i < ARRAY_SIZE(dtls_peers); i++) {
+		if (dtls_peers[i].is_used && dtls_peers[i].net_ctx == ctx) {
+			if (dtls_peers[i].is_established) {
+				(void)mbedtls_ssl_close_notify(
+							&dtls_peers[i].ssl);
 			}
-		}
-	} while (retry);
 
-	return received;
+			dtls_peer_free(&dtls_peers[i]);
+		}
+	}
 }
+#endif /* CONFIG_NET_SOCKETS_DTLS_MULTI_PEER */
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
 static int tls_tx(void *ctx, const unsigned char *buf, size_t len)
@@ -812,6 +1695,18 @@ static int tls_mbedtls_handshake(struct net_context *context, bool block)
 		k_sem_give(&context->tls->tls_established);
 	}
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	if (context->tls->options.cache_enabled &&
+	    context->tls->config.endpoint == MBEDTLS_SSL_IS_CLIENT) {
+		if (ret == 0) {
+			tls_session_store(context);
+		} else if (ret != -EAGAIN && context->tls->session_offered) {
+			/* Do not offer the same session again. */
+			tls_session_delete(context);
+		}
+	}
+#endif
+
 	return ret;
 }
 
@@ -880,6 +1775,20 @@ static int tls_mbedtls_init(struct net_context *context, bool is_server)
 					&context->tls->config,
 					CONFIG_NET_SOCKETS_DTLS_TIMEOUT);
 		}
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+		if (context->tls->options.dtls_cid != TLS_DTLS_CID_DISABLED) {
+			ret = mbedtls_ssl_conf_cid(
+				&context->tls->config,
+				context->tls->options.dtls_cid ==
+					TLS_DTLS_CID_ENABLED ?
+					CONFIG_NET_SOCKETS_DTLS_CID_LEN : 0,
+				MBEDTLS_SSL_UNEXPECTED_CID_IGNORE);
+			if (ret != 0) {
+				return -EINVAL;
+			}
+		}
+#endif
 	}
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
@@ -910,6 +1819,25 @@ static int tls_mbedtls_init(struct net_context *context, bool is_server)
 		return ret;
 	}
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	ret = tls_session_conf(context, is_server);
+	if (ret != 0) {
+		return ret;
+	}
+#endif
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+	/* Every peer gets its own mbedTLS context, set up when the peer
+	 * shows up, the one of the socket is not used.
+	 */
+	if (type == MBEDTLS_SSL_TRANSPORT_DATAGRAM &&
+	    is_dtls_multi_peer(context)) {
+		context->tls->is_initialized = true;
+
+		return 0;
+	}
+#endif
+
 	ret = mbedtls_ssl_setup(&context->tls->ssl,
 				&context->tls->config);
 	if (ret != 0) {
@@ -919,6 +1847,28 @@ static int tls_mbedtls_init(struct net_context *context, bool is_server)
 		return -ENOMEM;
 	}
 
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+	if (type == MBEDTLS_SSL_TRANSPORT_DATAGRAM) {
+		uint8_t cid[CONFIG_NET_SOCKETS_DTLS_CID_LEN];
+
+		ret = mbedtls_ctr_drbg_random(&tls_ctr_drbg, cid, sizeof(cid));
+		if (ret == 0) {
+			ret = dtls_cid_set(context->tls, &context->tls->ssl,
+					   cid);
+		}
+
+		if (ret != 0) {
+			return -EINVAL;
+		}
+	}
+#endif
+
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	if (!is_server && context->tls->options.cache_enabled) {
+		tls_session_restore(context);
+	}
+#endif
+
 	context->tls->is_initialized = true;
 
 	return 0;
@@ -1112,6 +2062,145 @@ static int tls_opt_dtls_role_set(struct net_context *context,
 	return 0;
 }
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+static int tls_opt_session_cache_set(struct net_context *context,
+				     const void *optval, socklen_t optlen)
+{
+	int *cache;
+
+	if (!optval) {
+		return -EINVAL;
+	}
+
+	if (optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	cache = (int *)optval;
+	if (*cache != TLS_SESSION_CACHE_DISABLED &&
+	    *cache != TLS_SESSION_CACHE_ENABLED) {
+		return -EINVAL;
+	}
+
+	context->tls->options.cache_enabled =
+				(*cache == TLS_SESSION_CACHE_ENABLED);
+
+	return 0;
+}
+
+static int tls_opt_session_cache_get(struct net_context *context,
+				     void *optval, socklen_t *optlen)
+{
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	*(int *)optval = context->tls->options.cache_enabled ?
+			 TLS_SESSION_CACHE_ENABLED :
+			 TLS_SESSION_CACHE_DISABLED;
+
+	return 0;
+}
+
+static int tls_opt_session_cache_purge_set(struct net_context *context,
+					   const void *optval,
+					   socklen_t optlen)
+{
+	ARG_UNUSED(context);
+	ARG_UNUSED(optval);
+	ARG_UNUSED(optlen);
+
+	tls_session_purge();
+
+	return 0;
+}
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_CACHE */
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+static int tls_opt_dtls_cid_set(struct net_context *context,
+				const void *optval, socklen_t optlen)
+{
+	int *cid;
+
+	if (!optval) {
+		return -EINVAL;
+	}
+
+	if (optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	cid = (int *)optval;
+	if (*cid != TLS_DTLS_CID_DISABLED &&
+	    *cid != TLS_DTLS_CID_SUPPORTED &&
+	    *cid != TLS_DTLS_CID_ENABLED) {
+		return -EINVAL;
+	}
+
+	context->tls->options.dtls_cid = *cid;
+
+	return 0;
+}
+
+static int tls_opt_dtls_cid_get(struct net_context *context,
+				void *optval, socklen_t *optlen)
+{
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	*(int *)optval = context->tls->options.dtls_cid;
+
+	return 0;
+}
+#endif /* CONFIG_NET_SOCKETS_DTLS_CID */
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+static int tls_opt_dtls_multi_peer_set(struct net_context *context,
+				       const void *optval, socklen_t optlen)
+{
+	int *multi_peer;
+
+	if (!optval) {
+		return -EINVAL;
+	}
+
+	if (optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	if (net_context_get_type(context) != SOCK_DGRAM) {
+		return -EINVAL;
+	}
+
+	/* The mode cannot change once the socket has mbedTLS set up. */
+	if (context->tls->is_initialized) {
+		return -EISCONN;
+	}
+
+	multi_peer = (int *)optval;
+	if (*multi_peer != 0 && *multi_peer != 1) {
+		return -EINVAL;
+	}
+
+	context->tls->options.dtls_multi_peer = *multi_peer;
+
+	return 0;
+}
+
+static int tls_opt_dtls_multi_peer_get(struct net_context *context,
+				       void *optval, socklen_t *optlen)
+{
+	if (*optlen != sizeof(int)) {
+		return -EINVAL;
+	}
+
+	*(int *)optval = context->tls->options.dtls_multi_peer;
+
+	return 0;
+}
+#endif /* CONFIG_NET_SOCKETS_DTLS_MULTI_PEER */
+
 static int ztls_socket(int family, int type, int proto)
 {
 	enum net_ip_protocol_secure tls_proto = 0;
@@ -1192,6 +2281,10 @@ int ztls_close_ctx(struct net_context *ctx)
 		ctx->tls->flags = 0;
 		(void)mbedtls_ssl_close_notify(&ctx->tls->ssl);
 
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+		dtls_peers_close(ctx);
+#endif
+
 		err = tls_release(ctx->tls);
 	} else {
 		err = -EBADF;
@@ -1439,6 +2532,43 @@ static ssize_t sendto_dtls_server(struct net_context *ctx, const void *buf,
 
 	return send_tls(ctx, buf, len, flags);
 }
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+static ssize_t sendto_dtls_multi_peer(struct net_context *ctx,
+				      const void *buf, size_t len, int flags,
+				      const struct sockaddr *dest_addr,
+				      socklen_t addrlen)
+{
+	struct dtls_peer *peer;
+	int ret;
+
+	/* With many peers, the destination has to be given every time. */
+	if (!dest_addr) {
+		errno = EDESTADDRREQ;
+		return -1;
+	}
+
+	peer = dtls_peer_find_addr(ctx, dest_addr, addrlen);
+	if (peer == NULL || !peer->is_established) {
+		errno = ENOTCONN;
+		return -1;
+	}
+
+	ret = mbedtls_ssl_write(&peer->ssl, buf, len);
+	if (ret >= 0) {
+		return ret;
+	}
+
+	if (ret == MBEDTLS_ERR_SSL_WANT_READ ||
+	    ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+		errno = EAGAIN;
+	} else {
+		errno = EIO;
+	}
+
+	return -1;
+}
+#endif /* CONFIG_NET_SOCKETS_DTLS_MULTI_PEER */
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
 ssize_t ztls_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
@@ -1459,6 +2589,13 @@ ssize_t ztls_sendto_ctx(struct net_context *ctx, const void *buf, size_t len,
 
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 	/* DTLS */
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+	if (is_dtls_multi_peer(ctx)) {
+		return sendto_dtls_multi_peer(ctx, buf, len, flags,
+					      dest_addr, addrlen);
+	}
+#endif
+
 	if (ctx->tls->options.role == MBEDTLS_SSL_IS_SERVER) {
 		return sendto_dtls_server(ctx, buf, len, flags,
 					  dest_addr, addrlen);
@@ -1653,6 +2790,131 @@ error:
 	errno = -ret;
 	return -1;
 }
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+/* Throw away the datagram at the head of the receive queue. */
+static void dtls_drop_datagram(struct net_context *ctx)
+{
+	uint8_t byte;
+
+	(void)sock_fd_op_vtable.recvfrom(ctx, &byte, sizeof(byte),
+					 ZSOCK_MSG_DONTWAIT, NULL, NULL);
+}
+
+static ssize_t recvfrom_dtls_multi_peer(struct net_context *ctx, void *buf,
+					size_t max_len, int flags,
+					struct sockaddr *src_addr,
+					socklen_t *addrlen)
+{
+	bool is_block = !((flags & ZSOCK_MSG_DONTWAIT) ||
+			  sock_is_nonblock(ctx));
+	uint8_t hdr[DTLS_PEEK_LEN];
+	struct k_poll_event pev;
+	struct dtls_peer *peer;
+	struct sockaddr addr;
+	socklen_t len;
+	bool by_cid;
+	int32_t next;
+	ssize_t ret;
+
+	if (!ctx->tls->is_initialized) {
+		ret = tls_mbedtls_init(ctx, true);
+		if (ret < 0) {
+			errno = -ret;
+			return -1;
+		}
+	}
+
+	while (true) {
+		/* Data left from a record which did not fit the buffer. */
+		peer = dtls_peer_find_pending(ctx);
+		if (peer != NULL) {
+			ret = dtls_peer_read(peer, buf, max_len, src_addr,
+					     addrlen);
+			if (ret >= 0) {
+				return ret;
+			}
+		}
+
+		next = dtls_peers_service(ctx);
+
+		if (is_block) {
+			pev.obj = &ctx->recv_q;
+			pev.type = K_POLL_TYPE_FIFO_DATA_AVAILABLE;
+			pev.mode = K_POLL_MODE_NOTIFY_ONLY;
+			pev.state = K_POLL_STATE_NOT_READY;
+
+			if (k_poll(&pev, 1, next < 0 ? K_FOREVER :
+					     K_MSEC(next)) == -EAGAIN) {
+				continue;
+			}
+		}
+
+		/* Peek at the record header to find the peer, the peer then
+		 * reads the datagram through mbedTLS.
+		 */
+		len = sizeof(addr);
+		ret = sock_fd_op_vtable.recvfrom(ctx, hdr, sizeof(hdr),
+						 ZSOCK_MSG_PEEK |
+						 ZSOCK_MSG_DONTWAIT,
+						 &addr, &len);
+		if (ret < 0) {
+			if (errno == EAGAIN && is_block) {
+				continue;
+			}
+
+			return -1;
+		}
+
+		peer = dtls_peer_find(ctx, hdr, ret, &addr, len, &by_cid);
+		if (peer == NULL && ret > DTLS_HDR_HS_TYPE_OFFSET &&
+		    hdr[0] == DTLS_CONTENT_TYPE_HANDSHAKE &&
+		    hdr[DTLS_HDR_HS_TYPE_OFFSET] == DTLS_HS_TYPE_CLIENT_HELLO) {
+			peer = dtls_peer_alloc(ctx, &addr, len);
+		}
+
+		if (peer == NULL) {
+			dtls_drop_datagram(ctx);
+			continue;
+		}
+
+		ctx->tls->rx_peer = peer;
+
+		if (peer->is_established) {
+			ret = dtls_peer_read(peer, buf, max_len, src_addr,
+					     addrlen);
+			if (ret >= 0 && by_cid &&
+			    (peer->addrlen != len ||
+			     !tls_addr_cmp(&peer->addr, &addr))) {
+				/* Authenticated record with our connection
+				 * ID, the peer has a new address.
+				 */
+				NET_DBG("DTLS peer %p changed address", peer);
+				memcpy(&peer->addr, &addr, len);
+				peer->addrlen = len;
+
+				if (src_addr && addrlen) {
+					*addrlen = MIN(*addrlen, len);
+					memcpy(src_addr, &addr, *addrlen);
+				}
+			}
+		} else {
+			dtls_peer_handshake(peer);
+			ret = -EAGAIN;
+		}
+
+		if (ctx->tls->rx_peer != NULL) {
+			/* The peer did not read the datagram. */
+			ctx->tls->rx_peer = NULL;
+			dtls_drop_datagram(ctx);
+		}
+
+		if (ret >= 0) {
+			return ret;
+		}
+	}
+}
+#endif /* CONFIG_NET_SOCKETS_DTLS_MULTI_PEER */
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 
 ssize_t ztls_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
@@ -1681,6 +2943,13 @@ ssize_t ztls_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
 
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 	/* DTLS */
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+	if (is_dtls_multi_peer(ctx)) {
+		return recvfrom_dtls_multi_peer(ctx, buf, max_len, flags,
+						src_addr, addrlen);
+	}
+#endif
+
 	if (ctx->tls->options.role == MBEDTLS_SSL_IS_SERVER) {
 		return recvfrom_dtls_server(ctx, buf, max_len, flags,
 					    src_addr, addrlen);
@@ -1694,6 +2963,17 @@ ssize_t ztls_recvfrom_ctx(struct net_context *ctx, void *buf, size_t max_len,
 #endif /* CONFIG_NET_SOCKETS_ENABLE_DTLS */
 }
 
+static bool tls_has_pending_data(struct net_context *ctx)
+{
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+	if (is_dtls_multi_peer(ctx)) {
+		return dtls_peer_find_pending(ctx) != NULL;
+	}
+#endif
+
+	return mbedtls_ssl_get_bytes_avail(&ctx->tls->ssl) > 0;
+}
+
 static int ztls_poll_prepare_ctx(struct net_context *ctx,
 				 struct zsock_pollfd *pfd,
 				 struct k_poll_event **pev,
@@ -1739,7 +3019,7 @@ static int ztls_poll_prepare_ctx(struct net_context *ctx,
 		 * so we won't block in the k_poll.
 		 */
 		if (!IS_LISTENING(ctx)) {
-			if (mbedtls_ssl_get_bytes_avail(&ctx->tls->ssl) > 0) {
+			if (tls_has_pending_data(ctx)) {
 				return -EALREADY;
 			}
 		}
@@ -1785,7 +3065,7 @@ static int ztls_poll_update_ctx(struct net_context *ctx,
 
 		if (!IS_LISTENING(ctx)) {
 			/* Already had TLS data to read on socket. */
-			if (mbedtls_ssl_get_bytes_avail(&ctx->tls->ssl) > 0) {
+			if (tls_has_pending_data(ctx)) {
 				pfd->revents |= ZSOCK_POLLIN;
 				goto next;
 			}
@@ -1807,7 +3087,7 @@ static int ztls_poll_update_ctx(struct net_context *ctx,
 				goto next;
 			}
 
-			if (mbedtls_ssl_get_bytes_avail(&ctx->tls->ssl) > 0 ||
+			if (tls_has_pending_data(ctx) ||
 			    sock_is_eof(ctx)) {
 				pfd->revents |= ZSOCK_POLLIN;
 				goto next;
@@ -1869,6 +3149,24 @@ int ztls_getsockopt_ctx(struct net_context *ctx, int level, int optname,
 		err = tls_opt_ciphersuite_used_get(ctx, optval, optlen);
 		break;
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	case TLS_SESSION_CACHE:
+		err = tls_opt_session_cache_get(ctx, optval, optlen);
+		break;
+#endif
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+	case TLS_DTLS_CID:
+		err = tls_opt_dtls_cid_get(ctx, optval, optlen);
+		break;
+#endif
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+	case TLS_DTLS_MULTI_PEER:
+		err = tls_opt_dtls_multi_peer_get(ctx, optval, optlen);
+		break;
+#endif
+
 	default:
 		/* Unknown or write-only option. */
 		err = -ENOPROTOOPT;
@@ -1919,6 +3217,28 @@ int ztls_setsockopt_ctx(struct net_context *ctx, int level, int optname,
 		err = tls_opt_dtls_role_set(ctx, optval, optlen);
 		break;
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_CACHE)
+	case TLS_SESSION_CACHE:
+		err = tls_opt_session_cache_set(ctx, optval, optlen);
+		break;
+
+	case TLS_SESSION_CACHE_PURGE:
+		err = tls_opt_session_cache_purge_set(ctx, optval, optlen);
+		break;
+#endif
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_CID)
+	case TLS_DTLS_CID:
+		err = tls_opt_dtls_cid_set(ctx, optval, optlen);
+		break;
+#endif
+
+#if defined(CONFIG_NET_SOCKETS_DTLS_MULTI_PEER)
+	case TLS_DTLS_MULTI_PEER:
+		err = tls_opt_dtls_multi_peer_set(ctx, optval, optlen);
+		break;
+#endif
+
 	default:
 		/* Unknown or read-only option. */
 		err = -ENOPROTOOPT;
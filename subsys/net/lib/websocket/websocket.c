@@ -437,84 +437,53 @@ static int websocket_ioctl_vmeth(void *obj, unsigned int request, va_list args)
 	return sock_fd_op_vtable.fd_vtable.ioctl(obj, request, args);
 }
 
-static int websocket_prepare_and_send(struct websocket_context *ctx,
-				      uint8_t *header, size_t header_len,
-				      uint8_t *payload, size_t payload_len,
-				      int32_t timeout)
+/* Apply the RFC 6455 masking to the data. The pos parameter tells the offset
+ * of the first byte within the payload so that the right byte of the masking
+ * key is used. The dst and src can point to the same buffer. After the
+ * destination is aligned, the data is masked one machine word at a time.
+ */
+static void websocket_mask_data(uint8_t *dst, const uint8_t *src, size_t len,
+				uint32_t masking_value, size_t pos)
 {
-	struct iovec io_vector[2];
-	struct msghdr msg;
-
-	io_vector[0].iov_base = header;
-	io_vector[0].iov_len = header_len;
-	io_vector[1].iov_base = payload;
-	io_vector[1].iov_len = payload_len;
-
-	memset(&msg, 0, sizeof(msg));
-
-	msg.msg_iov = io_vector;
-	msg.msg_iovlen = ARRAY_SIZE(io_vector);
+	union {
+		uintptr_t word;
+		uint8_t bytes[sizeof(uintptr_t)];
+	} key;
+	int i;
 
-	if (HEXDUMP_SENT_PACKETS) {
-		LOG_HEXDUMP_DBG(header, header_len, "Header");
-		LOG_HEXDUMP_DBG(payload, payload_len, "Payload");
+	while (len > 0 && ((uintptr_t)dst & (sizeof(uintptr_t) - 1))) {
+		*dst++ = *src++ ^ (masking_value >> (8 * (3 - pos % 4)));
+		pos++;
+		len--;
 	}
 
-#if defined(CONFIG_NET_TEST)
-	/* Simulate a case where the payload is split to two. The unit test
-	 * does not set mask bit in this case.
+	/* The word size is a multiple of the key length so the key stays
+	 * in phase with the data for every word.
 	 */
-	return verify_sent_and_received_msg(&msg, !(header[1] & BIT(7)));
-#else
-	k_timeout_t tout = K_FOREVER;
-
-	if (timeout != SYS_FOREVER_MS) {
-		tout = K_MSEC(timeout);
-	}
-
-	return sendmsg(ctx->real_sock, &msg,
-		       K_TIMEOUT_EQ(tout, K_NO_WAIT) ? MSG_DONTWAIT : 0);
-#endif /* CONFIG_NET_TEST */
-}
-
-int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
-		       enum websocket_opcode opcode, bool mask, bool final,
-		       int32_t timeout)
-{
-	struct websocket_context *ctx;
-	uint8_t header[MAX_HEADER_LEN], hdr_len = 2;
-	uint8_t *data_to_send = (uint8_t *)payload;
-	int ret;
-
-	if (opcode != WEBSOCKET_OPCODE_DATA_TEXT &&
-	    opcode != WEBSOCKET_OPCODE_DATA_BINARY &&
-	    opcode != WEBSOCKET_OPCODE_CONTINUE &&
-	    opcode != WEBSOCKET_OPCODE_CLOSE &&
-	    opcode != WEBSOCKET_OPCODE_PING &&
-	    opcode != WEBSOCKET_OPCODE_PONG) {
-		return -EINVAL;
+	for (i = 0; i < sizeof(key); i++) {
+		key.bytes[i] = masking_value >> (8 * (3 - (pos + i) % 4));
 	}
 
-#if defined(CONFIG_NET_TEST)
-	/* Websocket unit test does not use socket layer but feeds
-	 * the data directly here when testing this function.
-	 */
-	ctx = INT_TO_POINTER(ws_sock);
-#else
-	ctx = z_get_fd_obj(ws_sock, NULL, 0);
-	if (ctx == NULL) {
-		return -EBADF;
+	while (len >= sizeof(key)) {
+		*(uintptr_t *)dst = UNALIGNED_GET((const uintptr_t *)src) ^
+								key.word;
+		dst += sizeof(key);
+		src += sizeof(key);
+		len -= sizeof(key);
 	}
 
-	if (!PART_OF_ARRAY(contexts, ctx)) {
-		return -ENOENT;
+	for (i = 0; i < len; i++) {
+		dst[i] = src[i] ^ key.bytes[i];
 	}
-#endif /* CONFIG_NET_TEST */
+}
 
-	NET_DBG("[%p] Len %zd %s/%d/%s", ctx, payload_len, opcode2str(opcode),
-		mask, final ? "final" : "more");
+static int websocket_prepare_header(uint8_t *header, size_t payload_len,
+				    enum websocket_opcode opcode, bool mask,
+				    bool final, uint32_t masking_value)
+{
+	int hdr_len = 2;
 
-	memset(header, 0, sizeof(header));
+	memset(header, 0, MAX_HEADER_LEN);
 
 	/* Is this the last packet? */
 	header[0] = final ? BIT(7) : 0;
@@ -547,41 +516,260 @@ int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 
 	/* Add masking value if needed */
 	if (mask) {
+		sys_put_be32(masking_value, &header[hdr_len]);
+		hdr_len += sizeof(uint32_t);
+	}
+
+	return hdr_len;
+}
+
+static int websocket_sendmsg(struct websocket_context *ctx,
+			     struct iovec *io_vector, size_t iovcnt,
+			     bool split_msg, int32_t timeout)
+{
+	struct msghdr msg;
+
+	memset(&msg, 0, sizeof(msg));
+
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = iovcnt;
+
+	if (HEXDUMP_SENT_PACKETS) {
 		int i;
 
+		for (i = 0; i < iovcnt; i++) {
+			LOG_HEXDUMP_DBG(io_vector[i].iov_base,
+					io_vector[i].iov_len, "Data");
+		}
+	}
+
+#if defined(CONFIG_NET_TEST)
+	/* Simulate a case where the payload is split to two. The unit test
+	 * does not set mask bit in this case.
+	 */
+	return verify_sent_and_received_msg(&msg, split_msg);
+#else
+	k_timeout_t tout = K_FOREVER;
+	size_t total = 0, left = 0;
+	int flags = 0;
+	int ret, i;
+
+	if (timeout != SYS_FOREVER_MS) {
+		tout = K_MSEC(timeout);
+	}
+
+	if (K_TIMEOUT_EQ(tout, K_NO_WAIT)) {
+		flags = MSG_DONTWAIT;
+	}
+
+	for (i = 0; i < iovcnt; i++) {
+		left += io_vector[i].iov_len;
+	}
+
+	while (left > 0) {
+		ret = sendmsg(ctx->real_sock, &msg, flags);
+		if (ret < 0) {
+			if (total > 0) {
+				NET_DBG("[%p] Frame truncated after %zd bytes",
+					ctx, total);
+			}
+
+			return -errno;
+		}
+
+		total += ret;
+		left -= ret;
+
+		/* Once part of the frame is out, the rest of it must follow
+		 * or the peer would lose the framing, so do not bail out
+		 * with EAGAIN in the middle of a frame.
+		 */
+		flags = 0;
+
+		/* Skip over the data that was already sent */
+		while (ret > 0) {
+			if (ret >= msg.msg_iov->iov_len) {
+				ret -= msg.msg_iov->iov_len;
+				msg.msg_iov++;
+				msg.msg_iovlen--;
+			} else {
+				msg.msg_iov->iov_base =
+					(uint8_t *)msg.msg_iov->iov_base + ret;
+				msg.msg_iov->iov_len -= ret;
+				ret = 0;
+			}
+		}
+	}
+
+	return total;
+#endif /* CONFIG_NET_TEST */
+}
+
+/* Send one websocket frame. The payload is taken either from the payload
+ * buffer or, if it is NULL, it is fetched from the cb in pieces. Data that
+ * needs to be masked, or that is fetched from the callback, is passed through
+ * a small buffer so the whole frame is never kept in memory and the caller's
+ * buffer is never modified.
+ */
+static int websocket_send_frame(struct websocket_context *ctx,
+				const uint8_t *payload, size_t payload_len,
+				websocket_payload_cb_t cb, void *user_data,
+				enum websocket_opcode opcode, bool mask,
+				bool final, int32_t timeout)
+{
+	uint8_t header[MAX_HEADER_LEN];
+	union {
+		uintptr_t align;
+		uint8_t data[CONFIG_WEBSOCKET_TX_BUF_LEN];
+	} tx_buf;
+	struct iovec io_vector[2];
+	size_t pos = 0, chunk_len;
+	int hdr_len, iovcnt, ret;
+	uint8_t *data;
+
+	NET_DBG("[%p] Len %zd %s/%d/%s", ctx, payload_len, opcode2str(opcode),
+		mask, final ? "final" : "more");
+
+	if (mask) {
 		ctx->masking_value = sys_rand32_get();
+	}
+
+	hdr_len = websocket_prepare_header(header, payload_len, opcode, mask,
+					   final, ctx->masking_value);
+
+	do {
+		if (payload == NULL) {
+			chunk_len = MIN(payload_len - pos, sizeof(tx_buf.data));
+
+			if (chunk_len > 0) {
+				ret = cb(tx_buf.data, chunk_len, user_data);
+				if (ret <= 0 || ret > chunk_len) {
+					NET_DBG("[%p] Cannot get payload (%d)",
+						ctx, ret);
+					return ret < 0 ? ret : -EIO;
+				}
+
+				chunk_len = ret;
+			}
 
-		header[hdr_len++] |= ctx->masking_value >> 24;
-		header[hdr_len++] |= ctx->masking_value >> 16;
-		header[hdr_len++] |= ctx->masking_value >> 8;
-		header[hdr_len++] |= ctx->masking_value;
+			data = tx_buf.data;
 
-		data_to_send = k_malloc(payload_len);
-		if (!data_to_send) {
-			return -ENOMEM;
+			if (mask) {
+				websocket_mask_data(data, data, chunk_len,
+						    ctx->masking_value, pos);
+			}
+		} else if (mask) {
+			chunk_len = MIN(payload_len - pos, sizeof(tx_buf.data));
+			data = tx_buf.data;
+
+			websocket_mask_data(data, payload + pos, chunk_len,
+					    ctx->masking_value, pos);
+		} else {
+			chunk_len = payload_len - pos;
+			data = (uint8_t *)payload + pos;
 		}
 
-		memcpy(data_to_send, payload, payload_len);
+		iovcnt = 0;
 
-		for (i = 0; i < payload_len; i++) {
-			data_to_send[i] ^=
-				ctx->masking_value >> (8 * (3 - i % 4));
+		if (hdr_len > 0) {
+			io_vector[iovcnt].iov_base = header;
+			io_vector[iovcnt].iov_len = hdr_len;
+			iovcnt++;
 		}
+
+		io_vector[iovcnt].iov_base = data;
+		io_vector[iovcnt].iov_len = chunk_len;
+		iovcnt++;
+
+		ret = websocket_sendmsg(ctx, io_vector, iovcnt, !mask,
+					timeout);
+		if (ret < 0) {
+			NET_DBG("[%p] Cannot send ws msg (%d)", ctx, ret);
+			return ret;
+		}
+
+		hdr_len = 0;
+		pos += chunk_len;
+	} while (pos < payload_len);
+
+	return pos;
+}
+
+static bool websocket_opcode_is_valid(enum websocket_opcode opcode)
+{
+	return opcode == WEBSOCKET_OPCODE_DATA_TEXT ||
+	       opcode == WEBSOCKET_OPCODE_DATA_BINARY ||
+	       opcode == WEBSOCKET_OPCODE_CONTINUE ||
+	       opcode == WEBSOCKET_OPCODE_CLOSE ||
+	       opcode == WEBSOCKET_OPCODE_PING ||
+	       opcode == WEBSOCKET_OPCODE_PONG;
+}
+
+static struct websocket_context *websocket_get_send_ctx(int ws_sock)
+{
+	struct websocket_context *ctx;
+
+#if defined(CONFIG_NET_TEST)
+	/* Websocket unit test does not use socket layer but feeds
+	 * the data directly here when testing this function.
+	 */
+	ctx = INT_TO_POINTER(ws_sock);
+#else
+	ctx = z_get_fd_obj(ws_sock, NULL, 0);
+	if (ctx == NULL) {
+		return NULL;
 	}
 
-	ret = websocket_prepare_and_send(ctx, header, hdr_len,
-					 data_to_send, payload_len, timeout);
-	if (ret < 0) {
-		NET_DBG("Cannot send ws msg (%d)", -errno);
-		goto quit;
+	if (!PART_OF_ARRAY(contexts, ctx)) {
+		return NULL;
 	}
+#endif /* CONFIG_NET_TEST */
 
-quit:
-	if (data_to_send != payload) {
-		k_free(data_to_send);
+	return ctx;
+}
+
+int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
+		       enum websocket_opcode opcode, bool mask, bool final,
+		       int32_t timeout)
+{
+	struct websocket_context *ctx;
+
+	if (!websocket_opcode_is_valid(opcode)) {
+		return -EINVAL;
 	}
 
-	return ret - hdr_len;
+	if (payload == NULL && payload_len > 0) {
+		return -EINVAL;
+	}
+
+	ctx = websocket_get_send_ctx(ws_sock);
+	if (ctx == NULL) {
+		return -EBADF;
+	}
+
+	return websocket_send_frame(ctx, payload ? payload : (uint8_t *)"",
+				    payload_len, NULL, NULL, opcode, mask,
+				    final, timeout);
+}
+
+int websocket_send_stream(int ws_sock, size_t payload_len,
+			  websocket_payload_cb_t cb, void *user_data,
+			  enum websocket_opcode opcode, bool mask, bool final,
+			  int32_t timeout)
+{
+	struct websocket_context *ctx;
+
+	if (!websocket_opcode_is_valid(opcode) || cb == NULL) {
+		return -EINVAL;
+	}
+
+	ctx = websocket_get_send_ctx(ws_sock);
+	if (ctx == NULL) {
+		return -EBADF;
+	}
+
+	return websocket_send_frame(ctx, NULL, payload_len, cb, user_data,
+				    opcode, mask, final, timeout);
 }
 
 static bool websocket_parse_header(uint8_t *buf, size_t buf_len, bool *masked,
@@ -833,12 +1021,9 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 		 * tell that.
 		 */
 		int mask_shift = (ctx->total_read - recv_len) % sizeof(uint32_t);
-		int i;
 
-		for (i = 0; i < recv_len; i++) {
-			buf[i] ^= ctx->masking_value >>
-				(8 * (3 - (i + mask_shift) % 4));
-		}
+		websocket_mask_data(buf, buf, recv_len, ctx->masking_value,
+				    mask_shift);
 	}
 
 #if HEXDUMP_RECV_PACKETS
@@ -24,6 +24,17 @@ extern int settings_fcb_src(struct settings_fcb *cf);
 extern int settings_fcb_dst(struct settings_fcb *cf);
 void settings_mount_fcb_backend(struct settings_fcb *cf);
 
+/**
+ * Compact the FCB backend. Every sector holding data is rewritten so that
+ * only the latest value of each setting is left, which makes the following
+ * loads faster.
+ *
+ * @param cf FCB backend to compact.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+int settings_fcb_compact(struct settings_fcb *cf);
+
 #ifdef __cplusplus
 }
 #endif
@@ -38,6 +38,16 @@ struct settings_nvs {
 	struct nvs_fs cf_nvs;
 	uint16_t last_name_id;
 	const char *flash_dev_name;
+#if defined(CONFIG_SETTINGS_NVS_NAME_CACHE)
+	/* hash table of the name ids, indexed by the hash of the name */
+	struct {
+		uint32_t name_hash;
+		uint16_t name_id;
+	} cache[CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE];
+	uint16_t cache_count;	/* names in the cache */
+	bool cache_loaded;	/* all the stored names were added */
+	bool cache_full;	/* some names did not fit in the cache */
+#endif
 };
 
 /* register nvs to be a source of settings */
@@ -10,6 +10,7 @@
 #include <fs/fcb.h>
 #include <string.h>
 #include <assert.h>
+#include <sys/crc.h>
 
 #include "settings/settings.h"
 #include "settings/settings_fcb.h"
@@ -20,6 +21,8 @@ LOG_MODULE_DECLARE(settings, CONFIG_SETTINGS_LOG_LEVEL);
 
 #define SETTINGS_FCB_VERS		1
 
+extern struct k_mutex settings_lock;
+
 int settings_backend_init(void);
 void settings_mount_fcb_backend(struct settings_fcb *cf);
 
@@ -114,6 +117,138 @@ static bool settings_fcb_check_duplicate(struct settings_fcb *cf,
 	return false;
 }
 
+#if defined(CONFIG_SETTINGS_FCB_INDEX)
+
+BUILD_ASSERT((CONFIG_SETTINGS_FCB_INDEX_SIZE &
+	      (CONFIG_SETTINGS_FCB_INDEX_SIZE - 1)) == 0,
+	     "FCB index size must be a power of two");
+
+/* Location of the latest entry of a name. The index is rebuilt whenever it
+ * is needed and used with settings_lock held.
+ */
+struct settings_fcb_index_entry {
+	struct fcb_entry loc;	/* fe_sector is NULL in unused slots */
+	uint32_t name_hash;
+	bool collision;		/* different names share the hash */
+};
+
+static struct settings_fcb_index_entry
+	settings_fcb_index[CONFIG_SETTINGS_FCB_INDEX_SIZE];
+
+static struct settings_fcb_index_entry *settings_fcb_index_slot(
+	const char *name, bool insert)
+{
+	uint32_t hash = crc32_ieee((const uint8_t *)name, strlen(name));
+	uint32_t pos = hash & (CONFIG_SETTINGS_FCB_INDEX_SIZE - 1);
+	struct settings_fcb_index_entry *slot;
+	int i;
+
+	for (i = 0; i < CONFIG_SETTINGS_FCB_INDEX_SIZE; i++) {
+		slot = &settings_fcb_index[pos];
+
+		if (!slot->loc.fe_sector) {
+			if (!insert) {
+				return NULL;
+			}
+			slot->name_hash = hash;
+			return slot;
+		}
+
+		if (slot->name_hash == hash) {
+			return slot;
+		}
+
+		pos = (pos + 1) & (CONFIG_SETTINGS_FCB_INDEX_SIZE - 1);
+	}
+
+	/* Index is full, the names left out are checked the slow way */
+	return NULL;
+}
+
+static void settings_fcb_index_build(struct settings_fcb *cf)
+{
+	struct fcb_entry_ctx entry_ctx = {
+		{.fe_sector = NULL, .fe_elem_off = 0},
+		.fap = cf->cf_fcb.fap
+	};
+	struct fcb_entry_ctx prev_ctx = {
+		.fap = cf->cf_fcb.fap
+	};
+	struct settings_fcb_index_entry *slot;
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	char prev_name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t name_len, prev_len;
+	int rc;
+
+	(void)memset(settings_fcb_index, 0, sizeof(settings_fcb_index));
+
+	while (fcb_getnext(&cf->cf_fcb, &entry_ctx.loc) == 0) {
+		rc = settings_line_name_read(name, sizeof(name), &name_len,
+					     &entry_ctx);
+		if (rc) {
+			continue;
+		}
+		name[name_len] = '\0';
+
+		slot = settings_fcb_index_slot(name, true);
+		if (!slot) {
+			continue;
+		}
+
+		if (slot->loc.fe_sector && !slot->collision) {
+			/* Make sure the older entry has the same name */
+			prev_ctx.loc = slot->loc;
+			rc = settings_line_name_read(prev_name,
+						     sizeof(prev_name),
+						     &prev_len, &prev_ctx);
+			if (rc || prev_len != name_len ||
+			    memcmp(prev_name, name, name_len)) {
+				slot->collision = true;
+			}
+		}
+
+		slot->loc = entry_ctx.loc;
+	}
+}
+
+/* Returns 1 if the entry is the latest one of the name, 0 if not and
+ * -EAGAIN if the index does not know.
+ */
+static int settings_fcb_index_is_latest(const struct fcb_entry_ctx *entry_ctx,
+					const char *name)
+{
+	struct settings_fcb_index_entry *slot;
+
+	slot = settings_fcb_index_slot(name, false);
+	if (!slot || slot->collision) {
+		return -EAGAIN;
+	}
+
+	return (slot->loc.fe_sector == entry_ctx->loc.fe_sector &&
+		slot->loc.fe_elem_off == entry_ctx->loc.fe_elem_off);
+}
+
+#endif /* CONFIG_SETTINGS_FCB_INDEX */
+
+/* Check that no newer entry with the same name exists, using the index when
+ * it knows the name.
+ */
+static bool settings_fcb_is_latest(struct settings_fcb *cf,
+				   const struct fcb_entry_ctx *entry_ctx,
+				   const char * const name)
+{
+#if defined(CONFIG_SETTINGS_FCB_INDEX)
+	int rc;
+
+	rc = settings_fcb_index_is_latest(entry_ctx, name);
+	if (rc >= 0) {
+		return rc;
+	}
+#endif
+
+	return !settings_fcb_check_duplicate(cf, entry_ctx, name);
+}
+
 static int read_entry_len(const struct fcb_entry_ctx *entry_ctx, off_t off)
 {
 	if (off >= entry_ctx->loc.fe_data_len) {
@@ -134,6 +269,12 @@ static int settings_fcb_load_priv(struct settings_store *cs,
 	};
 	int rc;
 
+#if defined(CONFIG_SETTINGS_FCB_INDEX)
+	if (filter_duplicates) {
+		settings_fcb_index_build(cf);
+	}
+#endif
+
 	while ((rc = fcb_getnext(&cf->cf_fcb, &entry_ctx.loc)) == 0) {
 		char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
 		size_t name_len;
@@ -150,7 +291,7 @@ static int settings_fcb_load_priv(struct settings_store *cs,
 
 		if (filter_duplicates &&
 		    (!read_entry_len(&entry_ctx, name_len+1) ||
-		     settings_fcb_check_duplicate(cf, &entry_ctx, name))) {
+		     !settings_fcb_is_latest(cf, &entry_ctx, name))) {
 			pass_entry = false;
 		}
 		/*name, val-read_cb-ctx, val-off*/
@@ -193,22 +334,21 @@ static int read_handler(void *ctx, off_t off, char *buf, size_t *len)
 			       *len);
 }
 
-static void settings_fcb_compress(struct settings_fcb *cf)
+static int settings_fcb_compress(struct settings_fcb *cf)
 {
 	int rc;
 	struct fcb_entry_ctx loc1;
 	struct fcb_entry_ctx loc2;
-	char name1[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN];
-	char name2[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN];
-	int copy;
-	uint8_t rbs;
+	char name1[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
 
 	rc = fcb_append_to_scratch(&cf->cf_fcb);
 	if (rc) {
-		return; /* XXX */
+		return rc;
 	}
 
-	rbs = flash_area_align(cf->cf_fcb.fap);
+#if defined(CONFIG_SETTINGS_FCB_INDEX)
+	settings_fcb_index_build(cf);
+#endif
 
 	loc1.fap = cf->cf_fcb.fap;
 
@@ -235,25 +375,9 @@ static void settings_fcb_compress(struct settings_fcb *cf)
 			continue;
 		}
 
-		loc2 = loc1;
-		copy = 1;
-
-		while (fcb_getnext(&cf->cf_fcb, &loc2.loc) == 0) {
-			size_t val2_off;
-
-			rc = settings_line_name_read(name2, sizeof(name2),
-						     &val2_off, &loc2);
-			if (rc) {
-				continue;
-			}
+		name1[val1_off] = '\0';
 
-			if ((val1_off == val2_off) &&
-			    !memcmp(name1, name2, val1_off)) {
-				copy = 0;
-				break;
-			}
-		}
-		if (!copy) {
+		if (!settings_fcb_is_latest(cf, &loc1, name1)) {
 			continue;
 		}
 
@@ -265,6 +389,8 @@ static void settings_fcb_compress(struct settings_fcb *cf)
 			continue;
 		}
 
+		loc2.fap = cf->cf_fcb.fap;
+
 		rc = settings_line_entry_copy(&loc2, 0, &loc1, 0,
 					      loc1.loc.fe_data_len);
 		if (rc) {
@@ -281,6 +407,40 @@ static void settings_fcb_compress(struct settings_fcb *cf)
 	if (rc != 0) {
 		LOG_ERR("Failed to fcb rotate (%d)", rc);
 	}
+
+	return rc;
+}
+
+int settings_fcb_compact(struct settings_fcb *cf)
+{
+	struct flash_sector *last;
+	bool done;
+	int rc = 0;
+	int i;
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+
+	if (fcb_is_empty(&cf->cf_fcb)) {
+		goto end;
+	}
+
+	/* Compress the sectors from the oldest one up to the one that is
+	 * active now, which leaves only the latest entry of every name.
+	 */
+	last = cf->cf_fcb.f_active.fe_sector;
+
+	for (i = 0; i < cf->cf_fcb.f_sector_cnt; i++) {
+		done = (cf->cf_fcb.f_oldest == last);
+
+		rc = settings_fcb_compress(cf);
+		if (rc || done) {
+			break;
+		}
+	}
+
+end:
+	k_mutex_unlock(&settings_lock);
+	return rc;
 }
 
 static size_t get_len_cb(void *ctx)
@@ -325,7 +485,7 @@ static int settings_fcb_save_priv(struct settings_store *cs, const char *name,
 
 		/* FCB can compress up to cf->cf_fcb.f_sector_cnt - 1 times. */
 		if (i < (cf->cf_fcb.f_sector_cnt - 1)) {
-			settings_fcb_compress(cf);
+			(void)settings_fcb_compress(cf);
 		}
 	}
 	if (rc) {
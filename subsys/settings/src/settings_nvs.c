@@ -12,6 +12,7 @@
 #include "settings/settings_nvs.h"
 #include "settings_priv.h"
 #include <storage/flash_map.h>
+#include <sys/crc.h>
 
 #include <logging/log.h>
 LOG_MODULE_DECLARE(settings, CONFIG_SETTINGS_LOG_LEVEL);
@@ -48,6 +49,145 @@ static ssize_t settings_nvs_read_fn(void *back_end, void *data, size_t len)
 	return rc;
 }
 
+#if defined(CONFIG_SETTINGS_NVS_NAME_CACHE)
+
+BUILD_ASSERT((CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE &
+	      (CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE - 1)) == 0,
+	     "Name cache size must be a power of two");
+
+/* Name ids are above NVS_NAMECNT_ID, these can be used to mark the cache
+ * slots that were never used and the ones of deleted names.
+ */
+#define NAME_CACHE_EMPTY 0
+#define NAME_CACHE_DELETED NVS_NAMECNT_ID
+
+#define NAME_CACHE_NEXT(pos) \
+	(((pos) + 1) & (CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE - 1))
+
+static uint32_t settings_nvs_cache_hash(const char *name)
+{
+	return crc32_ieee((const uint8_t *)name, strlen(name));
+}
+
+static void settings_nvs_cache_clear(struct settings_nvs *cf)
+{
+	(void)memset(cf->cache, 0, sizeof(cf->cache));
+	cf->cache_count = 0U;
+	cf->cache_loaded = false;
+	cf->cache_full = false;
+}
+
+static void settings_nvs_cache_add(struct settings_nvs *cf, const char *name,
+				   uint16_t name_id)
+{
+	uint32_t hash = settings_nvs_cache_hash(name);
+	uint32_t pos = hash & (CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE - 1);
+	int i;
+
+	for (i = 0; i < CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE; i++) {
+		if (cf->cache[pos].name_id == NAME_CACHE_EMPTY ||
+		    cf->cache[pos].name_id == NAME_CACHE_DELETED) {
+			cf->cache[pos].name_hash = hash;
+			cf->cache[pos].name_id = name_id;
+			cf->cache_count++;
+			return;
+		}
+		pos = NAME_CACHE_NEXT(pos);
+	}
+
+	if (!cf->cache_full) {
+		LOG_WRN("NVS name cache full");
+		cf->cache_full = true;
+	}
+}
+
+static void settings_nvs_cache_del(struct settings_nvs *cf, const char *name,
+				   uint16_t name_id)
+{
+	uint32_t hash = settings_nvs_cache_hash(name);
+	uint32_t pos = hash & (CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE - 1);
+	int i;
+
+	for (i = 0; i < CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE; i++) {
+		if (cf->cache[pos].name_id == NAME_CACHE_EMPTY) {
+			return;
+		}
+		if (cf->cache[pos].name_id == name_id) {
+			/* keep the probe sequences of other names going */
+			cf->cache[pos].name_id = NAME_CACHE_DELETED;
+			cf->cache_count--;
+			return;
+		}
+		pos = NAME_CACHE_NEXT(pos);
+	}
+}
+
+/* Look up the id of a name in the cache, the names with a matching hash are
+ * read from NVS to rule out collisions. Returns 0 if found, -ENOENT if the
+ * name is not stored and -EAGAIN if the cache can not tell.
+ */
+static int settings_nvs_cache_find(struct settings_nvs *cf, const char *name,
+				   uint16_t *name_id)
+{
+	char rdname[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	uint32_t hash = settings_nvs_cache_hash(name);
+	uint32_t pos = hash & (CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE - 1);
+	uint16_t id;
+	ssize_t rc;
+	int i;
+
+	for (i = 0; i < CONFIG_SETTINGS_NVS_NAME_CACHE_SIZE; i++) {
+		id = cf->cache[pos].name_id;
+		if (id == NAME_CACHE_EMPTY) {
+			break;
+		}
+
+		if (id != NAME_CACHE_DELETED &&
+		    cf->cache[pos].name_hash == hash) {
+			rc = nvs_read(&cf->cf_nvs, id, &rdname,
+				      sizeof(rdname) - 1);
+			if (rc > 0) {
+				rdname[MIN(rc, sizeof(rdname) - 1)] = '\0';
+				if (!strcmp(name, rdname)) {
+					*name_id = id;
+					return 0;
+				}
+			}
+		}
+		pos = NAME_CACHE_NEXT(pos);
+	}
+
+	if (!cf->cache_loaded || cf->cache_full) {
+		return -EAGAIN;
+	}
+
+	return -ENOENT;
+}
+
+#else
+
+static inline void settings_nvs_cache_clear(struct settings_nvs *cf)
+{
+}
+
+static inline void settings_nvs_cache_add(struct settings_nvs *cf,
+					  const char *name, uint16_t name_id)
+{
+}
+
+static inline void settings_nvs_cache_del(struct settings_nvs *cf,
+					  const char *name, uint16_t name_id)
+{
+}
+
+static inline int settings_nvs_cache_find(struct settings_nvs *cf,
+					  const char *name, uint16_t *name_id)
+{
+	return -EAGAIN;
+}
+
+#endif /* CONFIG_SETTINGS_NVS_NAME_CACHE */
+
 int settings_nvs_src(struct settings_nvs *cf)
 {
 	cf->cf_store.cs_itf = &settings_nvs_itf;
@@ -77,6 +217,9 @@ static int settings_nvs_load(struct settings_store *cs,
 
 	name_id = cf->last_name_id + 1;
 
+	/* All the names are read here, rebuild the name cache from them */
+	settings_nvs_cache_clear(cf);
+
 	while (1) {
 
 		name_id--;
@@ -114,6 +257,8 @@ static int settings_nvs_load(struct settings_store *cs,
 
 		/* Found a name, this might not include a trailing \0 */
 		name[rc1] = '\0';
+		settings_nvs_cache_add(cf, name, name_id);
+
 		read_fn_arg.fs = &cf->cf_nvs;
 		read_fn_arg.id = name_id + NVS_NAME_ID_OFFSET;
 
@@ -125,51 +270,89 @@ static int settings_nvs_load(struct settings_store *cs,
 			break;
 		}
 	}
+
+#if defined(CONFIG_SETTINGS_NVS_NAME_CACHE)
+	cf->cache_loaded = (ret == 0);
+#endif
+
 	return ret;
 }
 
-static int settings_nvs_save(struct settings_store *cs, const char *name,
-			     const char *value, size_t val_len)
+/* Find the id a name is stored at. Returns 0 if found, -ENOENT if not. When
+ * the name is not found free_id is set to the lowest unused id.
+ */
+static int settings_nvs_find(struct settings_nvs *cf, const char *name,
+			     uint16_t *name_id, uint16_t *free_id)
 {
-	struct settings_nvs *cf = (struct settings_nvs *)cs;
 	char rdname[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
-	uint16_t name_id, write_name_id;
-	bool delete, write_name;
-	int rc = 0;
+	uint16_t id;
+	int rc;
 
-	if (!name) {
-		return -EINVAL;
+	*free_id = cf->last_name_id + 1;
+
+	rc = settings_nvs_cache_find(cf, name, name_id);
+	if (rc == 0) {
+		return 0;
 	}
 
-	/* Find out if we are doing a delete */
-	delete = ((value == NULL) || (val_len == 0));
+#if defined(CONFIG_SETTINGS_NVS_NAME_CACHE)
+	/* Without unused ids below last_name_id a new name goes to the end,
+	 * otherwise search for the unused ids below.
+	 */
+	if (rc == -ENOENT &&
+	    cf->cache_count == (uint16_t)(cf->last_name_id - NVS_NAMECNT_ID)) {
+		return -ENOENT;
+	}
+#endif
 
-	name_id = cf->last_name_id + 1;
-	write_name_id = cf->last_name_id + 1;
-	write_name = true;
+	id = cf->last_name_id + 1;
 
 	while (1) {
-		name_id--;
-		if (name_id == NVS_NAMECNT_ID) {
+		id--;
+		if (id == NVS_NAMECNT_ID) {
 			break;
 		}
 
-		rc = nvs_read(&cf->cf_nvs, name_id, &rdname, sizeof(rdname));
+		rc = nvs_read(&cf->cf_nvs, id, &rdname, sizeof(rdname));
 
 		if (rc < 0) {
 			/* Error or entry not found */
 			if (rc == -ENOENT) {
-				write_name_id = name_id;
+				*free_id = id;
 			}
 			continue;
 		}
 
 		rdname[rc] = '\0';
 
-		if (strcmp(name, rdname)) {
-			continue;
+		if (!strcmp(name, rdname)) {
+			*name_id = id;
+			return 0;
 		}
+	}
+
+	return -ENOENT;
+}
+
+static int settings_nvs_save(struct settings_store *cs, const char *name,
+			     const char *value, size_t val_len)
+{
+	struct settings_nvs *cf = (struct settings_nvs *)cs;
+	uint16_t name_id, write_name_id;
+	bool delete, write_name;
+	int rc = 0;
 
+	if (!name) {
+		return -EINVAL;
+	}
+
+	/* Find out if we are doing a delete */
+	delete = ((value == NULL) || (val_len == 0));
+
+	write_name = true;
+
+	rc = settings_nvs_find(cf, name, &name_id, &write_name_id);
+	if (rc == 0) {
 		if ((delete) && (name_id == cf->last_name_id)) {
 			cf->last_name_id--;
 			rc = nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID,
@@ -194,11 +377,12 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 				return rc;
 			}
 
+			settings_nvs_cache_del(cf, name, name_id);
+
 			return 0;
 		}
 		write_name_id = name_id;
 		write_name = false;
-		break;
 	}
 
 	if (delete) {
@@ -220,6 +404,7 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 		if (rc < 0) {
 			return rc;
 		}
+		settings_nvs_cache_add(cf, name, write_name_id);
 	}
 
 	/* update the last_name_id and write to flash if required*/
@@ -247,6 +432,8 @@ int settings_nvs_backend_init(struct settings_nvs *cf)
 		return rc;
 	}
 
+	settings_nvs_cache_clear(cf);
+
 	rc = nvs_read(&cf->cf_nvs, NVS_NAMECNT_ID, &last_name_id,
 		      sizeof(last_name_id));
 	if (rc < 0) {
@@ -125,6 +125,17 @@ extern sys_slist_t settings_load_srcs;
 extern sys_slist_t settings_handlers;
 extern struct settings_store *settings_save_dst;
 
+#if defined(CONFIG_SETTINGS_WRITE_BACK)
+void settings_wb_init(void);
+
+/* Buffer a setting to be written to cs later */
+int settings_wb_save(struct settings_store *cs, const char *name,
+		     const void *value, size_t val_len);
+
+/* Write the buffered settings to cs */
+int settings_wb_flush(struct settings_store *cs);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -54,6 +54,10 @@ int settings_load_subtree(const char *subtree)
 	 *    commit all
 	 */
 	k_mutex_lock(&settings_lock, K_FOREVER);
+#if defined(CONFIG_SETTINGS_WRITE_BACK)
+	/* the sources must see the buffered values */
+	(void)settings_wb_flush(settings_save_dst);
+#endif
 	SYS_SLIST_FOR_EACH_CONTAINER(&settings_load_srcs, cs, cs_next) {
 		cs->cs_itf->csi_load(cs, &arg);
 	}
@@ -81,6 +85,10 @@ int settings_load_subtree_direct(
 	 *    commit all
 	 */
 	k_mutex_lock(&settings_lock, K_FOREVER);
+#if defined(CONFIG_SETTINGS_WRITE_BACK)
+	/* the sources must see the buffered values */
+	(void)settings_wb_flush(settings_save_dst);
+#endif
 	SYS_SLIST_FOR_EACH_CONTAINER(&settings_load_srcs, cs, cs_next) {
 		cs->cs_itf->csi_load(cs, &arg);
 	}
@@ -103,7 +111,11 @@ int settings_save_one(const char *name, const void *value, size_t val_len)
 
 	k_mutex_lock(&settings_lock, K_FOREVER);
 
+#if defined(CONFIG_SETTINGS_WRITE_BACK)
+	rc = settings_wb_save(cs, name, value, val_len);
+#else
 	rc = cs->cs_itf->csi_save(cs, name, (char *)value, val_len);
+#endif
 
 	k_mutex_unlock(&settings_lock);
 
@@ -115,6 +127,19 @@ int settings_delete(const char *name)
 	return settings_save_one(name, NULL, 0);
 }
 
+int settings_flush(void)
+{
+	int rc = 0;
+
+#if defined(CONFIG_SETTINGS_WRITE_BACK)
+	k_mutex_lock(&settings_lock, K_FOREVER);
+	rc = settings_wb_flush(settings_save_dst);
+	k_mutex_unlock(&settings_lock);
+#endif
+
+	return rc;
+}
+
 int settings_save(void)
 {
 	struct settings_store *cs;
@@ -152,6 +177,11 @@ int settings_save(void)
 	}
 #endif /* CONFIG_SETTINGS_DYNAMIC_HANDLERS */
 
+	rc2 = settings_flush();
+	if (!rc) {
+		rc = rc2;
+	}
+
 	if (cs->cs_itf->csi_save_end) {
 		cs->cs_itf->csi_save_end(cs);
 	}
@@ -161,4 +191,7 @@ int settings_save(void)
 void settings_store_init(void)
 {
 	sys_slist_init(&settings_load_srcs);
+#if defined(CONFIG_SETTINGS_WRITE_BACK)
+	settings_wb_init();
+#endif
 }
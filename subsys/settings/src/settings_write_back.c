@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <kernel.h>
+#include <stats/stats.h>
+
+#include "settings/settings.h"
+#include "settings_priv.h"
+
+#include <logging/log.h>
+LOG_MODULE_DECLARE(settings, CONFIG_SETTINGS_LOG_LEVEL);
+
+extern struct k_mutex settings_lock;
+
+/* A setting waiting to be written, a delete has val_len 0 */
+struct settings_wb_entry {
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	uint8_t value[CONFIG_SETTINGS_WRITE_BACK_VAL_LEN];
+	uint16_t val_len;
+	bool dirty;
+};
+
+static struct settings_wb_entry wb_entries[CONFIG_SETTINGS_WRITE_BACK_ENTRIES];
+static uint8_t wb_dirty_count;
+static struct k_delayed_work wb_work;
+
+STATS_SECT_START(settings_wb_stats)
+STATS_SECT_ENTRY32(saves)	/* settings saved or deleted */
+STATS_SECT_ENTRY32(writes)	/* settings written to the backend */
+STATS_SECT_ENTRY32(coalesced)	/* updates replacing a buffered value */
+STATS_SECT_ENTRY32(flushes)	/* writes of the buffer */
+STATS_SECT_END;
+
+STATS_SECT_DECL(settings_wb_stats) settings_wb_stats;
+
+STATS_NAME_START(settings_wb_stats)
+STATS_NAME(settings_wb_stats, saves)
+STATS_NAME(settings_wb_stats, writes)
+STATS_NAME(settings_wb_stats, coalesced)
+STATS_NAME(settings_wb_stats, flushes)
+STATS_NAME_END(settings_wb_stats);
+
+static int settings_wb_write(struct settings_store *cs, const char *name,
+			     const void *value, size_t val_len)
+{
+	STATS_INC(settings_wb_stats, writes);
+
+	return cs->cs_itf->csi_save(cs, name, (char *)value, val_len);
+}
+
+static void settings_wb_schedule(void)
+{
+	if (CONFIG_SETTINGS_WRITE_BACK_DELAY > 0) {
+		k_delayed_work_submit(&wb_work,
+				      K_MSEC(CONFIG_SETTINGS_WRITE_BACK_DELAY));
+	}
+}
+
+/* Write all the buffered settings, settings_lock must be held. */
+int settings_wb_flush(struct settings_store *cs)
+{
+	struct settings_wb_entry *entry;
+	int rc = 0, rc2, i;
+
+	if (wb_dirty_count == 0U) {
+		return 0;
+	}
+
+	if (!cs) {
+		return -ENOENT;
+	}
+
+	(void)k_delayed_work_cancel(&wb_work);
+
+	STATS_INC(settings_wb_stats, flushes);
+
+	for (i = 0; i < ARRAY_SIZE(wb_entries); i++) {
+		entry = &wb_entries[i];
+		if (!entry->dirty) {
+			continue;
+		}
+
+		rc2 = settings_wb_write(cs, entry->name,
+					entry->val_len ? entry->value : NULL,
+					entry->val_len);
+		if (rc2) {
+			LOG_ERR("Cannot write %s (%d)", entry->name, rc2);
+			if (!rc) {
+				rc = rc2;
+			}
+			continue;
+		}
+
+		entry->dirty = false;
+		wb_dirty_count--;
+	}
+
+	if (wb_dirty_count) {
+		/* try again later */
+		settings_wb_schedule();
+	}
+
+	return rc;
+}
+
+/* Buffer a setting, settings_lock must be held. */
+int settings_wb_save(struct settings_store *cs, const char *name,
+		     const void *value, size_t val_len)
+{
+	struct settings_wb_entry *entry = NULL, *free_entry = NULL;
+	int i;
+
+	if (value == NULL && val_len) {
+		return -EINVAL;
+	}
+
+	STATS_INC(settings_wb_stats, saves);
+
+	for (i = 0; i < ARRAY_SIZE(wb_entries); i++) {
+		if (!wb_entries[i].dirty) {
+			if (!free_entry) {
+				free_entry = &wb_entries[i];
+			}
+		} else if (!strcmp(wb_entries[i].name, name)) {
+			entry = &wb_entries[i];
+			break;
+		}
+	}
+
+	if (val_len > sizeof(wb_entries[0].value) ||
+	    strlen(name) >= sizeof(wb_entries[0].name) ||
+	    (!entry && !free_entry)) {
+		/* Can not buffer this one. An older buffered value must not
+		 * overwrite it later.
+		 */
+		if (entry) {
+			entry->dirty = false;
+			wb_dirty_count--;
+			STATS_INC(settings_wb_stats, coalesced);
+		}
+
+		return settings_wb_write(cs, name, value, val_len);
+	}
+
+	if (entry) {
+		STATS_INC(settings_wb_stats, coalesced);
+	} else {
+		entry = free_entry;
+		strcpy(entry->name, name);
+		entry->dirty = true;
+		if (wb_dirty_count++ == 0U) {
+			settings_wb_schedule();
+		}
+	}
+
+	if (val_len) {
+		memcpy(entry->value, value, val_len);
+	}
+	entry->val_len = val_len;
+
+	if (wb_dirty_count >= CONFIG_SETTINGS_WRITE_BACK_THRESHOLD) {
+		return settings_wb_flush(cs);
+	}
+
+	return 0;
+}
+
+static void settings_wb_work_handler(struct k_work *work)
+{
+	int rc;
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+	rc = settings_wb_flush(settings_save_dst);
+	k_mutex_unlock(&settings_lock);
+
+	if (rc) {
+		LOG_ERR("Write-back failed (%d)", rc);
+	}
+}
+
+void settings_wb_init(void)
+{
+	int rc;
+
+	k_delayed_work_init(&wb_work, settings_wb_work_handler);
+
+	rc = STATS_INIT_AND_REG(settings_wb_stats, STATS_SIZE_32,
+				"settings_wb_stats");
+	if (rc) {
+		LOG_ERR("Cannot register stats (%d)", rc);
+	}
+}
@@ -171,6 +171,86 @@ static int cmd_kernel_stacks(const struct shell *shell,
 }
 #endif
 
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+/* Threads beyond this count are left out of the list, not of the total */
+#define USAGE_MAX_THREADS 32
+
+struct thread_usage {
+	struct k_thread *thread;
+	uint64_t cycles;
+};
+
+static struct {
+	struct thread_usage entries[USAGE_MAX_THREADS];
+	int count;
+	uint64_t total;
+} usage;
+
+static void shell_usage_collect(const struct k_thread *cthread,
+				void *user_data)
+{
+	struct k_thread *thread = (struct k_thread *)cthread;
+	k_thread_runtime_stats_t stats;
+	int i;
+
+	ARG_UNUSED(user_data);
+
+	(void)k_thread_runtime_stats_get(thread, &stats);
+	usage.total += stats.execution_cycles;
+
+	/* Keep the entries sorted by decreasing usage */
+	if (usage.count < USAGE_MAX_THREADS) {
+		i = usage.count++;
+	} else if (stats.execution_cycles >
+		   usage.entries[USAGE_MAX_THREADS - 1].cycles) {
+		i = USAGE_MAX_THREADS - 1;
+	} else {
+		return;
+	}
+
+	while (i > 0 && usage.entries[i - 1].cycles < stats.execution_cycles) {
+		usage.entries[i] = usage.entries[i - 1];
+		i--;
+	}
+
+	usage.entries[i].thread = thread;
+	usage.entries[i].cycles = stats.execution_cycles;
+}
+
+static int cmd_kernel_usage(const struct shell *shell,
+			    size_t argc, char **argv)
+{
+	struct thread_usage *entry;
+	const char *tname;
+	unsigned int share;
+	int i;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	usage.count = 0;
+	usage.total = 0;
+	k_thread_foreach(shell_usage_collect, NULL);
+
+	shell_print(shell, "Threads by CPU usage:");
+
+	for (i = 0; i < usage.count; i++) {
+		entry = &usage.entries[i];
+		tname = k_thread_name_get(entry->thread);
+		share = usage.total ?
+			(unsigned int)(entry->cycles * 1000U / usage.total) : 0;
+
+		shell_print(shell, "%s%p %-20s %10u ms %3u.%u %%",
+			    (entry->thread == k_current_get()) ? "*" : " ",
+			    entry->thread, tname ? tname : "NA",
+			    (uint32_t)k_cyc_to_ms_floor64(entry->cycles),
+			    share / 10U, share % 10U);
+	}
+
+	return 0;
+}
+#endif
+
 #if defined(CONFIG_REBOOT)
 static int cmd_kernel_reboot_warm(const struct shell *shell,
 				  size_t argc, char **argv)
@@ -208,6 +288,9 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_kernel,
 	SHELL_CMD(threads, NULL, "List kernel threads.", cmd_kernel_threads),
 #endif
 	SHELL_CMD(uptime, NULL, "Kernel uptime.", cmd_kernel_uptime),
+#if defined(CONFIG_THREAD_RUNTIME_STATS) && defined(CONFIG_THREAD_MONITOR)
+	SHELL_CMD(usage, NULL, "List threads by CPU usage.", cmd_kernel_usage),
+#endif
 	SHELL_CMD(version, NULL, "Kernel version.", cmd_kernel_version),
 	SHELL_SUBCMD_SET_END /* Array terminated. */
 );
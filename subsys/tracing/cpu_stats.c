@@ -4,104 +4,211 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <errno.h>
 #include <tracing_cpu_stats.h>
 #include <sys/printk.h>
 #include <kernel_internal.h>
 #include <ksched.h>
 
 enum cpu_state {
+	CPU_STATE_SCHEDULER,
 	CPU_STATE_IDLE,
 	CPU_STATE_NON_IDLE,
-	CPU_STATE_SCHEDULER
+	CPU_STATE_ISR
 };
 
-static enum cpu_state last_cpu_state = CPU_STATE_SCHEDULER;
-static enum cpu_state cpu_state_before_interrupts;
+struct cpu_stats_cpu {
+	enum cpu_state last_cpu_state;
+	enum cpu_state cpu_state_before_interrupts;
+	uint32_t last_time;
+	int nested_interrupts;
+	struct k_thread *current_thread;
+	struct cpu_stats stats_hw_tick;
+};
 
-static uint32_t last_time;
-static struct cpu_stats stats_hw_tick;
-static int nested_interrupts;
-static struct k_thread *current_thread;
+static struct cpu_stats_cpu cpus[CONFIG_MP_NUM_CPUS];
 
-void update_counter(volatile uint64_t *cnt)
+static uint32_t update_counter(struct cpu_stats_cpu *cpu,
+			       volatile uint64_t *cnt)
 {
 	uint32_t time = k_cycle_get_32();
+	uint32_t elapsed = time - cpu->last_time;
 
-	if (time >= last_time) {
-		(*cnt) += (time - last_time);
-	} else {
-		(*cnt) += (UINT32_MAX - last_time + 1 + time);
-	}
-	last_time = time;
+	(*cnt) += elapsed;
+	cpu->last_time = time;
+
+	return elapsed;
 }
 
-static void cpu_stats_update_counters(void)
+static void cpu_stats_update_counters(struct cpu_stats_cpu *cpu)
 {
-	switch (last_cpu_state) {
+	uint32_t elapsed = 0U;
+
+	switch (cpu->last_cpu_state) {
 	case CPU_STATE_IDLE:
-		update_counter(&stats_hw_tick.idle);
+		elapsed = update_counter(cpu, &cpu->stats_hw_tick.idle);
 		break;
 
 	case CPU_STATE_NON_IDLE:
-		update_counter(&stats_hw_tick.non_idle);
+		elapsed = update_counter(cpu, &cpu->stats_hw_tick.non_idle);
 		break;
 
+	case CPU_STATE_ISR:
+		/* interrupts are accounted as non idle time too */
+		cpu->stats_hw_tick.non_idle +=
+			update_counter(cpu, &cpu->stats_hw_tick.isr);
+		return;
+
 	case CPU_STATE_SCHEDULER:
-		update_counter(&stats_hw_tick.sched);
-		break;
+		update_counter(cpu, &cpu->stats_hw_tick.sched);
+		return;
 
 	default:
 		/* Invalid CPU state */
 		__ASSERT_NO_MSG(false);
-		break;
+		return;
+	}
+
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	if (cpu->current_thread != NULL) {
+		cpu->current_thread->rt_stats.execution_cycles += elapsed;
 	}
+#else
+	ARG_UNUSED(elapsed);
+#endif
+}
+
+static void cpu_stats_sum(struct cpu_stats *sum)
+{
+	int i;
+
+	sum->idle = 0;
+	sum->non_idle = 0;
+	sum->sched = 0;
+	sum->isr = 0;
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		sum->idle += cpus[i].stats_hw_tick.idle;
+		sum->non_idle += cpus[i].stats_hw_tick.non_idle;
+		sum->sched += cpus[i].stats_hw_tick.sched;
+		sum->isr += cpus[i].stats_hw_tick.isr;
+	}
+}
+
+static void cpu_stats_to_ns(const struct cpu_stats *cycles,
+			    struct cpu_stats *cpu_stats_ns)
+{
+	cpu_stats_ns->idle = k_cyc_to_ns_floor64(cycles->idle);
+	cpu_stats_ns->non_idle = k_cyc_to_ns_floor64(cycles->non_idle);
+	cpu_stats_ns->sched = k_cyc_to_ns_floor64(cycles->sched);
+	cpu_stats_ns->isr = k_cyc_to_ns_floor64(cycles->isr);
 }
 
 void cpu_stats_get_ns(struct cpu_stats *cpu_stats_ns)
 {
+	struct cpu_stats sum;
 	int key = irq_lock();
 
-	cpu_stats_update_counters();
-	cpu_stats_ns->idle = k_cyc_to_ns_floor64(stats_hw_tick.idle);
-	cpu_stats_ns->non_idle = k_cyc_to_ns_floor64(stats_hw_tick.non_idle);
-	cpu_stats_ns->sched = k_cyc_to_ns_floor64(stats_hw_tick.sched);
+	cpu_stats_update_counters(&cpus[_current_cpu->id]);
+	cpu_stats_sum(&sum);
 	irq_unlock(key);
+
+	cpu_stats_to_ns(&sum, cpu_stats_ns);
+}
+
+int cpu_stats_cpu_get_ns(int cpu, struct cpu_stats *cpu_stats_ns)
+{
+	struct cpu_stats cycles;
+	int key;
+
+	if (cpu < 0 || cpu >= CONFIG_MP_NUM_CPUS) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+	if (cpu == _current_cpu->id) {
+		cpu_stats_update_counters(&cpus[cpu]);
+	}
+	cycles = cpus[cpu].stats_hw_tick;
+	irq_unlock(key);
+
+	cpu_stats_to_ns(&cycles, cpu_stats_ns);
+
+	return 0;
 }
 
 uint32_t cpu_stats_non_idle_and_sched_get_percent(void)
 {
+	struct cpu_stats sum;
 	int key = irq_lock();
 
-	cpu_stats_update_counters();
+	cpu_stats_update_counters(&cpus[_current_cpu->id]);
+	cpu_stats_sum(&sum);
 	irq_unlock(key);
-	return ((stats_hw_tick.non_idle + stats_hw_tick.sched) * 100) /
-		(stats_hw_tick.idle + stats_hw_tick.non_idle +
-		 stats_hw_tick.sched);
+	return ((sum.non_idle + sum.sched) * 100) /
+		(sum.idle + sum.non_idle + sum.sched);
 }
 
 void cpu_stats_reset_counters(void)
 {
+	uint32_t time;
 	int key = irq_lock();
+	int i;
+
+	/* The other CPUs keep their last update time, their running
+	 * threads would lose that time otherwise.
+	 */
+	cpu_stats_update_counters(&cpus[_current_cpu->id]);
+	time = k_cycle_get_32();
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		cpus[i].stats_hw_tick.idle = 0;
+		cpus[i].stats_hw_tick.non_idle = 0;
+		cpus[i].stats_hw_tick.sched = 0;
+		cpus[i].stats_hw_tick.isr = 0;
+		if (i == _current_cpu->id) {
+			cpus[i].last_time = time;
+		}
+	}
+	irq_unlock(key);
+}
 
-	stats_hw_tick.idle = 0;
-	stats_hw_tick.non_idle = 0;
-	stats_hw_tick.sched = 0;
-	last_time = k_cycle_get_32();
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+int k_thread_runtime_stats_get(k_tid_t thread,
+			       k_thread_runtime_stats_t *stats)
+{
+	struct cpu_stats_cpu *cpu;
+	int key;
+
+	if (thread == NULL || stats == NULL) {
+		return -EINVAL;
+	}
+
+	key = irq_lock();
+	cpu = &cpus[_current_cpu->id];
+	if (cpu->current_thread == thread) {
+		cpu_stats_update_counters(cpu);
+	}
+	*stats = thread->rt_stats;
 	irq_unlock(key);
+
+	return 0;
 }
+#endif
 
 void sys_trace_thread_switched_in(void)
 {
 	int key = irq_lock();
+	struct cpu_stats_cpu *cpu = &cpus[_current_cpu->id];
 
-	__ASSERT_NO_MSG(nested_interrupts == 0);
+	__ASSERT_NO_MSG(cpu->nested_interrupts == 0);
 
-	cpu_stats_update_counters();
-	current_thread = k_current_get();
-	if (z_is_idle_thread_object(current_thread)) {
-		last_cpu_state = CPU_STATE_IDLE;
+	cpu_stats_update_counters(cpu);
+	cpu->current_thread = k_current_get();
+	if (z_is_idle_thread_object(cpu->current_thread)) {
+		cpu->last_cpu_state = CPU_STATE_IDLE;
 	} else {
-		last_cpu_state = CPU_STATE_NON_IDLE;
+		cpu->last_cpu_state = CPU_STATE_NON_IDLE;
 	}
 	irq_unlock(key);
 }
@@ -109,36 +216,40 @@ void sys_trace_thread_switched_in(void)
 void sys_trace_thread_switched_out(void)
 {
 	int key = irq_lock();
+	struct cpu_stats_cpu *cpu = &cpus[_current_cpu->id];
 
-	__ASSERT_NO_MSG(nested_interrupts == 0);
-	__ASSERT_NO_MSG(!current_thread || (current_thread == k_current_get()));
+	__ASSERT_NO_MSG(cpu->nested_interrupts == 0);
+	__ASSERT_NO_MSG(!cpu->current_thread ||
+			(cpu->current_thread == k_current_get()));
 
-	cpu_stats_update_counters();
-	last_cpu_state = CPU_STATE_SCHEDULER;
+	cpu_stats_update_counters(cpu);
+	cpu->last_cpu_state = CPU_STATE_SCHEDULER;
 	irq_unlock(key);
 }
 
 void sys_trace_isr_enter(void)
 {
 	int key = irq_lock();
+	struct cpu_stats_cpu *cpu = &cpus[_current_cpu->id];
 
-	if (nested_interrupts == 0) {
-		cpu_stats_update_counters();
-		cpu_state_before_interrupts = last_cpu_state;
-		last_cpu_state = CPU_STATE_NON_IDLE;
+	if (cpu->nested_interrupts == 0) {
+		cpu_stats_update_counters(cpu);
+		cpu->cpu_state_before_interrupts = cpu->last_cpu_state;
+		cpu->last_cpu_state = CPU_STATE_ISR;
 	}
-	nested_interrupts++;
+	cpu->nested_interrupts++;
 	irq_unlock(key);
 }
 
 void sys_trace_isr_exit(void)
 {
 	int key = irq_lock();
+	struct cpu_stats_cpu *cpu = &cpus[_current_cpu->id];
 
-	nested_interrupts--;
-	if (nested_interrupts == 0) {
-		cpu_stats_update_counters();
-		last_cpu_state = cpu_state_before_interrupts;
+	cpu->nested_interrupts--;
+	if (cpu->nested_interrupts == 0) {
+		cpu_stats_update_counters(cpu);
+		cpu->last_cpu_state = cpu->cpu_state_before_interrupts;
 	}
 	irq_unlock(key);
 }
@@ -113,6 +113,53 @@ uint32_t tracing_buffer_get(uint8_t *data, uint32_t size);
  */
 uint32_t tracing_cmd_buffer_alloc(uint8_t **data);
 
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+/**
+ * @brief Put an event in the tracing buffer of the current CPU.
+ *
+ * The event must start with its 32 bit timestamp, which is overwritten with
+ * the time the event is put. No lock shared with the other CPUs is taken.
+ *
+ * @param data Address of the event.
+ * @param size Event size (in bytes), at most 255.
+ * @param was_empty Set to true if the buffer was empty before the put.
+ *
+ * @return true if the event was put, false if it was dropped.
+ */
+bool tracing_cpu_buffer_put(uint8_t *data, uint32_t size, bool *was_empty);
+
+/**
+ * @brief Get the oldest event of all the per-CPU tracing buffers.
+ *
+ * The buffers are merged by the event timestamps. An event is only returned
+ * once no CPU can put an older one, so the events are returned in timestamp
+ * order. Only the tracing thread may call this.
+ *
+ * @param data Address of the output buffer.
+ * @param size Output buffer size (in bytes).
+ *
+ * @return Size of the event, 0 if there is none or if the oldest one must
+ * wait for a put in progress on another CPU.
+ */
+uint32_t tracing_cpu_buffer_get(uint8_t *data, uint32_t size);
+
+/**
+ * @brief Check if all the per-CPU tracing buffers are empty.
+ *
+ * @return true if they are all empty, or false if not.
+ */
+bool tracing_cpu_buffer_is_empty(void);
+
+/**
+ * @brief Get the number of events dropped by a CPU.
+ *
+ * @param cpu CPU index.
+ *
+ * @return Number of events dropped because its buffer was full.
+ */
+uint32_t tracing_cpu_buffer_drops_get(int cpu);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
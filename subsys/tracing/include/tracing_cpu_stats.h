@@ -18,6 +18,8 @@ struct cpu_stats {
 	uint64_t idle;
 	uint64_t non_idle;
 	uint64_t sched;
+	/* part of non_idle spent in interrupts */
+	uint64_t isr;
 };
 
 void sys_trace_thread_switched_in(void);
@@ -27,6 +29,7 @@ void sys_trace_isr_exit(void);
 void sys_trace_idle(void);
 
 void cpu_stats_get_ns(struct cpu_stats *cpu_stats_ns);
+int cpu_stats_cpu_get_ns(int cpu, struct cpu_stats *cpu_stats_ns);
 uint32_t cpu_stats_non_idle_and_sched_get_percent(void);
 void cpu_stats_reset_counters(void);
 
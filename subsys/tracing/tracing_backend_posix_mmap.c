@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <soc.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <kernel.h>
+#include <cmdline.h>
+#include <tracing_backend.h>
+
+#define PACKET_SIZE CONFIG_TRACING_BACKEND_POSIX_MMAP_PACKET_SIZE
+#define WINDOW_SIZE CONFIG_TRACING_BACKEND_POSIX_MMAP_WINDOW_SIZE
+
+#define CTF_MAGIC 0xC1FC1FC1
+
+BUILD_ASSERT((PACKET_SIZE & (PACKET_SIZE - 1)) == 0,
+	     "The packet size must be a power of two");
+BUILD_ASSERT(WINDOW_SIZE % PACKET_SIZE == 0,
+	     "The window size must be a multiple of the packet size");
+
+/* Layout of the packet header and context declared in ctf/tsdl/packet */
+struct ctf_packet_header {
+	uint32_t magic;
+	uint32_t timestamp_begin;
+	uint32_t timestamp_end;
+	uint32_t content_size;
+	uint32_t packet_size;
+	uint32_t events_discarded;
+} __packed;
+
+/* Metadata with the packet definitions, generated by the build */
+static const char ctf_metadata[] = {
+#include "ctf_metadata_packet.inc"
+};
+
+static const char *file_name;
+static int trace_fd = -1;
+
+/* Mapped part of the file, and offset of the mapping in it */
+static uint8_t *window = MAP_FAILED;
+static off_t window_offset;
+
+/* Packet being filled in the window */
+static struct ctf_packet_header *packet;
+static uint32_t packet_used;
+static uint32_t events_discarded;
+
+static void window_map(off_t offset)
+{
+	if (window != MAP_FAILED) {
+		munmap(window, WINDOW_SIZE);
+		window = MAP_FAILED;
+	}
+
+	if (ftruncate(trace_fd, offset + WINDOW_SIZE) == -1) {
+		posix_print_warning("Failed to resize trace file %s: %s\n",
+				    file_name, strerror(errno));
+		return;
+	}
+
+	window = mmap(NULL, WINDOW_SIZE, PROT_WRITE | PROT_READ, MAP_SHARED,
+		      trace_fd, offset);
+	if (window == MAP_FAILED) {
+		posix_print_warning("Failed to mmap trace file %s: %s\n",
+				    file_name, strerror(errno));
+		return;
+	}
+
+	window_offset = offset;
+}
+
+static void packet_start(uint8_t *start)
+{
+	packet = (struct ctf_packet_header *)start;
+	packet->magic = CTF_MAGIC;
+	packet->packet_size = PACKET_SIZE * 8U;
+	packet_used = sizeof(*packet);
+}
+
+/* Sizes are in bits in CTF, the rest of the packet is padding */
+static void packet_close(void)
+{
+	packet->content_size = packet_used * 8U;
+	packet->events_discarded = events_discarded;
+}
+
+static void packet_next(void)
+{
+	uint8_t *next = (uint8_t *)packet + PACKET_SIZE;
+
+	packet_close();
+
+	if (next == window + WINDOW_SIZE) {
+		window_map(window_offset + WINDOW_SIZE);
+		if (window == MAP_FAILED) {
+			packet = NULL;
+			return;
+		}
+
+		next = window;
+	}
+
+	packet_start(next);
+}
+
+static void metadata_write(void)
+{
+	char path[256];
+	const char *sep = strrchr(file_name, '/');
+	int len = sep ? (sep - file_name + 1) : 0;
+	FILE *f;
+
+	snprintf(path, sizeof(path), "%.*smetadata", len, file_name);
+
+	f = fopen(path, "w");
+	if (f == NULL) {
+		posix_print_warning("Failed to create CTF metadata %s\n", path);
+		return;
+	}
+
+	fwrite(ctf_metadata, sizeof(ctf_metadata), 1, f);
+	fclose(f);
+}
+
+static void tracing_backend_posix_mmap_init(void)
+{
+	if (file_name == NULL) {
+		file_name = "channel0_0";
+	}
+
+	trace_fd = open(file_name, O_RDWR | O_CREAT | O_TRUNC, (mode_t)0644);
+	if (trace_fd == -1) {
+		posix_print_warning("Failed to open trace file %s: %s\n",
+				    file_name, strerror(errno));
+		return;
+	}
+
+	metadata_write();
+
+	window_map(0);
+	if (window != MAP_FAILED) {
+		packet_start(window);
+	}
+}
+
+static void tracing_backend_posix_mmap_output(
+		const struct tracing_backend *backend,
+		uint8_t *data, uint32_t length)
+{
+	uint32_t tstamp;
+
+	if (packet == NULL) {
+		return;
+	}
+
+	if (length < sizeof(tstamp) ||
+	    length > PACKET_SIZE - sizeof(*packet)) {
+		events_discarded++;
+		return;
+	}
+
+	if (packet_used + length > PACKET_SIZE) {
+		packet_next();
+		if (packet == NULL) {
+			return;
+		}
+	}
+
+	/* Each event starts with its timestamp */
+	memcpy(&tstamp, data, sizeof(tstamp));
+	if (packet_used == sizeof(*packet)) {
+		packet->timestamp_begin = tstamp;
+	}
+	packet->timestamp_end = tstamp;
+
+	memcpy((uint8_t *)packet + packet_used, data, length);
+	packet_used += length;
+}
+
+const struct tracing_backend_api tracing_backend_posix_mmap_api = {
+	.init = tracing_backend_posix_mmap_init,
+	.output  = tracing_backend_posix_mmap_output
+};
+
+TRACING_BACKEND_DEFINE(tracing_backend_posix_mmap,
+		       tracing_backend_posix_mmap_api);
+
+static void tracing_backend_posix_mmap_cleanup(void)
+{
+	off_t size = window_offset;
+
+	if (packet != NULL) {
+		packet_close();
+		size += (uint8_t *)packet - window + PACKET_SIZE;
+	}
+
+	if (window != MAP_FAILED) {
+		munmap(window, WINDOW_SIZE);
+	}
+
+	if (trace_fd != -1) {
+		/* Drop the unused part of the last window */
+		(void)ftruncate(trace_fd, size);
+		close(trace_fd);
+	}
+}
+
+NATIVE_TASK(tracing_backend_posix_mmap_cleanup, ON_EXIT, 1);
+
+void tracing_backend_posix_mmap_option(void)
+{
+	static struct args_struct_t tracing_backend_option[] = {
+		{
+			.manual = false,
+			.is_mandatory = false,
+			.is_switch = false,
+			.option = "trace-file",
+			.name = "file_name",
+			.type = 's',
+			.dest = (void *)&file_name,
+			.call_when_found = NULL,
+			.descript = "File name for tracing output, the CTF "
+				    "metadata is written in the same "
+				    "directory.",
+		},
+		ARG_TABLE_ENDMARKER
+	};
+
+	native_add_command_line_opts(tracing_backend_option);
+}
+
+NATIVE_TASK(tracing_backend_posix_mmap_option, PRE_BOOT_1, 1);
@@ -4,7 +4,12 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <string.h>
+#include <kernel.h>
+#include <kernel_structs.h>
+#include <sys/atomic.h>
 #include <sys/ring_buffer.h>
+#include <tracing_buffer.h>
 
 static struct ring_buf tracing_ring_buf;
 static uint8_t tracing_buffer[CONFIG_TRACING_BUFFER_SIZE + 1];
@@ -67,3 +72,189 @@ uint32_t tracing_buffer_space_get(void)
 {
 	return ring_buf_space_get(&tracing_ring_buf);
 }
+
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+#define CPU_BUFFER_SIZE CONFIG_TRACING_BUFFER_SIZE
+#define CPU_BUFFER_MASK (CPU_BUFFER_SIZE - 1)
+
+BUILD_ASSERT((CPU_BUFFER_SIZE & CPU_BUFFER_MASK) == 0,
+	     "Per-CPU tracing buffers need a power of two size");
+
+/* Each record is a length byte followed by the event, which starts with its
+ * 32 bit timestamp.  Only the CPU owning the buffer, with its interrupts
+ * locked, moves head, and only the tracing thread moves tail, so no lock is
+ * shared between the CPUs.  Both are free running byte counts.  putting is
+ * set while the CPU timestamps and adds a record.
+ */
+struct tracing_cpu_buffer {
+	atomic_t head;
+	atomic_t tail;
+	atomic_t drops;
+	atomic_t putting;
+	uint8_t data[CPU_BUFFER_SIZE];
+};
+
+static struct tracing_cpu_buffer cpu_buffers[CONFIG_MP_NUM_CPUS];
+
+static void cpu_buffer_copy_in(struct tracing_cpu_buffer *buf, uint32_t pos,
+			       const uint8_t *data, uint32_t size)
+{
+	uint32_t offset = pos & CPU_BUFFER_MASK;
+	uint32_t first = MIN(size, CPU_BUFFER_SIZE - offset);
+
+	memcpy(&buf->data[offset], data, first);
+	memcpy(&buf->data[0], data + first, size - first);
+}
+
+static void cpu_buffer_copy_out(struct tracing_cpu_buffer *buf, uint32_t pos,
+				uint8_t *data, uint32_t size)
+{
+	uint32_t offset = pos & CPU_BUFFER_MASK;
+	uint32_t first = MIN(size, CPU_BUFFER_SIZE - offset);
+
+	memcpy(data, &buf->data[offset], first);
+	memcpy(data + first, &buf->data[0], size - first);
+}
+
+bool tracing_cpu_buffer_put(uint8_t *data, uint32_t size, bool *was_empty)
+{
+	struct tracing_cpu_buffer *buf;
+	uint32_t head, tail, tstamp;
+	uint8_t length = size;
+	unsigned int key;
+	bool ret = false;
+
+	/* Only the local interrupts are locked, irq_lock() would take the
+	 * global lock on SMP.
+	 */
+	key = arch_irq_lock();
+	buf = &cpu_buffers[_current_cpu->id];
+
+	/* The event is timestamped again once the interrupts are locked, so
+	 * the records of a buffer are in timestamp order.  The put is
+	 * announced before, see tracing_cpu_buffer_get().
+	 */
+	atomic_set(&buf->putting, 1);
+	tstamp = k_cycle_get_32();
+
+	head = (uint32_t)atomic_get(&buf->head);
+	tail = (uint32_t)atomic_get(&buf->tail);
+	*was_empty = (head == tail);
+
+	if (size < sizeof(uint32_t) || size > UINT8_MAX ||
+	    CPU_BUFFER_SIZE - (head - tail) < size + 1) {
+		atomic_inc(&buf->drops);
+		goto out;
+	}
+
+	cpu_buffer_copy_in(buf, head, &length, 1);
+	cpu_buffer_copy_in(buf, head + 1, (uint8_t *)&tstamp, sizeof(tstamp));
+	cpu_buffer_copy_in(buf, head + 1 + sizeof(tstamp),
+			   data + sizeof(tstamp), size - sizeof(tstamp));
+
+	/* Publish the record once it is complete */
+	atomic_set(&buf->head, head + 1 + size);
+	ret = true;
+
+out:
+	atomic_set(&buf->putting, 0);
+	arch_irq_unlock(key);
+	return ret;
+}
+
+/* Timestamp of the oldest record of a buffer, false if it is empty */
+static bool cpu_buffer_peek(struct tracing_cpu_buffer *buf, uint32_t *tstamp)
+{
+	uint32_t tail = (uint32_t)atomic_get(&buf->tail);
+
+	if ((uint32_t)atomic_get(&buf->head) == tail) {
+		return false;
+	}
+
+	cpu_buffer_copy_out(buf, tail + 1, (uint8_t *)tstamp, sizeof(*tstamp));
+
+	return true;
+}
+
+/* The oldest record is only given out when no CPU can still put an older
+ * one.  A CPU with records is bounded by its oldest one.  An empty CPU that
+ * is not in the middle of a put takes the timestamp of its next record
+ * after now was read, so now is its watermark.  An empty CPU in the middle
+ * of a put holds back all the records until the put is done.
+ */
+uint32_t tracing_cpu_buffer_get(uint8_t *data, uint32_t size)
+{
+	struct tracing_cpu_buffer *buf, *oldest = NULL;
+	uint32_t tstamp, oldest_tstamp = 0;
+	uint32_t now, tail;
+	bool idle_cpu = false;
+	uint8_t length;
+	int i;
+
+	now = k_cycle_get_32();
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		buf = &cpu_buffers[i];
+
+		/* putting must be read before head, a put that starts
+		 * after this read gets a timestamp later than now.
+		 */
+		if (atomic_get(&buf->putting)) {
+			if (!cpu_buffer_peek(buf, &tstamp)) {
+				return 0;
+			}
+		} else if (!cpu_buffer_peek(buf, &tstamp)) {
+			idle_cpu = true;
+			continue;
+		}
+
+		/* The timestamps wrap around */
+		if (oldest == NULL || (int32_t)(tstamp - oldest_tstamp) < 0) {
+			oldest = buf;
+			oldest_tstamp = tstamp;
+		}
+	}
+
+	/* A record put after now was read waits for the next call */
+	if (oldest == NULL ||
+	    (idle_cpu && (int32_t)(oldest_tstamp - now) > 0)) {
+		return 0;
+	}
+
+	tail = (uint32_t)atomic_get(&oldest->tail);
+	cpu_buffer_copy_out(oldest, tail, &length, 1);
+
+	if (length <= size) {
+		cpu_buffer_copy_out(oldest, tail + 1, data, length);
+	} else {
+		atomic_inc(&oldest->drops);
+	}
+
+	atomic_set(&oldest->tail, tail + 1 + length);
+
+	return (length <= size) ? length : 0;
+}
+
+bool tracing_cpu_buffer_is_empty(void)
+{
+	int i;
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		if (atomic_get(&cpu_buffers[i].head) !=
+		    atomic_get(&cpu_buffers[i].tail)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+uint32_t tracing_cpu_buffer_drops_get(int cpu)
+{
+	if (cpu < 0 || cpu >= CONFIG_MP_NUM_CPUS) {
+		return 0;
+	}
+
+	return (uint32_t)atomic_get(&cpu_buffers[cpu].drops);
+}
+#endif /* CONFIG_TRACING_PER_CPU_BUFFERS */
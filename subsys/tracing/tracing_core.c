@@ -22,6 +22,8 @@
 #define TRACING_BACKEND_NAME "tracing_backend_usb"
 #elif defined CONFIG_TRACING_BACKEND_POSIX
 #define TRACING_BACKEND_NAME "tracing_backend_posix"
+#elif defined CONFIG_TRACING_BACKEND_POSIX_MMAP
+#define TRACING_BACKEND_NAME "tracing_backend_posix_mmap"
 #else
 #define TRACING_BACKEND_NAME ""
 #endif
@@ -45,6 +47,24 @@ static K_SEM_DEFINE(tracing_thread_sem, 0, 1);
 static K_THREAD_STACK_DEFINE(tracing_thread_stack,
 			CONFIG_TRACING_THREAD_STACK_SIZE);
 
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+/* Emit the events of the per-CPU buffers, oldest first */
+static void tracing_cpu_buffers_output(void)
+{
+	static uint8_t event[UINT8_MAX];
+	uint32_t length;
+
+	while (true) {
+		length = tracing_cpu_buffer_get(event, sizeof(event));
+		if (length == 0) {
+			break;
+		}
+
+		tracing_buffer_handle(event, length);
+	}
+}
+#endif
+
 static void tracing_thread_func(void *dummy1, void *dummy2, void *dummy3)
 {
 	uint8_t *transferring_buf;
@@ -55,7 +75,16 @@ static void tracing_thread_func(void *dummy1, void *dummy2, void *dummy3)
 	tracing_buffer_max_length = tracing_buffer_capacity_get();
 
 	while (true) {
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+		tracing_cpu_buffers_output();
+#endif
+
 		if (tracing_buffer_is_empty()) {
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+			if (!tracing_cpu_buffer_is_empty()) {
+				continue;
+			}
+#endif
 			k_sem_take(&tracing_thread_sem, K_FOREVER);
 		} else {
 			transferring_length =
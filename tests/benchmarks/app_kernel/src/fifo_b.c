@@ -10,6 +10,48 @@
 
 #ifdef FIFO_BENCH
 
+#ifdef CONFIG_MSGQ_LOCKFREE
+/**
+ *
+ * @brief Lock-free queue transfer speed test
+ *
+ * @return N/A
+ *
+ * @param q      Queue to test.
+ * @param kind   Kind of the queue, printed in the results.
+ */
+static void lf_queue_test(struct k_msgq_lf *q, const char *kind)
+{
+	char label[64];
+	uint32_t et; /* elapsed time */
+	int i;
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		k_msgq_lf_put(q, data_bench, K_FOREVER);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	snprintf(label, sizeof(label),
+		 "enqueue 4 bytes msg in lock-free %s FIFO", kind);
+	PRINT_F(output_file, FORMAT, label,
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		k_msgq_lf_get(q, data_bench, K_FOREVER);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	snprintf(label, sizeof(label),
+		 "dequeue 4 bytes msg in lock-free %s FIFO", kind);
+	PRINT_F(output_file, FORMAT, label,
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+}
+#endif
+
 /**
  *
  * @brief Queue transfer speed test
@@ -84,6 +126,35 @@ void queue_test(void)
 	PRINT_F(output_file, FORMAT,
 			"enqueue 4 bytes in FIFO to a waiting higher priority task",
 			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
+#ifdef CONFIG_MSGQ_LOCKFREE
+	lf_queue_test(&DEMOQLF_SPSC, "SPSC");
+	lf_queue_test(&DEMOQLF_MPSC, "MPSC");
+
+	k_sem_give(&STARTRCV);
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		k_msgq_lf_put(&DEMOQLF_SPSC, data_bench, K_FOREVER);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT,
+			"enqueue 4 bytes in SPSC FIFO to a waiting higher priority task",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+
+	et = BENCH_START();
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		k_msgq_lf_put(&DEMOQLF_MPSC, data_bench, K_FOREVER);
+	}
+	et = TIME_STAMP_DELTA_GET(et);
+	check_result();
+
+	PRINT_F(output_file, FORMAT,
+			"enqueue 4 bytes in MPSC FIFO to a waiting higher priority task",
+			SYS_CLOCK_HW_CYCLES_TO_NS_AVG(et, NR_OF_FIFO_RUNS));
+#endif
 }
 
 #endif /* FIFO_BENCH */
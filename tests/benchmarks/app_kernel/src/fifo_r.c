@@ -29,6 +29,18 @@ void dequtask(void)
 	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
 		k_msgq_get(&DEMOQX4, &x, K_FOREVER);
 	}
+
+#ifdef CONFIG_MSGQ_LOCKFREE
+	k_sem_take(&STARTRCV, K_FOREVER);
+
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		k_msgq_lf_get(&DEMOQLF_SPSC, &x, K_FOREVER);
+	}
+
+	for (i = 0; i < NR_OF_FIFO_RUNS; i++) {
+		k_msgq_lf_get(&DEMOQLF_MPSC, &x, K_FOREVER);
+	}
+#endif
 }
 
 
@@ -44,6 +44,11 @@ K_MSGQ_DEFINE(DEMOQX4, 4, 500, 4);
 K_MSGQ_DEFINE(MB_COMM, 12, 1, 4);
 K_MSGQ_DEFINE(CH_COMM, 12, 1, 4);
 
+#ifdef CONFIG_MSGQ_LOCKFREE
+K_MSGQ_LF_DEFINE(DEMOQLF_SPSC, 4, 512, 0);
+K_MSGQ_LF_DEFINE(DEMOQLF_MPSC, 4, 512, K_MSGQ_LF_MPSC);
+#endif
+
 K_MEM_SLAB_DEFINE(MAP1, 16, 2, 4);
 
 K_SEM_DEFINE(SEM0, 0, 1);
@@ -137,6 +137,11 @@ extern struct k_msgq DEMOQX4;
 extern struct k_msgq MB_COMM;
 extern struct k_msgq CH_COMM;
 
+#ifdef CONFIG_MSGQ_LOCKFREE
+extern struct k_msgq_lf DEMOQLF_SPSC;
+extern struct k_msgq_lf DEMOQLF_MPSC;
+#endif
+
 extern struct k_mbox MAILB1;
 
 
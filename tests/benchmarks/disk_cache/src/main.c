@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measures the throughput of reading a file from a FAT file system with
+ * small and large reads, on a RAM disk or a flash disk.
+ */
+
+#include <ztest.h>
+#include <fs/fs.h>
+#include <ff.h>
+
+#if defined(CONFIG_DISK_ACCESS_RAM)
+#define DISK_NAME CONFIG_DISK_RAM_VOLUME_NAME
+#else
+#define DISK_NAME CONFIG_DISK_FLASH_VOLUME_NAME
+#endif
+
+#define MNTP "/" DISK_NAME ":"
+#define TEST_FILE MNTP "/bench.bin"
+
+#define FILE_SIZE (32 * 1024)
+
+static FATFS fat_fs;
+static struct fs_mount_t fatfs_mnt = {
+	.type = FS_FATFS,
+	.mnt_point = MNTP,
+	.fs_data = &fat_fs,
+};
+
+static uint8_t buf[4096];
+
+static void test_init(void)
+{
+	struct fs_file_t file;
+	ssize_t len;
+	int err, i;
+
+	err = fs_mount(&fatfs_mnt);
+	zassert_equal(err, 0, "Cannot mount %s (%d)", MNTP, err);
+
+	(void)fs_unlink(TEST_FILE);
+
+	err = fs_open(&file, TEST_FILE);
+	zassert_equal(err, 0, "Cannot open %s (%d)", TEST_FILE, err);
+
+	for (i = 0; i < FILE_SIZE / sizeof(buf); i++) {
+		memset(buf, i, sizeof(buf));
+
+		len = fs_write(&file, buf, sizeof(buf));
+		zassert_equal(len, sizeof(buf), "Cannot write (%d)", len);
+	}
+
+	err = fs_close(&file);
+	zassert_equal(err, 0, "Cannot close (%d)", err);
+}
+
+/* Read the whole file in chunks of the given size and print the
+ * throughput.
+ */
+static void read_file(size_t chunk)
+{
+	struct fs_file_t file;
+	uint32_t start, us;
+	size_t total = 0;
+	ssize_t len;
+	int err;
+
+	err = fs_open(&file, TEST_FILE);
+	zassert_equal(err, 0, "Cannot open %s (%d)", TEST_FILE, err);
+
+	start = k_cycle_get_32();
+
+	do {
+		len = fs_read(&file, buf, chunk);
+		zassert_true(len >= 0, "Cannot read (%d)", len);
+		total += len;
+	} while (len > 0);
+
+	us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	err = fs_close(&file);
+	zassert_equal(err, 0, "Cannot close (%d)", err);
+
+	zassert_equal(total, FILE_SIZE, "Read %zu bytes", total);
+
+	TC_PRINT("%zu byte reads: %u us, %u KiB/s\n", chunk, us,
+		 us ? (uint32_t)((uint64_t)FILE_SIZE * 1000000U / 1024U / us) :
+		 0);
+}
+
+static void test_read_small(void)
+{
+	read_file(64);
+}
+
+static void test_read_large(void)
+{
+	read_file(sizeof(buf));
+}
+
+static void test_cleanup(void)
+{
+	int err;
+
+	err = fs_unlink(TEST_FILE);
+	zassert_equal(err, 0, "Cannot delete %s (%d)", TEST_FILE, err);
+
+	err = fs_unmount(&fatfs_mnt);
+	zassert_equal(err, 0, "Cannot unmount (%d)", err);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(disk_cache_benchmark,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_read_small),
+			 ztest_unit_test(test_read_large),
+			 ztest_unit_test(test_cleanup));
+
+	ztest_run_test_suite(disk_cache_benchmark);
+}
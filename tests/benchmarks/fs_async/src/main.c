@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measures the latency seen by a thread periodically appending records to a
+ * littlefs file, like a logger, with fs_write() and with fs_write_async().
+ */
+
+#include <ztest.h>
+#include <fs/fs.h>
+#include <fs/littlefs.h>
+#include <storage/flash_map.h>
+
+#define MNT_POINT "/lfs"
+#define SYNC_PATH MNT_POINT "/sync.log"
+#define ASYNC_PATH MNT_POINT "/async.log"
+
+#define RECORD_SIZE 64
+#define RECORD_COUNT 500
+#define RECORD_PERIOD_MS 2
+
+/* Number of records the producer can have in flight */
+#define SLOT_COUNT 16
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(storage);
+static struct fs_mount_t mnt = {
+	.type = FS_LITTLEFS,
+	.fs_data = &storage,
+	.storage_dev = (void *)FLASH_AREA_ID(image_1),
+	.mnt_point = MNT_POINT,
+};
+
+static uint32_t latency[RECORD_COUNT];
+
+static struct fs_async_req reqs[SLOT_COUNT];
+static struct k_poll_signal signals[SLOT_COUNT];
+static uint8_t records[SLOT_COUNT][RECORD_SIZE];
+
+static void test_init(void)
+{
+	const struct flash_area *fa;
+	int err;
+
+	err = flash_area_open(FLASH_AREA_ID(image_1), &fa);
+	zassert_equal(err, 0, "flash_area_open failed (%d)", err);
+
+	err = flash_area_erase(fa, 0, fa->fa_size);
+	zassert_equal(err, 0, "Cannot erase partition (%d)", err);
+
+	flash_area_close(fa);
+
+	err = fs_mount(&mnt);
+	zassert_equal(err, 0, "Cannot mount (%d)", err);
+}
+
+static void sort(uint32_t *values, size_t count)
+{
+	uint32_t value;
+	size_t i, j;
+
+	for (i = 1; i < count; i++) {
+		value = values[i];
+
+		for (j = i; j > 0 && values[j - 1] > value; j--) {
+			values[j] = values[j - 1];
+		}
+
+		values[j] = value;
+	}
+}
+
+static void print_latency(const char *name)
+{
+	sort(latency, RECORD_COUNT);
+
+	TC_PRINT("%s, %u records: p50 %u us, p99 %u us, max %u us\n", name,
+		 RECORD_COUNT, latency[RECORD_COUNT / 2],
+		 latency[RECORD_COUNT * 99 / 100], latency[RECORD_COUNT - 1]);
+}
+
+static void check_size(const char *path)
+{
+	struct fs_dirent entry;
+	int err;
+
+	err = fs_stat(path, &entry);
+	zassert_equal(err, 0, "Cannot stat %s (%d)", path, err);
+	zassert_equal(entry.size, RECORD_COUNT * RECORD_SIZE,
+		      "Invalid size %zu", entry.size);
+}
+
+static void test_sync_latency(void)
+{
+	struct fs_file_t file;
+	uint8_t record[RECORD_SIZE];
+	uint32_t start;
+	ssize_t len;
+	int err, i;
+
+	err = fs_open(&file, SYNC_PATH);
+	zassert_equal(err, 0, "Cannot open (%d)", err);
+
+	for (i = 0; i < RECORD_COUNT; i++) {
+		memset(record, i, sizeof(record));
+
+		start = k_cycle_get_32();
+		len = fs_write(&file, record, sizeof(record));
+		latency[i] = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+		zassert_equal(len, sizeof(record), "Cannot write (%d)", len);
+
+		k_sleep(K_MSEC(RECORD_PERIOD_MS));
+	}
+
+	err = fs_close(&file);
+	zassert_equal(err, 0, "Cannot close (%d)", err);
+
+	print_latency("fs_write");
+	check_size(SYNC_PATH);
+}
+
+/* Wait for the completion of the request using a slot */
+static void wait_slot(int slot)
+{
+	struct k_poll_event event = K_POLL_EVENT_INITIALIZER(
+		K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &signals[slot]);
+	int err;
+
+	err = k_poll(&event, 1, K_FOREVER);
+	zassert_equal(err, 0, "k_poll failed (%d)", err);
+
+	zassert_equal(signals[slot].result, reqs[slot].size,
+		      "Request failed (%d)", signals[slot].result);
+
+	k_poll_signal_reset(&signals[slot]);
+}
+
+static void test_async_latency(void)
+{
+	struct fs_file_t file;
+	struct fs_async_req sync_req = { 0 };
+	struct k_poll_signal sync_signal;
+	struct k_poll_event event;
+	uint32_t start;
+	int err, i, slot;
+
+	err = fs_open(&file, ASYNC_PATH);
+	zassert_equal(err, 0, "Cannot open (%d)", err);
+
+	for (i = 0; i < SLOT_COUNT; i++) {
+		k_poll_signal_init(&signals[i]);
+		reqs[i].signal = &signals[i];
+	}
+
+	for (i = 0; i < RECORD_COUNT; i++) {
+		slot = i % SLOT_COUNT;
+
+		start = k_cycle_get_32();
+
+		if (i >= SLOT_COUNT) {
+			wait_slot(slot);
+		}
+
+		memset(records[slot], i, RECORD_SIZE);
+		reqs[slot].buf = records[slot];
+		reqs[slot].size = RECORD_SIZE;
+
+		err = fs_write_async(&file, &reqs[slot]);
+		latency[i] = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+		zassert_equal(err, 0, "Cannot submit write (%d)", err);
+
+		k_sleep(K_MSEC(RECORD_PERIOD_MS));
+	}
+
+	for (i = RECORD_COUNT - SLOT_COUNT; i < RECORD_COUNT; i++) {
+		wait_slot(i % SLOT_COUNT);
+	}
+
+	k_poll_signal_init(&sync_signal);
+	sync_req.signal = &sync_signal;
+
+	err = fs_sync_async(&file, &sync_req);
+	zassert_equal(err, 0, "Cannot submit sync (%d)", err);
+
+	k_poll_event_init(&event, K_POLL_TYPE_SIGNAL,
+			  K_POLL_MODE_NOTIFY_ONLY, &sync_signal);
+	err = k_poll(&event, 1, K_FOREVER);
+	zassert_equal(err, 0, "k_poll failed (%d)", err);
+	zassert_equal(sync_req.result, 0, "Sync failed (%d)", sync_req.result);
+
+	err = fs_close(&file);
+	zassert_equal(err, 0, "Cannot close (%d)", err);
+
+	print_latency("fs_write_async");
+	check_size(ASYNC_PATH);
+}
+
+static void test_vectored(void)
+{
+	static const char part1[] = "vectored ", part2[] = "write";
+	struct fs_iovec iov[2];
+	struct fs_file_t file;
+	char buf1[sizeof(part1) - 1], buf2[sizeof(part2) - 1];
+	ssize_t len;
+	int err;
+
+	err = fs_open(&file, MNT_POINT "/vectored");
+	zassert_equal(err, 0, "Cannot open (%d)", err);
+
+	iov[0].iov_base = (void *)part1;
+	iov[0].iov_len = sizeof(part1) - 1;
+	iov[1].iov_base = (void *)part2;
+	iov[1].iov_len = sizeof(part2) - 1;
+
+	len = fs_writev(&file, iov, ARRAY_SIZE(iov));
+	zassert_equal(len, sizeof(buf1) + sizeof(buf2), "Cannot write (%d)",
+		      len);
+
+	err = fs_seek(&file, 0, FS_SEEK_SET);
+	zassert_equal(err, 0, "Cannot seek (%d)", err);
+
+	iov[0].iov_base = buf1;
+	iov[0].iov_len = sizeof(buf1);
+	iov[1].iov_base = buf2;
+	iov[1].iov_len = sizeof(buf2);
+
+	len = fs_readv(&file, iov, ARRAY_SIZE(iov));
+	zassert_equal(len, sizeof(buf1) + sizeof(buf2), "Cannot read (%d)",
+		      len);
+	zassert_mem_equal(buf1, part1, sizeof(buf1), "Invalid data");
+	zassert_mem_equal(buf2, part2, sizeof(buf2), "Invalid data");
+
+	/* Reading at the end of the file stops at the first buffer */
+	len = fs_readv(&file, iov, ARRAY_SIZE(iov));
+	zassert_equal(len, 0, "Read past the end (%d)", len);
+
+	err = fs_close(&file);
+	zassert_equal(err, 0, "Cannot close (%d)", err);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(fs_async,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_vectored),
+			 ztest_unit_test(test_sync_latency),
+			 ztest_unit_test(test_async_latency));
+
+	ztest_run_test_suite(fs_async);
+}
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measures the time taken by fs_stat() and fs_open() of paths a few
+ * directories deep in a littlefs file system on the flash simulator.
+ */
+
+#include <ztest.h>
+#include <fs/fs.h>
+#include <fs/littlefs.h>
+#include <storage/flash_map.h>
+
+#define MNT_POINT "/lfs"
+#define DIR_PATH MNT_POINT "/etc/app/conf"
+#define FILE_PATH DIR_PATH "/file0"
+#define MISSING_PATH DIR_PATH "/missing"
+
+#define FILE_COUNT 8
+#define LOOKUP_COUNT 200
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(storage);
+static struct fs_mount_t mnt = {
+	.type = FS_LITTLEFS,
+	.fs_data = &storage,
+	.storage_dev = (void *)FLASH_AREA_ID(image_1),
+	.mnt_point = MNT_POINT,
+};
+
+static void test_init(void)
+{
+	static const char *const dirs[] = {
+		MNT_POINT "/etc", MNT_POINT "/etc/app", DIR_PATH,
+	};
+	const struct flash_area *fa;
+	struct fs_file_t file;
+	char path[32];
+	int err, i;
+
+	err = flash_area_open(FLASH_AREA_ID(image_1), &fa);
+	zassert_equal(err, 0, "flash_area_open failed (%d)", err);
+
+	err = flash_area_erase(fa, 0, fa->fa_size);
+	zassert_equal(err, 0, "Cannot erase partition (%d)", err);
+
+	flash_area_close(fa);
+
+	err = fs_mount(&mnt);
+	zassert_equal(err, 0, "Cannot mount (%d)", err);
+
+	for (i = 0; i < ARRAY_SIZE(dirs); i++) {
+		err = fs_mkdir(dirs[i]);
+		zassert_equal(err, 0, "Cannot create %s (%d)", dirs[i], err);
+	}
+
+	for (i = 0; i < FILE_COUNT; i++) {
+		snprintk(path, sizeof(path), DIR_PATH "/file%d", i);
+
+		err = fs_open(&file, path);
+		zassert_equal(err, 0, "Cannot create %s (%d)", path, err);
+
+		err = fs_write(&file, path, strlen(path));
+		zassert_equal(err, strlen(path), "Cannot write (%d)", err);
+
+		err = fs_close(&file);
+		zassert_equal(err, 0, "Cannot close (%d)", err);
+	}
+}
+
+static void print_time(const char *name, uint32_t cycles)
+{
+	TC_PRINT("%s: %u us\n", name,
+		 k_cyc_to_us_floor32(cycles / LOOKUP_COUNT));
+}
+
+static void bench_stat(const char *name, const char *path, int expected)
+{
+	struct fs_dirent entry;
+	uint32_t start, cycles;
+	int err, i;
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < LOOKUP_COUNT; i++) {
+		err = fs_stat(path, &entry);
+		zassert_equal(err, expected, "stat of %s failed (%d)", path,
+			      err);
+	}
+
+	cycles = k_cycle_get_32() - start;
+	print_time(name, cycles);
+}
+
+static void test_stat_dir(void)
+{
+	struct fs_dirent entry;
+	int err;
+
+	bench_stat("stat of a directory", DIR_PATH, 0);
+
+	err = fs_stat(DIR_PATH, &entry);
+	zassert_equal(err, 0, "stat failed (%d)", err);
+	zassert_equal(entry.type, FS_DIR_ENTRY_DIR, "Not a directory");
+	zassert_equal(strcmp(entry.name, "conf"), 0, "Invalid name %s",
+		      entry.name);
+}
+
+static void test_stat_file(void)
+{
+	bench_stat("stat of a file", FILE_PATH, 0);
+}
+
+static void test_stat_missing(void)
+{
+	bench_stat("stat of a missing path", MISSING_PATH, -ENOENT);
+}
+
+static void test_open(void)
+{
+	struct fs_file_t file;
+	uint32_t start, cycles;
+	int err, i;
+
+	start = k_cycle_get_32();
+
+	for (i = 0; i < LOOKUP_COUNT; i++) {
+		err = fs_open(&file, FILE_PATH);
+		zassert_equal(err, 0, "Cannot open (%d)", err);
+
+		err = fs_close(&file);
+		zassert_equal(err, 0, "Cannot close (%d)", err);
+	}
+
+	cycles = k_cycle_get_32() - start;
+	print_time("open and close of a file", cycles);
+}
+
+/* Cached results must not survive the changes of the file system. */
+static void test_invalidation(void)
+{
+	struct fs_dirent entry;
+	struct fs_file_t file;
+	int err;
+
+	err = fs_stat(MISSING_PATH, &entry);
+	zassert_equal(err, -ENOENT, "Missing path found (%d)", err);
+
+	err = fs_mkdir(MISSING_PATH);
+	zassert_equal(err, 0, "Cannot create directory (%d)", err);
+
+	err = fs_stat(MISSING_PATH, &entry);
+	zassert_equal(err, 0, "Created directory not found (%d)", err);
+	zassert_equal(entry.type, FS_DIR_ENTRY_DIR, "Not a directory");
+
+	err = fs_rename(MISSING_PATH, MNT_POINT "/renamed");
+	zassert_equal(err, 0, "Cannot rename (%d)", err);
+
+	err = fs_stat(MISSING_PATH, &entry);
+	zassert_equal(err, -ENOENT, "Renamed directory found (%d)", err);
+
+	err = fs_stat(MNT_POINT "/renamed", &entry);
+	zassert_equal(err, 0, "Renamed directory not found (%d)", err);
+
+	err = fs_unlink(MNT_POINT "/renamed");
+	zassert_equal(err, 0, "Cannot remove directory (%d)", err);
+
+	err = fs_stat(MNT_POINT "/renamed", &entry);
+	zassert_equal(err, -ENOENT, "Removed directory found (%d)", err);
+
+	err = fs_open(&file, MISSING_PATH);
+	zassert_equal(err, 0, "Cannot create file (%d)", err);
+
+	err = fs_close(&file);
+	zassert_equal(err, 0, "Cannot close (%d)", err);
+
+	err = fs_stat(MISSING_PATH, &entry);
+	zassert_equal(err, 0, "Created file not found (%d)", err);
+	zassert_equal(entry.type, FS_DIR_ENTRY_FILE, "Not a file");
+
+	err = fs_unlink(MISSING_PATH);
+	zassert_equal(err, 0, "Cannot remove file (%d)", err);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(fs_lookup,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_stat_dir),
+			 ztest_unit_test(test_stat_file),
+			 ztest_unit_test(test_stat_missing),
+			 ztest_unit_test(test_open),
+			 ztest_unit_test(test_invalidation));
+
+	ztest_run_test_suite(fs_lookup);
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measures the idle wakeups per second caused by periodic timers with
+ * close but different periods, with and without timeout slack.
+ */
+
+#include <ztest.h>
+
+#define TIMER_COUNT 4
+#define RUN_MS 2000
+
+#define PERIOD_MS 10
+#define SLACK_MS 5
+
+#ifdef CONFIG_TIMEOUT_SLACK
+#define MODE "slack"
+#else
+#define MODE "exact"
+#endif
+
+static struct k_timer timers[TIMER_COUNT];
+static volatile uint32_t expiries;
+
+static void timer_expire(struct k_timer *timer)
+{
+	ARG_UNUSED(timer);
+
+	expiries++;
+}
+
+static void test_timer_wakeups(void)
+{
+	struct k_idle_stats before, after;
+	uint32_t wakeups;
+	int i;
+
+	expiries = 0U;
+
+	for (i = 0; i < TIMER_COUNT; i++) {
+		k_timer_init(&timers[i], timer_expire, NULL);
+#ifdef CONFIG_TIMEOUT_SLACK
+		k_timer_slack_set(&timers[i], K_MSEC(SLACK_MS));
+#endif
+		/* periods of 10, 11, 12... ms */
+		k_timer_start(&timers[i], K_MSEC(PERIOD_MS + i),
+			      K_MSEC(PERIOD_MS + i));
+	}
+
+	k_idle_stats_get(&before);
+	k_sleep(K_MSEC(RUN_MS));
+	k_idle_stats_get(&after);
+
+	for (i = 0; i < TIMER_COUNT; i++) {
+		k_timer_stop(&timers[i]);
+	}
+
+	wakeups = (uint32_t)(after.wakeups - before.wakeups);
+
+	TC_PRINT("%s, %d timers: %u expiries/s, %u wakeups/s "
+		 "(last second: %u)\n", MODE, TIMER_COUNT,
+		 expiries * 1000U / RUN_MS, wakeups * 1000U / RUN_MS,
+		 after.wakeups_per_sec);
+
+	zassert_true(expiries > 0U, "No timer expired");
+	zassert_true(wakeups > 0U, "No idle wakeup counted");
+#ifdef CONFIG_TIMEOUT_SLACK
+	zassert_true(wakeups < expiries, "Expiries not coalesced");
+#endif
+}
+
+void test_main(void)
+{
+	ztest_test_suite(idle_wakeups_benchmark,
+			 ztest_unit_test(test_timer_wakeups));
+
+	ztest_run_test_suite(idle_wakeups_benchmark);
+}
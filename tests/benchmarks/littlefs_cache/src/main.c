@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measures the throughput of littlefs with 1, 8 and 32 files open at the
+ * same time, written and read in small interleaved chunks, along with the
+ * RAM taken by their caches.
+ */
+
+#include <ztest.h>
+#include <fs/fs.h>
+#include <fs/littlefs.h>
+#include <storage/flash_map.h>
+
+#define MNT_POINT "/lfs"
+
+#define MAX_FILES 32
+#define FILE_SIZE 2048
+#define CHUNK_SIZE 32
+
+BUILD_ASSERT(MAX_FILES <= CONFIG_FS_LITTLEFS_NUM_FILES);
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(storage);
+static struct fs_mount_t mnt = {
+	.type = FS_LITTLEFS,
+	.fs_data = &storage,
+	.storage_dev = (void *)FLASH_AREA_ID(image_1),
+	.mnt_point = MNT_POINT,
+};
+
+static struct fs_file_t files[MAX_FILES];
+static uint8_t chunk[CHUNK_SIZE];
+
+static void test_init(void)
+{
+	const struct flash_area *fa;
+	int err;
+
+	err = flash_area_open(FLASH_AREA_ID(image_1), &fa);
+	zassert_equal(err, 0, "flash_area_open failed (%d)", err);
+
+	err = flash_area_erase(fa, 0, fa->fa_size);
+	zassert_equal(err, 0, "Cannot erase partition (%d)", err);
+
+	flash_area_close(fa);
+
+	err = fs_mount(&mnt);
+	zassert_equal(err, 0, "Cannot mount (%d)", err);
+}
+
+static void open_files(int count)
+{
+	char path[16];
+	int err, i;
+
+	for (i = 0; i < count; i++) {
+		snprintk(path, sizeof(path), MNT_POINT "/f%d", i);
+
+		err = fs_open(&files[i], path);
+		zassert_equal(err, 0, "Cannot open %s (%d)", path, err);
+	}
+}
+
+static void close_files(int count)
+{
+	int err, i;
+
+	for (i = 0; i < count; i++) {
+		err = fs_close(&files[i]);
+		zassert_equal(err, 0, "Cannot close (%d)", err);
+	}
+}
+
+static uint32_t kbps(int count, uint32_t cycles)
+{
+	uint32_t us = k_cyc_to_us_floor32(cycles);
+
+	return us ? (uint32_t)((uint64_t)count * FILE_SIZE * 1000U / us) : 0;
+}
+
+static void bench_files(int count)
+{
+	uint32_t start, write_cycles, read_cycles;
+	char path[16];
+	int err, i, off;
+
+	open_files(count);
+
+	start = k_cycle_get_32();
+
+	for (off = 0; off < FILE_SIZE; off += CHUNK_SIZE) {
+		for (i = 0; i < count; i++) {
+			memset(chunk, i + off / CHUNK_SIZE, sizeof(chunk));
+
+			err = fs_write(&files[i], chunk, sizeof(chunk));
+			zassert_equal(err, sizeof(chunk), "Cannot write (%d)",
+				      err);
+		}
+	}
+
+	close_files(count);
+
+	write_cycles = k_cycle_get_32() - start;
+
+	open_files(count);
+
+	start = k_cycle_get_32();
+
+	for (off = 0; off < FILE_SIZE; off += CHUNK_SIZE) {
+		for (i = 0; i < count; i++) {
+			err = fs_read(&files[i], chunk, sizeof(chunk));
+			zassert_equal(err, sizeof(chunk), "Cannot read (%d)",
+				      err);
+			zassert_equal(chunk[0],
+				      (uint8_t)(i + off / CHUNK_SIZE),
+				      "Invalid data");
+		}
+	}
+
+	read_cycles = k_cycle_get_32() - start;
+
+	close_files(count);
+
+	TC_PRINT("%d files, %u bytes of file caches: write %u KB/s, "
+		 "read %u KB/s\n", count,
+		 count * CONFIG_FS_LITTLEFS_CACHE_SIZE,
+		 kbps(count, write_cycles), kbps(count, read_cycles));
+
+	for (i = 0; i < count; i++) {
+		snprintk(path, sizeof(path), MNT_POINT "/f%d", i);
+
+		err = fs_unlink(path);
+		zassert_equal(err, 0, "Cannot remove %s (%d)", path, err);
+	}
+}
+
+static void test_1_file(void)
+{
+	bench_files(1);
+}
+
+static void test_8_files(void)
+{
+	bench_files(8);
+}
+
+static void test_32_files(void)
+{
+	bench_files(32);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(littlefs_cache,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_1_file),
+			 ztest_unit_test(test_8_files),
+			 ztest_unit_test(test_32_files));
+
+	ztest_run_test_suite(littlefs_cache);
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measures the throughput of threads on all the CPUs taking a shared mutex
+ * for a short critical section, with and without adaptive spinning, for
+ * several critical section lengths.
+ */
+
+#include <ztest.h>
+
+#define THREAD_COUNT (2 * CONFIG_MP_NUM_CPUS)
+#define RUN_MS 1000
+
+#define STACK_SIZE 1024
+#define THREAD_PRIORITY K_PRIO_PREEMPT(5)
+
+#ifdef CONFIG_MUTEX_ADAPTIVE_SPIN
+#define MODE "adaptive"
+#else
+#define MODE "pend"
+#endif
+
+static K_MUTEX_DEFINE(shared_mutex);
+static volatile bool stop;
+
+/* only accessed with shared_mutex held */
+static volatile uint32_t shared_count;
+
+static uint32_t counts[THREAD_COUNT];
+static struct k_thread threads[THREAD_COUNT];
+K_THREAD_STACK_ARRAY_DEFINE(stacks, THREAD_COUNT, STACK_SIZE);
+
+static void work(uint32_t loops)
+{
+	volatile uint32_t i;
+
+	for (i = 0; i < loops; i++) {
+	}
+}
+
+static void contender(void *p1, void *p2, void *p3)
+{
+	uint32_t *count = p1;
+	uint32_t hold = POINTER_TO_UINT(p2);
+
+	ARG_UNUSED(p3);
+
+	while (!stop) {
+		k_mutex_lock(&shared_mutex, K_FOREVER);
+		shared_count++;
+		work(hold);
+		k_mutex_unlock(&shared_mutex);
+
+		(*count)++;
+
+		/* let the other contenders take the mutex */
+		work(hold);
+	}
+}
+
+static void run_contention(uint32_t hold)
+{
+	uint32_t total = 0;
+	int i;
+
+	stop = false;
+	shared_count = 0;
+
+	for (i = 0; i < THREAD_COUNT; i++) {
+		counts[i] = 0;
+
+		k_thread_create(&threads[i], stacks[i], STACK_SIZE,
+				contender, &counts[i], UINT_TO_POINTER(hold),
+				NULL, THREAD_PRIORITY, 0, K_NO_WAIT);
+	}
+
+	k_sleep(K_MSEC(RUN_MS));
+	stop = true;
+
+	for (i = 0; i < THREAD_COUNT; i++) {
+		k_thread_join(&threads[i], K_FOREVER);
+		total += counts[i];
+	}
+
+	TC_PRINT("%s, %d CPUs, %d threads, hold %u: %u locks/s\n", MODE,
+		 CONFIG_MP_NUM_CPUS, THREAD_COUNT, hold,
+		 total * 1000 / RUN_MS);
+
+	zassert_true(total > 0, "No lock taken");
+	zassert_equal(shared_count, total, "Mutual exclusion broken");
+}
+
+static void test_contention_short(void)
+{
+	run_contention(10);
+}
+
+static void test_contention_medium(void)
+{
+	run_contention(100);
+}
+
+static void test_contention_long(void)
+{
+	run_contention(1000);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(mutex_contention_benchmark,
+			 ztest_unit_test(test_contention_short),
+			 ztest_unit_test(test_contention_medium),
+			 ztest_unit_test(test_contention_long));
+
+	ztest_run_test_suite(mutex_contention_benchmark);
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measures the latency distribution of nvs_write() done periodically, like
+ * a control loop storing its state, over many sector changes.
+ */
+
+#include <ztest.h>
+#include <drivers/flash.h>
+#include <storage/flash_map.h>
+#include <fs/nvs.h>
+
+#define SECTOR_SIZE 4096U
+#define SECTOR_COUNT 8U
+
+#define ID_COUNT 16
+#define DATA_LEN 64
+#define WRITE_COUNT 1000
+#define WRITE_PERIOD_MS 10
+
+static struct nvs_fs fs;
+static uint32_t latency[WRITE_COUNT];
+
+static void test_init(void)
+{
+	const struct flash_area *fa;
+	int err;
+
+	err = flash_area_open(FLASH_AREA_ID(storage), &fa);
+	zassert_equal(err, 0, "flash_area_open failed (%d)", err);
+
+	err = flash_area_erase(fa, 0, SECTOR_SIZE * SECTOR_COUNT);
+	zassert_equal(err, 0, "Cannot erase storage (%d)", err);
+
+	fs.offset = FLASH_AREA_OFFSET(storage);
+	fs.sector_size = SECTOR_SIZE;
+	fs.sector_count = SECTOR_COUNT;
+
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_equal(err, 0, "nvs_init failed (%d)", err);
+}
+
+static void sort(uint32_t *values, size_t count)
+{
+	uint32_t value;
+	size_t i, j;
+
+	for (i = 1; i < count; i++) {
+		value = values[i];
+
+		for (j = i; j > 0 && values[j - 1] > value; j--) {
+			values[j] = values[j - 1];
+		}
+
+		values[j] = value;
+	}
+}
+
+static void test_write_latency(void)
+{
+	uint8_t data[DATA_LEN];
+	uint32_t start;
+	ssize_t len;
+	int i;
+
+	for (i = 0; i < WRITE_COUNT; i++) {
+		/* Every write changes the data so none of them is skipped */
+		memset(data, i, sizeof(data));
+
+		start = k_cycle_get_32();
+		len = nvs_write(&fs, i % ID_COUNT, data, sizeof(data));
+		latency[i] = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+		zassert_equal(len, sizeof(data), "nvs_write failed (%d)", len);
+
+		k_sleep(K_MSEC(WRITE_PERIOD_MS));
+	}
+
+	sort(latency, WRITE_COUNT);
+
+	TC_PRINT("%u writes: p50 %u us, p99 %u us, max %u us\n", WRITE_COUNT,
+		 latency[WRITE_COUNT / 2], latency[WRITE_COUNT * 99 / 100],
+		 latency[WRITE_COUNT - 1]);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(nvs_write_latency,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_write_latency));
+
+	ztest_run_test_suite(nvs_write_latency);
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Schedulability harness for periodic deadline threads.  Sets of periodic
+ * tasks sharing one priority, and thus scheduled earliest deadline first,
+ * are run at increasing CPU utilizations with a bandwidth reservation
+ * slightly above their demand.  The jobs, deadline misses and budget
+ * overruns of each set are reported, and the sets that do not fit are
+ * checked to be rejected by the admission control.
+ */
+
+#include <ztest.h>
+
+#define TASK_COUNT 3
+#define RUN_MS 2000
+
+/* Bandwidth reserved on top of the demand of a set, in percent */
+#define MARGIN 5
+
+#define STACK_SIZE 1024
+#define TASK_PRIORITY K_PRIO_PREEMPT(5)
+
+#define CALIBRATION_LOOPS 100000
+
+struct task {
+	uint32_t period_us;
+	uint32_t exec_us;
+	struct k_thread thread;
+};
+
+static struct task tasks[TASK_COUNT] = {
+	{ .period_us = 10000 },
+	{ .period_us = 20000 },
+	{ .period_us = 40000 },
+};
+
+K_THREAD_STACK_ARRAY_DEFINE(task_stacks, TASK_COUNT, STACK_SIZE);
+
+static volatile bool stop;
+static uint32_t loops_per_ms;
+
+/* Use the CPU for a given number of loops, unlike k_busy_wait() the time
+ * the task is preempted is not counted.
+ */
+static void work(uint32_t loops)
+{
+	volatile uint32_t i;
+
+	for (i = 0; i < loops; i++) {
+	}
+}
+
+static void calibrate(void)
+{
+	uint32_t start, cycles;
+
+	k_sched_lock();
+	start = k_cycle_get_32();
+	work(CALIBRATION_LOOPS);
+	cycles = k_cycle_get_32() - start;
+	k_sched_unlock();
+
+	loops_per_ms = (uint32_t)((uint64_t)CALIBRATION_LOOPS *
+				  sys_clock_hw_cycles_per_sec() /
+				  (1000U * cycles));
+}
+
+static void task_entry(void *p1, void *p2, void *p3)
+{
+	struct task *task = p1;
+	uint32_t loops = task->exec_us * loops_per_ms / 1000U;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (!stop) {
+		work(loops);
+		(void)k_thread_period_wait();
+	}
+}
+
+/* Run the task set with a total demand of @a util percent of the CPU */
+static int run_set(uint32_t util)
+{
+	struct k_thread_cbs_stats stats;
+	uint32_t jobs = 0, misses = 0, overruns = 0;
+	uint32_t budget_us;
+	int i, ret = 0;
+
+	if (loops_per_ms == 0U) {
+		calibrate();
+	}
+
+	stop = false;
+
+	for (i = 0; i < TASK_COUNT; i++) {
+		tasks[i].exec_us = tasks[i].period_us * util /
+			(100U * TASK_COUNT);
+		budget_us = tasks[i].period_us * (util + MARGIN) /
+			(100U * TASK_COUNT);
+
+		k_thread_create(&tasks[i].thread, task_stacks[i], STACK_SIZE,
+				task_entry, &tasks[i], NULL, NULL,
+				TASK_PRIORITY, 0, K_FOREVER);
+
+		if (ret == 0) {
+			ret = k_thread_cbs_set(&tasks[i].thread, budget_us,
+					       tasks[i].period_us, NULL);
+		}
+	}
+
+	if (ret != 0) {
+		for (i = 0; i < TASK_COUNT; i++) {
+			k_thread_abort(&tasks[i].thread);
+		}
+
+		TC_PRINT("utilization %u%% (+%u%%): rejected\n", util,
+			 MARGIN);
+		return ret;
+	}
+
+	for (i = 0; i < TASK_COUNT; i++) {
+		k_thread_start(&tasks[i].thread);
+	}
+
+	k_sleep(K_MSEC(RUN_MS));
+
+	for (i = 0; i < TASK_COUNT; i++) {
+		zassert_equal(k_thread_cbs_stats_get(&tasks[i].thread,
+						     &stats), 0, NULL);
+		jobs += stats.jobs;
+		misses += stats.misses;
+		overruns += stats.overruns;
+	}
+
+	stop = true;
+
+	for (i = 0; i < TASK_COUNT; i++) {
+		k_thread_join(&tasks[i].thread, K_FOREVER);
+	}
+
+	TC_PRINT("utilization %u%% (+%u%%): %u jobs, %u misses, "
+		 "%u overruns\n", util, MARGIN, jobs, misses, overruns);
+
+	zassert_true(jobs > 0, "No job done");
+	zassert_equal(k_sched_cbs_utilization_get(), 0U,
+		      "Bandwidth not released");
+
+	return 0;
+}
+
+static void test_edf_util_50(void)
+{
+	zassert_equal(run_set(50), 0, "Task set rejected");
+}
+
+static void test_edf_util_70(void)
+{
+	zassert_equal(run_set(70), 0, "Task set rejected");
+}
+
+static void test_edf_util_90(void)
+{
+	zassert_equal(run_set(90), 0, "Task set rejected");
+}
+
+static void test_edf_util_100(void)
+{
+	/* the margin takes the reservation over the admission limit */
+	zassert_equal(run_set(100), -EBUSY, "Task set admitted");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(sched_edf_benchmark,
+			 ztest_unit_test(test_edf_util_50),
+			 ztest_unit_test(test_edf_util_70),
+			 ztest_unit_test(test_edf_util_90),
+			 ztest_unit_test(test_edf_util_100));
+
+	ztest_run_test_suite(sched_edf_benchmark);
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measures the context switch throughput of a pair of threads per CPU
+ * passing a semaphore back and forth, and the latency of waking up a
+ * thread while all the CPUs are busy with lower priority threads.
+ */
+
+#include <ztest.h>
+
+#define PAIR_COUNT CONFIG_MP_NUM_CPUS
+#define RUN_MS 1000
+
+#define WAKEUP_COUNT 500
+
+#define STACK_SIZE 1024
+#define PAIR_PRIORITY K_PRIO_PREEMPT(5)
+#define WAITER_PRIORITY K_PRIO_PREEMPT(1)
+#define LOAD_PRIORITY K_PRIO_PREEMPT(10)
+
+struct pair {
+	struct k_sem ping;
+	struct k_sem pong;
+	struct k_thread ping_thread;
+	struct k_thread pong_thread;
+	uint32_t count;
+};
+
+static struct pair pairs[PAIR_COUNT];
+static volatile bool stop;
+
+K_THREAD_STACK_ARRAY_DEFINE(ping_stacks, PAIR_COUNT, STACK_SIZE);
+K_THREAD_STACK_ARRAY_DEFINE(pong_stacks, PAIR_COUNT, STACK_SIZE);
+
+static struct k_thread load_threads[CONFIG_MP_NUM_CPUS];
+K_THREAD_STACK_ARRAY_DEFINE(load_stacks, CONFIG_MP_NUM_CPUS, STACK_SIZE);
+
+static struct k_thread waiter_thread;
+K_THREAD_STACK_DEFINE(waiter_stack, STACK_SIZE);
+
+static K_SEM_DEFINE(wakeup_sem, 0, 1);
+static K_SEM_DEFINE(done_sem, 0, 1);
+static volatile uint32_t wakeup_start;
+static uint32_t latency[WAKEUP_COUNT];
+
+static void ping(void *p1, void *p2, void *p3)
+{
+	struct pair *pair = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (!stop) {
+		k_sem_give(&pair->pong);
+		k_sem_take(&pair->ping, K_FOREVER);
+		pair->count++;
+	}
+}
+
+static void pong(void *p1, void *p2, void *p3)
+{
+	struct pair *pair = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_sem_take(&pair->pong, K_FOREVER);
+		k_sem_give(&pair->ping);
+	}
+}
+
+static void test_switch_throughput(void)
+{
+	uint32_t total = 0;
+	int i;
+
+	stop = false;
+
+	for (i = 0; i < PAIR_COUNT; i++) {
+		k_sem_init(&pairs[i].ping, 0, 1);
+		k_sem_init(&pairs[i].pong, 0, 1);
+		pairs[i].count = 0;
+
+		k_thread_create(&pairs[i].pong_thread, pong_stacks[i],
+				STACK_SIZE, pong, &pairs[i], NULL, NULL,
+				PAIR_PRIORITY, 0, K_NO_WAIT);
+		k_thread_create(&pairs[i].ping_thread, ping_stacks[i],
+				STACK_SIZE, ping, &pairs[i], NULL, NULL,
+				PAIR_PRIORITY, 0, K_NO_WAIT);
+	}
+
+	k_sleep(K_MSEC(RUN_MS));
+	stop = true;
+
+	for (i = 0; i < PAIR_COUNT; i++) {
+		k_thread_abort(&pairs[i].ping_thread);
+		k_thread_abort(&pairs[i].pong_thread);
+		total += pairs[i].count;
+	}
+
+	/* each round trip is two switches */
+	TC_PRINT("%d CPUs, %d pairs: %u switches/s\n", CONFIG_MP_NUM_CPUS,
+		 PAIR_COUNT, total * 2 * 1000 / RUN_MS);
+
+	zassert_true(total > 0, "No switch done");
+}
+
+static void load(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (!stop) {
+		k_busy_wait(100);
+	}
+}
+
+static void waiter(void *p1, void *p2, void *p3)
+{
+	int i;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	for (i = 0; i < WAKEUP_COUNT; i++) {
+		k_sem_take(&wakeup_sem, K_FOREVER);
+		latency[i] = k_cycle_get_32() - wakeup_start;
+		k_sem_give(&done_sem);
+	}
+}
+
+static void sort(uint32_t *values, size_t count)
+{
+	uint32_t value;
+	size_t i, j;
+
+	for (i = 1; i < count; i++) {
+		value = values[i];
+
+		for (j = i; j > 0 && values[j - 1] > value; j--) {
+			values[j] = values[j - 1];
+		}
+
+		values[j] = value;
+	}
+}
+
+static void test_wakeup_latency(void)
+{
+	int i;
+
+	stop = false;
+
+	/* Keep all the CPUs busy, the waiter has to preempt one of them */
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		k_thread_create(&load_threads[i], load_stacks[i], STACK_SIZE,
+				load, NULL, NULL, NULL, LOAD_PRIORITY, 0,
+				K_NO_WAIT);
+	}
+
+	k_thread_create(&waiter_thread, waiter_stack, STACK_SIZE, waiter,
+			NULL, NULL, NULL, WAITER_PRIORITY, 0, K_NO_WAIT);
+
+	for (i = 0; i < WAKEUP_COUNT; i++) {
+		k_sleep(K_MSEC(1));
+
+		wakeup_start = k_cycle_get_32();
+		k_sem_give(&wakeup_sem);
+		k_sem_take(&done_sem, K_FOREVER);
+	}
+
+	stop = true;
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		k_thread_abort(&load_threads[i]);
+	}
+
+	for (i = 0; i < WAKEUP_COUNT; i++) {
+		latency[i] = k_cyc_to_ns_floor32(latency[i]);
+	}
+
+	sort(latency, WAKEUP_COUNT);
+
+	TC_PRINT("%d CPUs, %d wakeups: p50 %u ns, p99 %u ns, max %u ns\n",
+		 CONFIG_MP_NUM_CPUS, WAKEUP_COUNT, latency[WAKEUP_COUNT / 2],
+		 latency[WAKEUP_COUNT * 99 / 100], latency[WAKEUP_COUNT - 1]);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(sched_smp_benchmark,
+			 ztest_unit_test(test_switch_throughput),
+			 ztest_unit_test(test_wakeup_latency));
+
+	ztest_run_test_suite(sched_smp_benchmark);
+}
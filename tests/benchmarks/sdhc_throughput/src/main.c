@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measures the read and write throughput of a SD card in the SPI slot,
+ * with one sector per disk access and with multi-sector accesses.
+ *
+ * The test overwrites sectors at the end of the card, use a card without
+ * data on it.
+ */
+
+#include <ztest.h>
+#include <disk/disk_access.h>
+
+#define DISK_NAME CONFIG_DISK_SDHC_VOLUME_NAME
+
+#define SECTOR_SIZE 512
+/* Sectors in a multi-sector access */
+#define BURST_SECTORS 8
+/* Sectors transferred in each measurement */
+#define TOTAL_SECTORS 256
+
+static uint8_t buf[BURST_SECTORS * SECTOR_SIZE];
+static uint32_t first_sector;
+
+static void test_init(void)
+{
+	uint32_t sector_count, sector_size;
+	int err;
+
+	err = disk_access_init(DISK_NAME);
+	zassert_equal(err, 0, "Cannot init %s (%d)", DISK_NAME, err);
+
+	err = disk_access_ioctl(DISK_NAME, DISK_IOCTL_GET_SECTOR_SIZE,
+				&sector_size);
+	zassert_equal(err, 0, "Cannot get sector size (%d)", err);
+	zassert_equal(sector_size, SECTOR_SIZE, "Unexpected sector size %u",
+		      sector_size);
+
+	err = disk_access_ioctl(DISK_NAME, DISK_IOCTL_GET_SECTOR_COUNT,
+				&sector_count);
+	zassert_equal(err, 0, "Cannot get sector count (%d)", err);
+	zassert_true(sector_count > TOTAL_SECTORS, "Too small card");
+
+	first_sector = sector_count - TOTAL_SECTORS;
+}
+
+static void print_rate(const char *name, uint32_t cycles)
+{
+	uint32_t us = k_cyc_to_us_floor32(cycles);
+
+	TC_PRINT("%s: %u us, %u KiB/s\n", name, us,
+		 us ? (uint32_t)((uint64_t)TOTAL_SECTORS * SECTOR_SIZE *
+				 1000000U / 1024U / us) : 0);
+}
+
+/* Transfer TOTAL_SECTORS sectors with accesses of the given size */
+static uint32_t transfer(bool write, uint32_t sectors)
+{
+	uint32_t sector, start;
+	int err;
+
+	start = k_cycle_get_32();
+
+	for (sector = 0; sector < TOTAL_SECTORS; sector += sectors) {
+		if (write) {
+			memset(buf, sector, sizeof(buf));
+			err = disk_access_write(DISK_NAME, buf,
+						first_sector + sector,
+						sectors);
+		} else {
+			err = disk_access_read(DISK_NAME, buf,
+					       first_sector + sector,
+					       sectors);
+		}
+
+		zassert_equal(err, 0, "Access of sector %u failed (%d)",
+			      first_sector + sector, err);
+	}
+
+	return k_cycle_get_32() - start;
+}
+
+static void test_write(void)
+{
+	print_rate("single sector writes", transfer(true, 1));
+	print_rate("multi sector writes", transfer(true, BURST_SECTORS));
+}
+
+static void test_read(void)
+{
+	int i;
+
+	print_rate("single sector reads", transfer(false, 1));
+	print_rate("multi sector reads", transfer(false, BURST_SECTORS));
+
+	/* The last burst was written with the multi sector writes */
+	for (i = 0; i < sizeof(buf); i++) {
+		zassert_equal(buf[i], (uint8_t)(TOTAL_SECTORS - BURST_SECTORS),
+			      "Invalid data at %d", i);
+	}
+}
+
+void test_main(void)
+{
+	ztest_test_suite(sdhc_throughput,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_write),
+			 ztest_unit_test(test_read));
+
+	ztest_run_test_suite(sdhc_throughput);
+}
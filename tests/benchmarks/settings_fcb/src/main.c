@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measures the time settings_load() takes at boot with the FCB backend as
+ * the number of superseded entries grows, and after compacting the FCB.
+ */
+
+#include <ztest.h>
+#include <storage/flash_map.h>
+#include <settings/settings.h>
+#include <settings/settings_fcb.h>
+
+#include "settings_priv.h"
+
+/* Number of different settings, all the other entries are older values */
+#define KEY_COUNT 16
+
+#define SECTOR_SIZE (16 * 1024)
+
+static const uint16_t entry_counts[] = { 64, 256, 1024 };
+
+static struct flash_sector fcb_sectors[] = {
+	{ .fs_off = 0 * SECTOR_SIZE, .fs_size = SECTOR_SIZE },
+	{ .fs_off = 1 * SECTOR_SIZE, .fs_size = SECTOR_SIZE },
+	{ .fs_off = 2 * SECTOR_SIZE, .fs_size = SECTOR_SIZE },
+	{ .fs_off = 3 * SECTOR_SIZE, .fs_size = SECTOR_SIZE },
+};
+
+static struct settings_fcb bench_fcb = {
+	.cf_fcb.f_magic = CONFIG_SETTINGS_FCB_MAGIC,
+	.cf_fcb.f_sectors = fcb_sectors,
+	.cf_fcb.f_sector_cnt = ARRAY_SIZE(fcb_sectors),
+};
+
+static uint16_t saved_entries;
+static uint32_t loaded_values;
+
+static int bench_set(const char *name, size_t len, settings_read_cb read_cb,
+		     void *cb_arg)
+{
+	loaded_values++;
+
+	return 0;
+}
+
+static struct settings_handler bench_handler = {
+	.name = "bench",
+	.h_set = bench_set,
+};
+
+static void test_init(void)
+{
+	const struct flash_area *fap;
+	int err, i;
+
+	err = settings_subsys_init();
+	zassert_equal(err, 0, "settings_subsys_init failed (%d)", err);
+
+	err = settings_register(&bench_handler);
+	zassert_equal(err, 0, "Cannot register handler (%d)", err);
+
+	/* Replace the default backend with an empty one */
+	sys_slist_init(&settings_load_srcs);
+	settings_save_dst = NULL;
+
+	err = flash_area_open(FLASH_AREA_ID(storage), &fap);
+	zassert_equal(err, 0, "Cannot open storage area (%d)", err);
+
+	for (i = 0; i < ARRAY_SIZE(fcb_sectors); i++) {
+		err = flash_area_erase(fap, fcb_sectors[i].fs_off,
+				       fcb_sectors[i].fs_size);
+		zassert_equal(err, 0, "Cannot erase sector %d (%d)", i, err);
+	}
+
+	err = settings_fcb_src(&bench_fcb);
+	zassert_equal(err, 0, "Cannot add FCB source (%d)", err);
+
+	err = settings_fcb_dst(&bench_fcb);
+	zassert_equal(err, 0, "Cannot set FCB destination (%d)", err);
+}
+
+static void save_entries(uint16_t count)
+{
+	char name[SETTINGS_MAX_NAME_LEN];
+	uint32_t value;
+	int err;
+
+	for (; saved_entries < count; saved_entries++) {
+		snprintk(name, sizeof(name), "bench/key%u",
+			 saved_entries % KEY_COUNT);
+		value = saved_entries;
+
+		err = settings_save_one(name, &value, sizeof(value));
+		zassert_equal(err, 0, "Cannot save %s (%d)", name, err);
+	}
+}
+
+/* Return the time settings_load() takes in microseconds */
+static uint32_t load_time(void)
+{
+	uint32_t start, cycles;
+	int err;
+
+	loaded_values = 0U;
+
+	start = k_cycle_get_32();
+	err = settings_load();
+	cycles = k_cycle_get_32() - start;
+
+	zassert_equal(err, 0, "settings_load failed (%d)", err);
+	zassert_equal(loaded_values, KEY_COUNT, "Loaded %u values",
+		      loaded_values);
+
+	return k_cyc_to_us_floor32(cycles);
+}
+
+static void test_load_time(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(entry_counts); i++) {
+		save_entries(entry_counts[i]);
+
+		TC_PRINT("%u entries saved: load %u us\n", entry_counts[i],
+			 load_time());
+	}
+}
+
+static void test_compact(void)
+{
+	uint32_t start, cycles;
+	int err;
+
+	start = k_cycle_get_32();
+	err = settings_fcb_compact(&bench_fcb);
+	cycles = k_cycle_get_32() - start;
+	zassert_equal(err, 0, "Cannot compact (%d)", err);
+
+	TC_PRINT("compact %u us, load after compact %u us\n",
+		 k_cyc_to_us_floor32(cycles), load_time());
+}
+
+void test_main(void)
+{
+	ztest_test_suite(settings_fcb_benchmark,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_load_time),
+			 ztest_unit_test(test_compact));
+
+	ztest_run_test_suite(settings_fcb_benchmark);
+}
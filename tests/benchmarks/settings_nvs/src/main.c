@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measures the latency of settings_save_one() with the NVS backend as the
+ * number of stored settings grows.
+ */
+
+#include <ztest.h>
+#include <settings/settings.h>
+
+/* Number of saves done in each measurement */
+#define SAVE_COUNT 32
+
+static const uint16_t key_counts[] = { 32, 128, 256 };
+
+static uint16_t stored_keys;
+
+static void key_name(char *name, size_t len, uint16_t idx)
+{
+	snprintk(name, len, "bench/key%u", idx);
+}
+
+static void test_init(void)
+{
+	int err;
+
+	err = settings_subsys_init();
+	zassert_equal(err, 0, "settings_subsys_init failed (%d)", err);
+
+	/* Loading reads all the stored names */
+	err = settings_load();
+	zassert_equal(err, 0, "settings_load failed (%d)", err);
+}
+
+static void add_keys(uint16_t count)
+{
+	char name[SETTINGS_MAX_NAME_LEN];
+	uint32_t value;
+	int err;
+
+	for (; stored_keys < count; stored_keys++) {
+		key_name(name, sizeof(name), stored_keys);
+		value = stored_keys;
+
+		err = settings_save_one(name, &value, sizeof(value));
+		zassert_equal(err, 0, "Cannot save %s (%d)", name, err);
+	}
+}
+
+/* Update settings spread over all the stored ones and return the average
+ * time of a save in microseconds.
+ */
+static uint32_t save_latency(uint16_t count, uint32_t value)
+{
+	char name[SETTINGS_MAX_NAME_LEN];
+	uint32_t start, cycles = 0U;
+	int err, i;
+
+	for (i = 0; i < SAVE_COUNT; i++) {
+		key_name(name, sizeof(name), i * count / SAVE_COUNT);
+
+		start = k_cycle_get_32();
+		err = settings_save_one(name, &value, sizeof(value));
+		cycles += k_cycle_get_32() - start;
+
+		zassert_equal(err, 0, "Cannot save %s (%d)", name, err);
+	}
+
+	return k_cyc_to_us_floor32(cycles) / SAVE_COUNT;
+}
+
+static void test_save_latency(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(key_counts); i++) {
+		add_keys(key_counts[i]);
+
+		TC_PRINT("%u settings: %u us per save\n", key_counts[i],
+			 save_latency(key_counts[i], 0xC0FFEE00 + i));
+	}
+}
+
+static void test_delete(void)
+{
+	char name[SETTINGS_MAX_NAME_LEN];
+	uint32_t value = 0U, start, delete_cycles, add_cycles;
+	int err;
+
+	key_name(name, sizeof(name), stored_keys / 2);
+
+	start = k_cycle_get_32();
+	err = settings_delete(name);
+	delete_cycles = k_cycle_get_32() - start;
+	zassert_equal(err, 0, "Cannot delete %s (%d)", name, err);
+
+	/* The new setting takes the id that was freed */
+	key_name(name, sizeof(name), stored_keys);
+
+	start = k_cycle_get_32();
+	err = settings_save_one(name, &value, sizeof(value));
+	add_cycles = k_cycle_get_32() - start;
+	zassert_equal(err, 0, "Cannot save %s (%d)", name, err);
+
+	TC_PRINT("%u settings: delete %u us, add after delete %u us\n",
+		 stored_keys, k_cyc_to_us_floor32(delete_cycles),
+		 k_cyc_to_us_floor32(add_cycles));
+}
+
+void test_main(void)
+{
+	ztest_test_suite(settings_nvs_benchmark,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_save_latency),
+			 ztest_unit_test(test_delete));
+
+	ztest_run_test_suite(settings_nvs_benchmark);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Measures the cost of traced kernel calls while all the CPUs emit
+ * events at the same time.  Each CPU runs a thread giving and taking its
+ * own semaphore, which emits four events per iteration when tracing is
+ * enabled.
+ */
+
+#include <ztest.h>
+
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+#include <tracing_buffer.h>
+#endif
+
+#define RUN_MS 500
+#define STACK_SIZE 1024
+#define WORKER_PRIORITY K_PRIO_PREEMPT(5)
+
+struct worker {
+	struct k_thread thread;
+	struct k_sem sem;
+	uint32_t count;
+	uint32_t cycles;
+};
+
+static struct worker workers[CONFIG_MP_NUM_CPUS];
+K_THREAD_STACK_ARRAY_DEFINE(worker_stacks, CONFIG_MP_NUM_CPUS, STACK_SIZE);
+
+static volatile bool go;
+
+static void worker_fn(void *p1, void *p2, void *p3)
+{
+	struct worker *worker = p1;
+	uint32_t duration = k_ms_to_cyc_ceil32(RUN_MS);
+	uint32_t start;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (!go) {
+	}
+
+	start = k_cycle_get_32();
+
+	while (k_cycle_get_32() - start < duration) {
+		k_sem_give(&worker->sem);
+		(void)k_sem_take(&worker->sem, K_NO_WAIT);
+		worker->count++;
+	}
+
+	worker->cycles = k_cycle_get_32() - start;
+}
+
+static void test_trace_overhead(void)
+{
+	uint32_t total = 0, ns;
+	int i;
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		k_sem_init(&workers[i].sem, 0, 1);
+		k_thread_create(&workers[i].thread, worker_stacks[i],
+				STACK_SIZE, worker_fn, &workers[i], NULL, NULL,
+				WORKER_PRIORITY, 0, K_NO_WAIT);
+	}
+
+	go = true;
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		k_thread_join(&workers[i].thread, K_FOREVER);
+
+		ns = (uint32_t)(k_cyc_to_ns_floor64(workers[i].cycles) /
+				MAX(workers[i].count, 1U));
+		total += workers[i].count;
+
+		TC_PRINT("thread %d: %u iterations, %u ns each\n", i,
+			 workers[i].count, ns);
+
+#ifdef CONFIG_TRACING_PER_CPU_BUFFERS
+		TC_PRINT("CPU %d: %u events dropped\n", i,
+			 tracing_cpu_buffer_drops_get(i));
+#endif
+	}
+
+	TC_PRINT("%s: %u iterations/s\n",
+		 !IS_ENABLED(CONFIG_TRACING) ? "no tracing" :
+		 IS_ENABLED(CONFIG_TRACING_PER_CPU_BUFFERS) ?
+		 "per-CPU buffers" : "global buffer",
+		 total * 1000U / RUN_MS);
+
+	zassert_true(total > 0, "No iteration done");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(tracing_overhead,
+			 ztest_unit_test(test_trace_overhead));
+
+	ztest_run_test_suite(tracing_overhead);
+}
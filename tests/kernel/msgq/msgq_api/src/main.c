@@ -21,6 +21,12 @@ extern void test_msgq_purge_when_put(void);
 extern void test_msgq_attrs_get(void);
 extern void test_msgq_alloc(void);
 extern void test_msgq_pend_thread(void);
+extern void test_msgq_claim(void);
+extern void test_msgq_claim_wakeup(void);
+#ifdef CONFIG_MSGQ_LOCKFREE
+extern void test_msgq_lf_spsc(void);
+extern void test_msgq_lf_mpsc(void);
+#endif
 #ifdef CONFIG_USERSPACE
 extern void test_msgq_user_thread(void);
 extern void test_msgq_user_thread_overflow(void);
@@ -43,6 +49,18 @@ dummy_test(test_msgq_user_attrs_get);
 dummy_test(test_msgq_user_purge_when_put);
 #endif /* CONFIG_USERSPACE */
 
+#ifndef CONFIG_MSGQ_LOCKFREE
+static void test_msgq_lf_spsc(void)
+{
+	ztest_test_skip();
+}
+
+static void test_msgq_lf_mpsc(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 #ifdef CONFIG_64BIT
 #define MAX_SZ	256
 #else
@@ -79,6 +97,10 @@ void test_main(void)
 			 ztest_1cpu_unit_test(test_msgq_purge_when_put),
 			 ztest_user_unit_test(test_msgq_user_purge_when_put),
 			 ztest_1cpu_unit_test(test_msgq_pend_thread),
-			 ztest_unit_test(test_msgq_alloc));
+			 ztest_unit_test(test_msgq_alloc),
+			 ztest_unit_test(test_msgq_claim),
+			 ztest_1cpu_unit_test(test_msgq_claim_wakeup),
+			 ztest_unit_test(test_msgq_lf_spsc),
+			 ztest_1cpu_unit_test(test_msgq_lf_mpsc));
 	ztest_run_test_suite(msgq_api);
 }
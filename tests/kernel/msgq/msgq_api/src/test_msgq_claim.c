@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "test_msgq.h"
+
+K_MSGQ_DEFINE(claim_msgq, MSG_SIZE, MSGQ_LEN, 4);
+
+static K_THREAD_STACK_DEFINE(claim_stack, STACK_SIZE);
+static struct k_thread claim_thread;
+
+static void claim_reader(void *p1, void *p2, void *p3)
+{
+	uint32_t rx_data;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	zassert_equal(k_msgq_get(&claim_msgq, &rx_data, K_FOREVER), 0, NULL);
+	zassert_equal(rx_data, MSG0, NULL);
+}
+
+static void claim_writer(void *p1, void *p2, void *p3)
+{
+	uint32_t tx_data = MSG1;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	zassert_equal(k_msgq_put(&claim_msgq, &tx_data, K_FOREVER), 0, NULL);
+}
+
+static void claim_put(uint32_t value)
+{
+	void *ptr;
+
+	zassert_equal(k_msgq_put_claim(&claim_msgq, &ptr), 0, NULL);
+	*(uint32_t *)ptr = value;
+	zassert_equal(k_msgq_put_finish(&claim_msgq), 0, NULL);
+}
+
+static uint32_t claim_get(void)
+{
+	uint32_t value;
+	void *ptr;
+
+	zassert_equal(k_msgq_get_claim(&claim_msgq, &ptr), 0, NULL);
+	value = *(uint32_t *)ptr;
+	zassert_equal(k_msgq_get_finish(&claim_msgq), 0, NULL);
+
+	return value;
+}
+
+/**
+ * @addtogroup kernel_message_queue_tests
+ * @{
+ */
+
+/**
+ * @brief Test sending and receiving messages in place
+ * @see k_msgq_put_claim(), k_msgq_put_finish(), k_msgq_get_claim(),
+ * k_msgq_get_finish()
+ */
+void test_msgq_claim(void)
+{
+	void *ptr, *ptr2;
+
+	zassert_equal(k_msgq_put_finish(&claim_msgq), -EINVAL, NULL);
+	zassert_equal(k_msgq_get_claim(&claim_msgq, &ptr), -ENOMSG, NULL);
+
+	zassert_equal(k_msgq_put_claim(&claim_msgq, &ptr), 0, NULL);
+	/**TESTPOINT: a single message can be claimed at a time */
+	zassert_equal(k_msgq_put_claim(&claim_msgq, &ptr2), -EBUSY, NULL);
+	*(uint32_t *)ptr = MSG0;
+	zassert_equal(k_msgq_num_used_get(&claim_msgq), 0, NULL);
+	zassert_equal(k_msgq_put_finish(&claim_msgq), 0, NULL);
+	zassert_equal(k_msgq_num_used_get(&claim_msgq), 1, NULL);
+
+	claim_put(MSG1);
+	/**TESTPOINT: no message can be claimed in a full queue */
+	zassert_equal(k_msgq_put_claim(&claim_msgq, &ptr), -ENOMSG, NULL);
+
+	zassert_equal(claim_get(), MSG0, NULL);
+	zassert_equal(claim_get(), MSG1, NULL);
+	zassert_equal(k_msgq_get_finish(&claim_msgq), -EINVAL, NULL);
+
+	/**TESTPOINT: purging the queue releases the claimed message */
+	claim_put(MSG0);
+	zassert_equal(k_msgq_get_claim(&claim_msgq, &ptr), 0, NULL);
+	k_msgq_purge(&claim_msgq);
+	zassert_equal(k_msgq_get_finish(&claim_msgq), -EINVAL, NULL);
+}
+
+/**
+ * @brief Test that finishing claims wakes up blocked readers and writers
+ * @see k_msgq_put_finish(), k_msgq_get_finish()
+ */
+void test_msgq_claim_wakeup(void)
+{
+	/**TESTPOINT: a reader waiting on the empty queue gets the message */
+	k_thread_create(&claim_thread, claim_stack, STACK_SIZE,
+			claim_reader, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_sleep(K_MSEC(10));
+
+	claim_put(MSG0);
+	k_thread_join(&claim_thread, K_FOREVER);
+	zassert_equal(k_msgq_num_used_get(&claim_msgq), 0, NULL);
+
+	/**TESTPOINT: a writer waiting on the full queue adds its message */
+	claim_put(MSG0);
+	claim_put(MSG0);
+
+	k_thread_create(&claim_thread, claim_stack, STACK_SIZE,
+			claim_writer, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_sleep(K_MSEC(10));
+
+	zassert_equal(claim_get(), MSG0, NULL);
+	k_thread_join(&claim_thread, K_FOREVER);
+
+	zassert_equal(claim_get(), MSG0, NULL);
+	zassert_equal(claim_get(), MSG1, NULL);
+}
+
+/**
+ * @}
+ */
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "test_msgq.h"
+
+#ifdef CONFIG_MSGQ_LOCKFREE
+
+#define LF_MSGQ_LEN 4
+#define PRODUCERS 2
+
+K_MSGQ_LF_DEFINE(lf_spsc, MSG_SIZE, LF_MSGQ_LEN, 0);
+K_MSGQ_LF_DEFINE(lf_mpsc, MSG_SIZE, LF_MSGQ_LEN, K_MSGQ_LF_MPSC);
+
+static char __aligned(4) lf_buffer[K_MSGQ_LF_BUF_SIZE(MSG_SIZE, LF_MSGQ_LEN)];
+static struct k_msgq_lf lf_msgq;
+
+static K_THREAD_STACK_ARRAY_DEFINE(lf_stacks, PRODUCERS, STACK_SIZE);
+static struct k_thread lf_threads[PRODUCERS];
+
+static void lf_fill_drain(struct k_msgq_lf *q)
+{
+	uint32_t i, rx_data;
+	int ret;
+
+	for (i = 0; i < LF_MSGQ_LEN; i++) {
+		ret = k_msgq_lf_put(q, &i, K_NO_WAIT);
+		zassert_equal(ret, 0, NULL);
+	}
+	zassert_equal(k_msgq_lf_num_used_get(q), LF_MSGQ_LEN, NULL);
+
+	/**TESTPOINT: lock-free msgq put returns -ENOMSG when full */
+	ret = k_msgq_lf_put(q, &i, K_NO_WAIT);
+	zassert_equal(ret, -ENOMSG, NULL);
+	/**TESTPOINT: lock-free msgq put returns -EAGAIN */
+	ret = k_msgq_lf_put(q, &i, TIMEOUT);
+	zassert_equal(ret, -EAGAIN, NULL);
+
+	for (i = 0; i < LF_MSGQ_LEN; i++) {
+		ret = k_msgq_lf_get(q, &rx_data, K_NO_WAIT);
+		zassert_equal(ret, 0, NULL);
+		zassert_equal(rx_data, i, NULL);
+	}
+	zassert_equal(k_msgq_lf_num_used_get(q), 0, NULL);
+
+	/**TESTPOINT: lock-free msgq get returns -ENOMSG when empty */
+	ret = k_msgq_lf_get(q, &rx_data, K_NO_WAIT);
+	zassert_equal(ret, -ENOMSG, NULL);
+	/**TESTPOINT: lock-free msgq get returns -EAGAIN */
+	ret = k_msgq_lf_get(q, &rx_data, TIMEOUT);
+	zassert_equal(ret, -EAGAIN, NULL);
+}
+
+static void lf_isr_put(void *p)
+{
+	uint32_t tx_data = MSG0;
+
+	zassert_equal(k_msgq_lf_put((struct k_msgq_lf *)p, &tx_data,
+				    K_NO_WAIT), 0, NULL);
+}
+
+static void lf_producer(void *p1, void *p2, void *p3)
+{
+	struct k_msgq_lf *q = p1;
+	uint32_t id = POINTER_TO_UINT(p2);
+	uint32_t i, tx_data;
+
+	ARG_UNUSED(p3);
+
+	for (i = 0; i < LF_MSGQ_LEN * 4; i++) {
+		tx_data = (id << 16) | i;
+		zassert_equal(k_msgq_lf_put(q, &tx_data, K_FOREVER), 0, NULL);
+	}
+}
+
+/**
+ * @addtogroup kernel_message_queue_tests
+ * @{
+ */
+
+/**
+ * @brief Test lock-free message queues with a single producer
+ * @see k_msgq_lf_init(), k_msgq_lf_put(), k_msgq_lf_get()
+ */
+void test_msgq_lf_spsc(void)
+{
+	uint32_t rx_data;
+
+	lf_fill_drain(&lf_spsc);
+
+	/* the queue wraps around */
+	lf_fill_drain(&lf_spsc);
+
+	k_msgq_lf_init(&lf_msgq, lf_buffer, MSG_SIZE, LF_MSGQ_LEN, 0);
+	lf_fill_drain(&lf_msgq);
+
+	/**TESTPOINT: lock-free msgq put from ISR */
+	irq_offload(lf_isr_put, &lf_msgq);
+	zassert_equal(k_msgq_lf_get(&lf_msgq, &rx_data, K_NO_WAIT), 0, NULL);
+	zassert_equal(rx_data, MSG0, NULL);
+}
+
+/**
+ * @brief Test lock-free message queues with blocked producers
+ * @details Several threads put more messages than the queue can hold,
+ * blocking when it is full, and each producer's messages are received
+ * in order.
+ * @see k_msgq_lf_put(), k_msgq_lf_get()
+ */
+void test_msgq_lf_mpsc(void)
+{
+	uint32_t next[PRODUCERS] = { 0 };
+	uint32_t i, id, rx_data;
+
+	lf_fill_drain(&lf_mpsc);
+
+	for (i = 0; i < PRODUCERS; i++) {
+		k_thread_create(&lf_threads[i], lf_stacks[i], STACK_SIZE,
+				lf_producer, &lf_mpsc, UINT_TO_POINTER(i), NULL,
+				K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	}
+
+	for (i = 0; i < PRODUCERS * LF_MSGQ_LEN * 4; i++) {
+		zassert_equal(k_msgq_lf_get(&lf_mpsc, &rx_data, K_FOREVER), 0,
+			      NULL);
+
+		id = rx_data >> 16;
+		zassert_true(id < PRODUCERS, NULL);
+		zassert_equal(rx_data & 0xffff, next[id], NULL);
+		next[id]++;
+	}
+
+	for (i = 0; i < PRODUCERS; i++) {
+		k_thread_join(&lf_threads[i], K_FOREVER);
+	}
+
+	zassert_equal(k_msgq_lf_num_used_get(&lf_mpsc), 0, NULL);
+}
+
+/**
+ * @}
+ */
+
+#endif /* CONFIG_MSGQ_LOCKFREE */
@@ -15,6 +15,10 @@ static struct k_mutex mutex;
 static K_THREAD_STACK_DEFINE(tstack, STACK_SIZE);
 static struct k_thread tdata;
 
+static struct k_mutex chain_mutex[2];
+static K_THREAD_STACK_ARRAY_DEFINE(chain_stacks, 2, STACK_SIZE);
+static struct k_thread chain_threads[2];
+
 static void tThread_entry_lock_forever(void *p1, void *p2, void *p3)
 {
 	zassert_false(k_mutex_lock((struct k_mutex *)p1, K_FOREVER) == 0,
@@ -91,6 +95,21 @@ static void tmutex_test_lock_unlock(struct k_mutex *pmutex)
 	k_mutex_unlock(pmutex);
 }
 
+static void tThread_entry_lock_chain(void *p1, void *p2, void *p3)
+{
+	/* take the first mutex, then wait for the one owned by main */
+	zassert_true(k_mutex_lock(&chain_mutex[0], K_FOREVER) == 0, NULL);
+	zassert_true(k_mutex_lock(&chain_mutex[1], K_FOREVER) == 0, NULL);
+	k_mutex_unlock(&chain_mutex[1]);
+	k_mutex_unlock(&chain_mutex[0]);
+}
+
+static void tThread_entry_lock_chain_head(void *p1, void *p2, void *p3)
+{
+	zassert_true(k_mutex_lock(&chain_mutex[0], K_FOREVER) == 0, NULL);
+	k_mutex_unlock(&chain_mutex[0]);
+}
+
 /*test cases*/
 void test_mutex_reent_lock_forever(void)
 {
@@ -140,6 +159,51 @@ void test_mutex_lock_unlock(void)
 	tmutex_test_lock_unlock(&kmutex);
 }
 
+/**
+ * @brief Test priority inheritance along a chain of mutexes
+ * @details The main thread owns a mutex a second thread waits for, while
+ * owning another mutex a third, higher priority, thread waits for. The
+ * main thread inherits the priority of the third thread.
+ * @see k_mutex_lock(), k_mutex_unlock()
+ */
+void test_mutex_priority_inheritance_chain(void)
+{
+	int orig_prio = k_thread_priority_get(k_current_get());
+
+	k_mutex_init(&chain_mutex[0]);
+	k_mutex_init(&chain_mutex[1]);
+
+	k_thread_priority_set(k_current_get(), K_PRIO_PREEMPT(10));
+	zassert_true(k_mutex_lock(&chain_mutex[1], K_FOREVER) == 0, NULL);
+
+	k_thread_create(&chain_threads[0], chain_stacks[0], STACK_SIZE,
+			tThread_entry_lock_chain, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+	zassert_equal(k_thread_priority_get(k_current_get()),
+		      K_PRIO_PREEMPT(8), NULL);
+
+	/**TESTPOINT: the owner of the mutex the waiter's owner waits for
+	 * is boosted too
+	 */
+	k_thread_create(&chain_threads[1], chain_stacks[1], STACK_SIZE,
+			tThread_entry_lock_chain_head, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(5), 0, K_NO_WAIT);
+	zassert_equal(k_thread_priority_get(&chain_threads[0]),
+		      K_PRIO_PREEMPT(5), NULL);
+	zassert_equal(k_thread_priority_get(k_current_get()),
+		      K_PRIO_PREEMPT(5), NULL);
+
+	/**TESTPOINT: the priority is restored on unlock */
+	k_mutex_unlock(&chain_mutex[1]);
+	zassert_equal(k_thread_priority_get(k_current_get()),
+		      K_PRIO_PREEMPT(10), NULL);
+
+	k_thread_join(&chain_threads[1], K_FOREVER);
+	k_thread_join(&chain_threads[0], K_FOREVER);
+
+	k_thread_priority_set(k_current_get(), orig_prio);
+}
+
 /*test case main entry*/
 void test_main(void)
 {
@@ -151,7 +215,8 @@ void test_main(void)
 			 ztest_1cpu_user_unit_test(test_mutex_reent_lock_forever),
 			 ztest_user_unit_test(test_mutex_reent_lock_no_wait),
 			 ztest_user_unit_test(test_mutex_reent_lock_timeout_fail),
-			 ztest_1cpu_user_unit_test(test_mutex_reent_lock_timeout_pass)
+			 ztest_1cpu_user_unit_test(test_mutex_reent_lock_timeout_pass),
+			 ztest_1cpu_unit_test(test_mutex_priority_inheritance_chain)
 			 );
 	ztest_run_test_suite(mutex_api);
 }
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+
+#define PIPE_SIZE 8
+#define STACK_SIZE (512 + CONFIG_TEST_EXTRA_STACKSIZE)
+
+K_PIPE_DEFINE(claim_pipe, PIPE_SIZE, 4);
+
+static K_THREAD_STACK_DEFINE(claim_stack, STACK_SIZE);
+static struct k_thread claim_thread;
+
+static const unsigned char claim_data[] = "0123456789abcdef";
+
+static void claim_put(const unsigned char *src, size_t size)
+{
+	size_t claimed, done = 0;
+	uint8_t *dst;
+
+	while (done < size) {
+		claimed = k_pipe_put_claim(&claim_pipe, &dst, size - done);
+		zassert_true(claimed > 0, "no space claimed");
+		memcpy(dst, src + done, claimed);
+		done += claimed;
+	}
+
+	zassert_equal(k_pipe_put_finish(&claim_pipe, size), 0, NULL);
+}
+
+static void claim_reader(void *p1, void *p2, void *p3)
+{
+	unsigned char buf[4];
+	size_t read;
+	int ret;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	ret = k_pipe_get(&claim_pipe, buf, sizeof(buf), &read, sizeof(buf),
+			 K_FOREVER);
+	zassert_equal(ret, 0, NULL);
+	zassert_equal(read, sizeof(buf), NULL);
+	zassert_mem_equal(buf, claim_data, sizeof(buf), NULL);
+}
+
+static void claim_writer(void *p1, void *p2, void *p3)
+{
+	size_t written;
+	int ret;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	ret = k_pipe_put(&claim_pipe, (void *)&claim_data[PIPE_SIZE], 4,
+			 &written, 4, K_FOREVER);
+	zassert_equal(ret, 0, NULL);
+	zassert_equal(written, 4, NULL);
+}
+
+/**
+ * @addtogroup kernel_pipe_tests
+ * @{
+ */
+
+/**
+ * @brief Test claiming space and data across the end of the pipe buffer
+ * @see k_pipe_put_claim(), k_pipe_put_finish(), k_pipe_get_claim(),
+ * k_pipe_get_finish()
+ */
+void test_pipe_claim_wrap(void)
+{
+	unsigned char buf[PIPE_SIZE];
+	size_t claimed, read;
+	uint8_t *ptr;
+
+	claim_put(claim_data, 6);
+
+	claimed = k_pipe_get_claim(&claim_pipe, &ptr, 4);
+	zassert_equal(claimed, 4, NULL);
+	zassert_mem_equal(ptr, claim_data, 4, NULL);
+	zassert_equal(k_pipe_get_finish(&claim_pipe, 5), -EINVAL, NULL);
+	zassert_equal(k_pipe_get_finish(&claim_pipe, 4), 0, NULL);
+
+	/* the free space wraps around, it is claimed in two parts */
+	claimed = k_pipe_put_claim(&claim_pipe, &ptr, PIPE_SIZE);
+	zassert_equal(claimed, 2, NULL);
+	claimed = k_pipe_put_claim(&claim_pipe, &ptr, PIPE_SIZE);
+	zassert_equal(claimed, 4, NULL);
+	zassert_equal(k_pipe_put_claim(&claim_pipe, &ptr, PIPE_SIZE), 0,
+		      "full pipe claimed");
+	zassert_equal(k_pipe_put_finish(&claim_pipe, 0), 0, NULL);
+
+	claim_put(&claim_data[6], 6);
+	zassert_equal(k_pipe_read_avail(&claim_pipe), PIPE_SIZE, NULL);
+
+	zassert_equal(k_pipe_get(&claim_pipe, buf, sizeof(buf), &read,
+				 sizeof(buf), K_NO_WAIT), 0, NULL);
+	zassert_mem_equal(buf, &claim_data[4], sizeof(buf), NULL);
+
+	zassert_equal(k_pipe_get_claim(&claim_pipe, &ptr, 1), 0,
+		      "empty pipe claimed");
+	zassert_equal(k_pipe_get_finish(&claim_pipe, 0), 0, NULL);
+}
+
+/**
+ * @brief Test that finishing claims wakes up blocked readers and writers
+ * @see k_pipe_put_finish(), k_pipe_get_finish()
+ */
+void test_pipe_claim_wakeup(void)
+{
+	size_t claimed;
+	uint8_t *ptr;
+
+	/**TESTPOINT: a reader waiting on the empty pipe gets the data */
+	k_thread_create(&claim_thread, claim_stack, STACK_SIZE,
+			claim_reader, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_sleep(K_MSEC(10));
+
+	claim_put(claim_data, 4);
+	k_thread_join(&claim_thread, K_FOREVER);
+	zassert_equal(k_pipe_read_avail(&claim_pipe), 0, NULL);
+
+	/**TESTPOINT: a writer waiting on the full pipe fills the space */
+	claim_put(claim_data, PIPE_SIZE);
+
+	k_thread_create(&claim_thread, claim_stack, STACK_SIZE,
+			claim_writer, NULL, NULL, NULL,
+			K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+	k_sleep(K_MSEC(10));
+
+	claimed = k_pipe_get_claim(&claim_pipe, &ptr, 4);
+	zassert_equal(claimed, 4, NULL);
+	zassert_equal(k_pipe_get_finish(&claim_pipe, 4), 0, NULL);
+	k_thread_join(&claim_thread, K_FOREVER);
+
+	/* the writer's data follows the data left in the pipe */
+	zassert_equal(k_pipe_read_avail(&claim_pipe), PIPE_SIZE, NULL);
+	claimed = k_pipe_get_claim(&claim_pipe, &ptr, PIPE_SIZE);
+	zassert_equal(claimed, 4, NULL);
+	zassert_mem_equal(ptr, &claim_data[4], 4, NULL);
+	claimed = k_pipe_get_claim(&claim_pipe, &ptr, PIPE_SIZE);
+	zassert_equal(claimed, 4, NULL);
+	zassert_mem_equal(ptr, &claim_data[PIPE_SIZE], 4, NULL);
+	zassert_equal(k_pipe_get_finish(&claim_pipe, PIPE_SIZE), 0, NULL);
+}
+
+/**
+ * @}
+ */
@@ -90,9 +90,117 @@ void test_deadline(void)
 	}
 }
 
+#ifdef CONFIG_SCHED_CBS
+#define CBS_PERIOD_US 50000
+#define CBS_BUDGET_US 2000
+#define CBS_JOB_US 30000
+
+struct k_thread cbs_thread;
+K_THREAD_STACK_DEFINE(cbs_stack, STACK_SIZE);
+
+static volatile int cbs_overruns;
+static volatile bool cbs_stop;
+
+static void cbs_overrun(struct k_thread *thread)
+{
+	zassert_equal(thread, &cbs_thread, "wrong thread overran");
+	cbs_overruns++;
+}
+
+static void cbs_worker(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (!cbs_stop) {
+		/* a job well over its budget */
+		k_busy_wait(CBS_JOB_US);
+		zassert_equal(k_thread_period_wait(), 0, NULL);
+	}
+}
+
+void test_cbs_admission(void)
+{
+	struct k_thread *threads = worker_threads;
+	uint32_t util = k_sched_cbs_utilization_get();
+
+	zassert_equal(k_thread_cbs_set(&threads[0], 2000, 1000, NULL),
+		      -EINVAL, "budget longer than period accepted");
+	zassert_equal(k_thread_cbs_set(&threads[0], 1000, 0, NULL),
+		      -EINVAL, "zero period accepted");
+
+	zassert_equal(k_thread_cbs_set(&threads[0], 600, 1000, NULL), 0,
+		      NULL);
+	zassert_equal(k_sched_cbs_utilization_get(), util + 600000U, NULL);
+
+	/**TESTPOINT: the total bandwidth is limited */
+	zassert_equal(k_thread_cbs_set(&threads[1], 10000, 20000, NULL),
+		      -EBUSY, "bandwidth over-committed");
+	zassert_equal(k_thread_cbs_set(&threads[1], 4000, 20000, NULL), 0,
+		      NULL);
+	zassert_equal(k_sched_cbs_utilization_get(), util + 800000U, NULL);
+
+	/**TESTPOINT: changing the budget of a thread reuses its share */
+	zassert_equal(k_thread_cbs_set(&threads[0], 800, 1000, NULL), 0,
+		      NULL);
+	zassert_equal(k_sched_cbs_utilization_get(), util + 1000000U, NULL);
+
+	zassert_equal(k_thread_cbs_set(&threads[0], 0, 0, NULL), 0, NULL);
+	zassert_equal(k_thread_cbs_set(&threads[1], 0, 0, NULL), 0, NULL);
+	zassert_equal(k_sched_cbs_utilization_get(), util, NULL);
+}
+
+void test_cbs_overrun(void)
+{
+	struct k_thread_cbs_stats stats;
+
+	cbs_stop = false;
+	cbs_overruns = 0;
+
+	k_thread_create(&cbs_thread, cbs_stack, STACK_SIZE, cbs_worker,
+			NULL, NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO,
+			0, K_FOREVER);
+
+	zassert_equal(k_thread_period_wait(), -EINVAL, NULL);
+	zassert_equal(k_thread_cbs_stats_get(&cbs_thread, &stats), -EINVAL,
+		      NULL);
+
+	zassert_equal(k_thread_cbs_set(&cbs_thread, CBS_BUDGET_US,
+				       CBS_PERIOD_US, cbs_overrun), 0, NULL);
+	k_thread_start(&cbs_thread);
+
+	k_sleep(K_USEC(4 * CBS_PERIOD_US));
+	cbs_stop = true;
+
+	zassert_equal(k_thread_cbs_stats_get(&cbs_thread, &stats), 0, NULL);
+
+	/**TESTPOINT: overruns of the budget are reported */
+	zassert_true(stats.jobs >= 2U, "periodic jobs did not run");
+	zassert_true(stats.overruns >= stats.jobs, "overrun not detected");
+	zassert_true(cbs_overruns > 0, "overrun handler not called");
+
+	/**TESTPOINT: exiting releases the bandwidth of the thread */
+	k_thread_join(&cbs_thread, K_FOREVER);
+	zassert_equal(k_sched_cbs_utilization_get(), 0U, NULL);
+}
+#else
+void test_cbs_admission(void)
+{
+	ztest_test_skip();
+}
+
+void test_cbs_overrun(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 void test_main(void)
 {
 	ztest_test_suite(suite_deadline,
-			 ztest_unit_test(test_deadline));
+			 ztest_unit_test(test_deadline),
+			 ztest_unit_test(test_cbs_admission),
+			 ztest_unit_test(test_cbs_overrun));
 	ztest_run_test_suite(suite_deadline);
 }
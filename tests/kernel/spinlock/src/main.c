@@ -20,6 +20,24 @@ static struct k_spinlock bounce_lock;
 
 volatile int bounce_owner, bounce_done;
 
+#define CONTENTION_MS 500
+#define CONTENTION_STACK_SIZE 1024
+
+K_THREAD_STACK_ARRAY_DEFINE(contention_stacks, CONFIG_MP_NUM_CPUS,
+			    CONTENTION_STACK_SIZE);
+static struct k_thread contention_threads[CONFIG_MP_NUM_CPUS];
+
+static struct k_spinlock contention_lock;
+static volatile bool contention_go;
+static volatile uint32_t contention_total;
+
+struct contention_stats {
+	uint32_t count;
+	uint32_t max_cycles;
+};
+
+static struct contention_stats contention_stats[CONFIG_MP_NUM_CPUS];
+
 /**
  * @brief Tests for spinlock
  *
@@ -54,6 +72,86 @@ void test_spinlock_basic(void)
 	zassert_true(!l.locked, "Spinlock failed to unlock");
 }
 
+static void contention_fn(void *p1, void *p2, void *p3)
+{
+	struct contention_stats *stats = p1;
+	uint32_t duration = k_ms_to_cyc_ceil32(CONTENTION_MS);
+	uint32_t start, t0, cycles;
+	k_spinlock_key_t key;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (!contention_go) {
+	}
+
+	start = k_cycle_get_32();
+
+	while (k_cycle_get_32() - start < duration) {
+		t0 = k_cycle_get_32();
+		key = k_spin_lock(&contention_lock);
+		cycles = k_cycle_get_32() - t0;
+
+		/* Hold the lock for a little while, like a short critical
+		 * section would.
+		 */
+		contention_total++;
+		for (volatile int i = 0; i < 10; i++) {
+		}
+
+		k_spin_unlock(&contention_lock, key);
+
+		stats->count++;
+		stats->max_cycles = MAX(stats->max_cycles, cycles);
+	}
+}
+
+/**
+ * @brief Measure spinlock throughput and fairness under contention
+ *
+ * One thread per CPU takes and releases the same lock in a loop.  The
+ * number of acquisitions of each thread and the worst time it waited
+ * for the lock are reported.
+ *
+ * @ingroup kernel_spinlock_tests
+ *
+ * @see k_spin_lock(), k_spin_unlock()
+ */
+void test_spinlock_contention(void)
+{
+	uint32_t total = 0, min_count = UINT32_MAX, max_cycles = 0;
+	int i;
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		k_thread_create(&contention_threads[i], contention_stacks[i],
+				CONTENTION_STACK_SIZE, contention_fn,
+				&contention_stats[i], NULL, NULL,
+				0, 0, K_NO_WAIT);
+	}
+
+	contention_go = true;
+
+	for (i = 0; i < CONFIG_MP_NUM_CPUS; i++) {
+		k_thread_join(&contention_threads[i], K_FOREVER);
+
+		total += contention_stats[i].count;
+		min_count = MIN(min_count, contention_stats[i].count);
+		max_cycles = MAX(max_cycles, contention_stats[i].max_cycles);
+
+		TC_PRINT("thread %d: %u locks, worst wait %u ns\n", i,
+			 contention_stats[i].count,
+			 k_cyc_to_ns_ceil32(contention_stats[i].max_cycles));
+	}
+
+	TC_PRINT("%s lock, %d CPUs: %u locks/s, worst wait %u ns\n",
+		 IS_ENABLED(CONFIG_SPIN_TICKET) ? "ticket" : "simple",
+		 CONFIG_MP_NUM_CPUS, total * 1000 / CONTENTION_MS,
+		 k_cyc_to_ns_ceil32(max_cycles));
+
+	zassert_equal(total, contention_total, "Lost updates under the lock");
+	zassert_true(min_count > 0, "A thread never got the lock");
+}
+
 void bounce_once(int id)
 {
 	int i, locked;
@@ -133,6 +231,7 @@ void test_main(void)
 {
 	ztest_test_suite(spinlock,
 			 ztest_unit_test(test_spinlock_basic),
+			 ztest_unit_test(test_spinlock_contention),
 			 ztest_unit_test(test_spinlock_bounce));
 	ztest_run_test_suite(spinlock);
 }
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <ztest.h>
+#include <kernel.h>
+
+#include "tests_thread_apis.h"
+
+#define BUSY_MS 100
+
+static K_SEM_DEFINE(busy_done_sem, 0, 1);
+static K_SEM_DEFINE(busy_go_sem, 0, 1);
+
+static void busy_entry(void *p1, void *p2, void *p3)
+{
+	k_busy_wait(BUSY_MS * USEC_PER_MSEC);
+	k_sem_give(&busy_done_sem);
+
+	k_sem_take(&busy_go_sem, K_FOREVER);
+	k_busy_wait(BUSY_MS * USEC_PER_MSEC);
+}
+
+/**
+ * @ingroup kernel_thread_tests
+ * @brief Check the execution cycles given by k_thread_runtime_stats_get()
+ *
+ * @details A thread busy looping twice gets at least half of each loop
+ * counted, interrupts could take the rest, and the test thread, pending
+ * meanwhile, does not get the loops counted.
+ *
+ * @see k_thread_runtime_stats_get()
+ */
+void test_threads_runtime_stats(void)
+{
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+	k_thread_runtime_stats_t self_before, self_after, first, second;
+	uint64_t busy_cycles = k_ms_to_cyc_floor64(BUSY_MS);
+	k_tid_t tid;
+	int ret;
+
+	ret = k_thread_runtime_stats_get(NULL, &first);
+	zassert_equal(ret, -EINVAL, "NULL thread accepted");
+	ret = k_thread_runtime_stats_get(k_current_get(), NULL);
+	zassert_equal(ret, -EINVAL, "NULL stats accepted");
+
+	ret = k_thread_runtime_stats_get(k_current_get(), &self_before);
+	zassert_equal(ret, 0, NULL);
+
+	tid = k_thread_create(&tdata, tstack, STACK_SIZE, busy_entry,
+			      NULL, NULL, NULL, K_PRIO_PREEMPT(1), 0,
+			      K_NO_WAIT);
+
+	k_sem_take(&busy_done_sem, K_FOREVER);
+
+	ret = k_thread_runtime_stats_get(tid, &first);
+	zassert_equal(ret, 0, NULL);
+	ret = k_thread_runtime_stats_get(k_current_get(), &self_after);
+	zassert_equal(ret, 0, NULL);
+
+	/** TESTPOINT: the busy thread got its loop counted */
+	zassert_true(first.execution_cycles >= busy_cycles / 2,
+		     "busy thread ran %llu cycles, expected %llu",
+		     first.execution_cycles, busy_cycles);
+
+	/** TESTPOINT: the test thread did not get the loop counted */
+	zassert_true(self_after.execution_cycles -
+		     self_before.execution_cycles < busy_cycles / 2,
+		     "test thread ran %llu cycles while pending",
+		     self_after.execution_cycles -
+		     self_before.execution_cycles);
+
+	k_sem_give(&busy_go_sem);
+	k_thread_join(tid, K_FOREVER);
+
+	ret = k_thread_runtime_stats_get(tid, &second);
+	zassert_equal(ret, 0, NULL);
+
+	/** TESTPOINT: the execution cycles grow with the second loop */
+	zassert_true(second.execution_cycles >=
+		     first.execution_cycles + busy_cycles / 2,
+		     "busy thread ran %llu cycles, then %llu",
+		     first.execution_cycles, second.execution_cycles);
+#else
+	ztest_test_skip();
+#endif
+}
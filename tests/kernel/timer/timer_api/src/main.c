@@ -668,6 +668,66 @@ void test_timeout_abs(void)
 #endif
 }
 
+#if defined(CONFIG_TIMEOUT_SLACK) && defined(CONFIG_TICKLESS_KERNEL)
+static struct k_timer slack_timer;
+static struct k_timer slack_late_timer;
+
+static void slack_expire(struct k_timer *timer)
+{
+	*(uint32_t *)k_timer_user_data_get(timer) = k_cycle_get_32();
+}
+#endif
+
+/**
+ * @brief Test timers allowed to expire late
+ *
+ * Validates that a timer with slack expires along with a later timer
+ * within its slack, and that it does not expire later than its slack
+ * allows otherwise.
+ *
+ * @ingroup kernel_timer_tests
+ *
+ * @see k_timer_slack_set()
+ */
+void test_timer_slack(void)
+{
+#if defined(CONFIG_TIMEOUT_SLACK) && defined(CONFIG_TICKLESS_KERNEL)
+	uint32_t tick_cyc = k_ticks_to_cyc_ceil32(1);
+	uint32_t start, first_cyc, late_cyc;
+
+	k_timer_init(&slack_timer, slack_expire, NULL);
+	k_timer_init(&slack_late_timer, slack_expire, NULL);
+	k_timer_user_data_set(&slack_timer, &first_cyc);
+	k_timer_user_data_set(&slack_late_timer, &late_cyc);
+
+	/**TESTPOINT: the timers share a wakeup */
+	k_timer_slack_set(&slack_timer, K_TICKS(20));
+	k_usleep(1); /* align to tick */
+	k_timer_start(&slack_timer, K_TICKS(10), K_NO_WAIT);
+	k_timer_start(&slack_late_timer, K_TICKS(15), K_NO_WAIT);
+	k_timer_status_sync(&slack_late_timer);
+
+	zassert_equal(k_timer_status_get(&slack_timer), 1, NULL);
+	zassert_true(late_cyc - first_cyc < tick_cyc,
+		     "timers expired %u cycles apart", late_cyc - first_cyc);
+
+	/**TESTPOINT: the slack bounds the delay of the expiry */
+	k_timer_slack_set(&slack_timer, K_TICKS(2));
+	k_usleep(1); /* align to tick */
+	start = k_cycle_get_32();
+	k_timer_start(&slack_timer, K_TICKS(10), K_NO_WAIT);
+	k_timer_start(&slack_late_timer, K_TICKS(20), K_NO_WAIT);
+	k_timer_status_sync(&slack_late_timer);
+
+	zassert_true(first_cyc - start <= 13 * tick_cyc,
+		     "timer expired %u cycles late", first_cyc - start);
+	zassert_true(late_cyc - first_cyc >= 7 * tick_cyc,
+		     "timers expired together");
+#else
+	ztest_test_skip();
+#endif
+}
+
 static void timer_init(struct k_timer *timer, k_timer_expiry_t expiry_fn,
 		       k_timer_stop_t stop_fn)
 {
@@ -702,6 +762,7 @@ void test_main(void)
 			 ztest_user_unit_test(test_timer_k_define),
 			 ztest_user_unit_test(test_timer_user_data),
 			 ztest_user_unit_test(test_timer_remaining),
-			 ztest_user_unit_test(test_timeout_abs));
+			 ztest_user_unit_test(test_timeout_abs),
+			 ztest_unit_test(test_timer_slack));
 	ztest_run_test_suite(timer_api);
 }
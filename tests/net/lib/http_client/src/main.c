@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_HTTP_LOG_LEVEL);
+
+#include <ztest.h>
+
+#include <net/socket.h>
+#include <net/http_client.h>
+
+#define SERVER_ADDR "192.0.2.1"
+#define SERVER_PORT 8080
+
+#define RESPONSE_BODY "Hello, world!"
+#define RESPONSE "HTTP/1.1 200 OK\r\n"			\
+		 "Content-Type: text/plain\r\n"		\
+		 "Content-Length: 13\r\n"		\
+		 "\r\n"					\
+		 RESPONSE_BODY
+
+/* Answer to requests for ERROR_URL, with a body to be skipped */
+#define ERROR_URL "/error"
+#define ERROR_RESPONSE "HTTP/1.1 500 Internal Server Error\r\n"	\
+		       "Content-Type: text/plain\r\n"			\
+		       "Content-Length: 14\r\n"			\
+		       "\r\n"						\
+		       "Server failure"
+
+#define RESPONSE_LEN MAX(sizeof(RESPONSE), sizeof(ERROR_RESPONSE))
+
+#define REQUEST_END "\r\n\r\n"
+
+/* Number of requests done in each measurement */
+#define REQUEST_COUNT 64
+
+/* Number of requests sent back to back when pipelining */
+#define PIPELINE_DEPTH 8
+
+#define TIMEOUT_MS 3000
+
+#define SERVER_STACK_SIZE 2048
+#define SERVER_PRIORITY K_PRIO_COOP(8)
+
+K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+
+static uint8_t server_buf[512];
+static char server_send_buf[PIPELINE_DEPTH * (RESPONSE_LEN - 1)];
+static int server_requests;
+
+static uint8_t recv_buf[PIPELINE_DEPTH][128];
+static struct http_request reqs[PIPELINE_DEPTH];
+static int responses_ok;
+
+static const char *find_request_end(const uint8_t *buf, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i + sizeof(REQUEST_END) - 1 <= len; i++) {
+		if (memcmp(&buf[i], REQUEST_END,
+			   sizeof(REQUEST_END) - 1) == 0) {
+			return (const char *)&buf[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Minimal HTTP server stub. It answers every request with the same response,
+ * or an error for ERROR_URL, and keeps the connection open until the client
+ * closes it. All the
+ * responses to the requests found in one received block are sent with a
+ * single send() call so that the client sees several responses in one read.
+ */
+static void server_handle_conn(int sock)
+{
+	size_t pos = 0, send_len;
+	const char *end;
+	int ret;
+
+	while (true) {
+		ret = recv(sock, server_buf + pos, sizeof(server_buf) - pos,
+			   0);
+		if (ret <= 0) {
+			break;
+		}
+
+		pos += ret;
+		send_len = 0;
+
+		while ((end = find_request_end(server_buf, pos)) != NULL) {
+			size_t req_len = (const uint8_t *)end - server_buf +
+					 sizeof(REQUEST_END) - 1;
+			const char *rsp = RESPONSE;
+			size_t rsp_len;
+
+			if (memcmp(server_buf, "GET " ERROR_URL " ",
+				   sizeof("GET " ERROR_URL " ") - 1) == 0) {
+				rsp = ERROR_RESPONSE;
+			}
+
+			rsp_len = strlen(rsp);
+
+			if (send_len + rsp_len > sizeof(server_send_buf)) {
+				break;
+			}
+
+			memcpy(server_send_buf + send_len, rsp, rsp_len);
+			send_len += rsp_len;
+
+			memmove(server_buf, server_buf + req_len,
+				pos - req_len);
+			pos -= req_len;
+
+			server_requests++;
+		}
+
+		if (send_len > 0) {
+			ret = send(sock, server_send_buf, send_len, 0);
+			if (ret < 0) {
+				break;
+			}
+		}
+	}
+
+	(void)close(sock);
+}
+
+static void server(void *p1, void *p2, void *p3)
+{
+	struct sockaddr_in addr;
+	int sock, client;
+	int ret;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(sock >= 0, "Cannot create server socket (%d)", errno);
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(SERVER_PORT);
+
+	ret = bind(sock, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(ret, 0, "Cannot bind (%d)", errno);
+
+	ret = listen(sock, 1);
+	zassert_equal(ret, 0, "Cannot listen (%d)", errno);
+
+	while (true) {
+		client = accept(sock, NULL, NULL);
+		if (client < 0) {
+			continue;
+		}
+
+		server_handle_conn(client);
+	}
+}
+
+static int connect_to_server(void)
+{
+	struct sockaddr_in addr;
+	int sock, ret;
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(sock >= 0, "Cannot create socket (%d)", errno);
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(SERVER_PORT);
+	inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr);
+
+	ret = connect(sock, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(ret, 0, "Cannot connect (%d)", errno);
+
+	return sock;
+}
+
+static void response_cb(struct http_response *rsp,
+			enum http_final_call final_data,
+			void *user_data)
+{
+	if (final_data != HTTP_DATA_FINAL) {
+		return;
+	}
+
+	if (rsp->message_complete &&
+	    rsp->processed == sizeof(RESPONSE_BODY) - 1 &&
+	    strcmp(rsp->http_status, "OK") == 0) {
+		responses_ok++;
+	}
+}
+
+static void setup_requests(void)
+{
+	int i;
+
+	memset(reqs, 0, sizeof(reqs));
+
+	for (i = 0; i < PIPELINE_DEPTH; i++) {
+		reqs[i].method = HTTP_GET;
+		reqs[i].url = "/";
+		reqs[i].host = SERVER_ADDR;
+		reqs[i].protocol = "HTTP/1.1";
+		reqs[i].response = response_cb;
+		reqs[i].recv_buf = recv_buf[i];
+		reqs[i].recv_buf_len = sizeof(recv_buf[i]);
+	}
+
+	responses_ok = 0;
+}
+
+static void print_rate(const char *name, int count, int64_t elapsed)
+{
+	TC_PRINT("%s: %d requests in %d ms (%d requests/sec)\n", name, count,
+		 (int)elapsed, elapsed ? (int)(count * 1000 / elapsed) : 0);
+}
+
+static void test_new_connection_per_request(void)
+{
+	int64_t start;
+	int i, sock, ret;
+
+	setup_requests();
+
+	start = k_uptime_get();
+
+	for (i = 0; i < REQUEST_COUNT; i++) {
+		sock = connect_to_server();
+
+		ret = http_client_req(sock, &reqs[0], TIMEOUT_MS, NULL);
+		zassert_true(ret > 0, "Cannot send request (%d)", ret);
+
+		(void)close(sock);
+	}
+
+	print_rate("new connection per request", REQUEST_COUNT,
+		   k_uptime_delta(&start));
+
+	zassert_equal(responses_ok, REQUEST_COUNT,
+		      "Got %d valid responses instead of %d", responses_ok,
+		      REQUEST_COUNT);
+}
+
+static void test_keep_alive(void)
+{
+	int64_t start;
+	int i, sock, ret;
+
+	setup_requests();
+
+	sock = connect_to_server();
+
+	start = k_uptime_get();
+
+	for (i = 0; i < REQUEST_COUNT; i++) {
+		ret = http_client_req(sock, &reqs[0], TIMEOUT_MS, NULL);
+		zassert_true(ret > 0, "Cannot send request (%d)", ret);
+		zassert_true(reqs[0].internal.response.keep_alive,
+			     "Connection cannot be reused");
+	}
+
+	print_rate("keep-alive", REQUEST_COUNT, k_uptime_delta(&start));
+
+	(void)close(sock);
+
+	zassert_equal(responses_ok, REQUEST_COUNT,
+		      "Got %d valid responses instead of %d", responses_ok,
+		      REQUEST_COUNT);
+}
+
+static void test_pipeline(void)
+{
+	struct http_request *req_list[PIPELINE_DEPTH];
+	int64_t start;
+	int i, sock, ret;
+
+	setup_requests();
+
+	for (i = 0; i < PIPELINE_DEPTH; i++) {
+		req_list[i] = &reqs[i];
+	}
+
+	sock = connect_to_server();
+
+	start = k_uptime_get();
+
+	for (i = 0; i < REQUEST_COUNT / PIPELINE_DEPTH; i++) {
+		ret = http_client_req_pipeline(sock, req_list, PIPELINE_DEPTH,
+					       TIMEOUT_MS, NULL);
+		zassert_equal(ret, PIPELINE_DEPTH,
+			      "Got %d responses instead of %d", ret,
+			      PIPELINE_DEPTH);
+	}
+
+	print_rate("pipelined", REQUEST_COUNT, k_uptime_delta(&start));
+
+	(void)close(sock);
+
+	zassert_equal(responses_ok, REQUEST_COUNT,
+		      "Got %d valid responses instead of %d", responses_ok,
+		      REQUEST_COUNT);
+}
+
+/* The body of an error response must not be taken for the next response */
+static void test_error_keep_alive(void)
+{
+	int sock, ret;
+
+	setup_requests();
+
+	sock = connect_to_server();
+
+	reqs[0].url = ERROR_URL;
+
+	ret = http_client_req(sock, &reqs[0], TIMEOUT_MS, NULL);
+	zassert_true(ret > 0, "Cannot send request (%d)", ret);
+	zassert_true(reqs[0].internal.response.message_complete,
+		     "Error response not complete");
+	zassert_equal(reqs[0].internal.parser.status_code, 500,
+		      "Invalid status %d",
+		      reqs[0].internal.parser.status_code);
+	zassert_true(reqs[0].internal.response.keep_alive,
+		     "Connection cannot be reused");
+
+	reqs[0].url = "/";
+
+	ret = http_client_req(sock, &reqs[0], TIMEOUT_MS, NULL);
+	zassert_true(ret > 0, "Cannot send request (%d)", ret);
+
+	(void)close(sock);
+
+	zassert_equal(responses_ok, 1, "Response after the error is invalid");
+}
+
+static void test_pipeline_invalid(void)
+{
+	struct http_request *req_list[1] = { &reqs[0] };
+	int ret;
+
+	setup_requests();
+
+	ret = http_client_req_pipeline(-1, req_list, 1, TIMEOUT_MS, NULL);
+	zassert_equal(ret, -EINVAL, "Invalid socket accepted");
+
+	ret = http_client_req_pipeline(0, req_list, 0, TIMEOUT_MS, NULL);
+	zassert_equal(ret, -EINVAL, "Empty pipeline accepted");
+
+	reqs[0].response = NULL;
+
+	ret = http_client_req_pipeline(0, req_list, 1, TIMEOUT_MS, NULL);
+	zassert_equal(ret, -EINVAL, "Request without callback accepted");
+}
+
+void test_main(void)
+{
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack),
+			server, NULL, NULL, NULL,
+			SERVER_PRIORITY, 0, K_NO_WAIT);
+
+	/* Let the server start listening */
+	k_sleep(K_MSEC(100));
+
+	ztest_test_suite(http_client,
+			 ztest_unit_test(test_pipeline_invalid),
+			 ztest_unit_test(test_new_connection_per_request),
+			 ztest_unit_test(test_keep_alive),
+			 ztest_unit_test(test_error_keep_alive),
+			 ztest_unit_test(test_pipeline));
+
+	ztest_run_test_suite(http_client);
+}
@@ -0,0 +1,449 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_HTTP_SERVER_LOG_LEVEL);
+
+#include <ztest.h>
+
+#include <net/socket.h>
+#include <net/http_client.h>
+#include <net/http_server.h>
+
+#if defined(CONFIG_FILE_SYSTEM)
+#include <fs/fs.h>
+#include <fs/littlefs.h>
+#include <storage/flash_map.h>
+
+#define MNT_POINT "/lfs"
+#define FILE_PATH MNT_POINT "/file.txt"
+#define EMPTY_PATH MNT_POINT "/empty.txt"
+
+/* Larger than the transmit buffer of a connection, so that the file is
+ * read in several parts.
+ */
+#define FILE_SIZE 1500
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(storage);
+static struct fs_mount_t mnt = {
+	.type = FS_LITTLEFS,
+	.fs_data = &storage,
+	.storage_dev = (void *)FLASH_AREA_ID(storage),
+	.mnt_point = MNT_POINT,
+};
+#endif
+
+#define SERVER_ADDR "192.0.2.1"
+#define SERVER_PORT 8080
+
+#define TIMEOUT_MS 3000
+
+/* Number of requests done in each measurement */
+#define REQUEST_COUNT 100
+
+#define SERVER_STACK_SIZE 2048
+#define SERVER_PRIORITY K_PRIO_PREEMPT(8)
+
+K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+static struct http_server_ctx server_ctx;
+
+static const uint8_t index_html[] =
+	"<html><body><h1>Hello from Zephyr</h1></body></html>\n";
+
+/* Number of chunks the dynamic resource generates */
+#define DYNAMIC_CHUNKS 5
+#define DYNAMIC_LINE "counter line\n"
+
+static int dynamic_cb(struct http_server_request *req, uint8_t *buf,
+		      size_t len, void *user_data)
+{
+	size_t line_len = sizeof(DYNAMIC_LINE) - 1;
+
+	ARG_UNUSED(user_data);
+
+	if (req->offset >= DYNAMIC_CHUNKS * line_len) {
+		return 0;
+	}
+
+	/* runs in the server thread, the error is seen by the client */
+	if (len < line_len) {
+		return -ENOMEM;
+	}
+
+	memcpy(buf, DYNAMIC_LINE, line_len);
+
+	return line_len;
+}
+
+static const struct http_server_resource resources[] = {
+	{
+		.path = "/",
+		.content_type = "text/html",
+		.type = HTTP_RESOURCE_STATIC,
+		.static_data = {
+			.data = index_html,
+			.len = sizeof(index_html) - 1,
+		},
+	},
+	{
+		.path = "/dynamic",
+		.type = HTTP_RESOURCE_DYNAMIC,
+		.cb = dynamic_cb,
+	},
+#if defined(CONFIG_FILE_SYSTEM)
+	{
+		.path = "/file",
+		.type = HTTP_RESOURCE_FS,
+		.fs_path = FILE_PATH,
+	},
+	{
+		.path = "/empty",
+		.type = HTTP_RESOURCE_FS,
+		.fs_path = EMPTY_PATH,
+	},
+	{
+		.path = "/missing",
+		.type = HTTP_RESOURCE_FS,
+		.fs_path = MNT_POINT "/missing.txt",
+	},
+#endif
+};
+
+static uint8_t recv_buf[256];
+static uint8_t raw_buf[512];
+static size_t body_len;
+static int status_code;
+static bool complete;
+
+static int on_body(struct http_parser *parser, const char *at, size_t length)
+{
+	body_len += length;
+
+	return 0;
+}
+
+static const struct http_parser_settings parser_cb = {
+	.on_body = on_body,
+};
+
+static void response_cb(struct http_response *rsp,
+			enum http_final_call final_data,
+			void *user_data)
+{
+	struct http_request *req = CONTAINER_OF(rsp, struct http_request,
+						internal.response);
+
+	if (final_data == HTTP_DATA_FINAL && rsp->message_complete) {
+		status_code = req->internal.parser.status_code;
+		complete = true;
+	}
+}
+
+/* Checked by test_stop(), assertions can only fail the test from the
+ * thread running it.
+ */
+static int server_ret;
+
+static void server(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	server_ret = http_server_run(&server_ctx);
+}
+
+static int connect_to_server(void)
+{
+	struct sockaddr_in addr;
+	int sock, ret;
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(sock >= 0, "Cannot create socket (%d)", errno);
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(SERVER_PORT);
+	inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr);
+
+	ret = connect(sock, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(ret, 0, "Cannot connect (%d)", errno);
+
+	return sock;
+}
+
+static void do_request(int sock, enum http_method method, const char *url)
+{
+	struct http_request req;
+	int ret;
+
+	memset(&req, 0, sizeof(req));
+
+	req.method = method;
+	req.url = url;
+	req.host = SERVER_ADDR;
+	req.protocol = "HTTP/1.1";
+	req.response = response_cb;
+	req.http_cb = &parser_cb;
+	req.recv_buf = recv_buf;
+	req.recv_buf_len = sizeof(recv_buf);
+
+	body_len = 0;
+	status_code = 0;
+	complete = false;
+
+	ret = http_client_req(sock, &req, TIMEOUT_MS, NULL);
+	zassert_true(ret > 0, "Cannot send request (%d)", ret);
+	zassert_true(complete, "Response not complete");
+	zassert_true(req.internal.response.keep_alive,
+		     "Server closes the connection");
+}
+
+static void test_init(void)
+{
+	struct sockaddr_in addr;
+	int ret;
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(SERVER_PORT);
+
+	ret = http_server_init(&server_ctx, (struct sockaddr *)&addr,
+			       sizeof(addr), resources, ARRAY_SIZE(resources));
+	zassert_equal(ret, 0, "Cannot init server (%d)", ret);
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack),
+			server, NULL, NULL, NULL,
+			SERVER_PRIORITY, 0, K_NO_WAIT);
+}
+
+static void test_static(void)
+{
+	int sock = connect_to_server();
+
+	do_request(sock, HTTP_GET, "/");
+	zassert_equal(status_code, 200, "Invalid status %d", status_code);
+	zassert_equal(body_len, sizeof(index_html) - 1,
+		      "Invalid body length %zd", body_len);
+
+	/* Query string is not part of the resource path */
+	do_request(sock, HTTP_GET, "/?lang=en");
+	zassert_equal(status_code, 200, "Invalid status %d", status_code);
+
+	do_request(sock, HTTP_HEAD, "/");
+	zassert_equal(status_code, 200, "Invalid status %d", status_code);
+	zassert_equal(body_len, 0, "HEAD response has a body");
+
+	(void)close(sock);
+}
+
+static void test_errors(void)
+{
+	int sock = connect_to_server();
+
+	do_request(sock, HTTP_GET, "/not_found");
+	zassert_equal(status_code, 404, "Invalid status %d", status_code);
+
+	do_request(sock, HTTP_DELETE, "/");
+	zassert_equal(status_code, 405, "Invalid status %d", status_code);
+
+	(void)close(sock);
+}
+
+static void test_chunked(void)
+{
+	int sock = connect_to_server();
+
+	do_request(sock, HTTP_GET, "/dynamic");
+	zassert_equal(status_code, 200, "Invalid status %d", status_code);
+	zassert_equal(body_len, DYNAMIC_CHUNKS * (sizeof(DYNAMIC_LINE) - 1),
+		      "Invalid body length %zd", body_len);
+
+	(void)close(sock);
+}
+
+#if defined(CONFIG_FILE_SYSTEM)
+static void create_file(const char *path, size_t size)
+{
+	struct fs_file_t file;
+	uint8_t data[64];
+	size_t len;
+	int ret;
+
+	memset(data, 'a', sizeof(data));
+
+	ret = fs_open(&file, path);
+	zassert_equal(ret, 0, "Cannot open %s (%d)", path, ret);
+
+	while (size > 0) {
+		len = MIN(size, sizeof(data));
+
+		ret = fs_write(&file, data, len);
+		zassert_equal(ret, len, "Cannot write %s (%d)", path, ret);
+
+		size -= len;
+	}
+
+	ret = fs_close(&file);
+	zassert_equal(ret, 0, "Cannot close %s (%d)", path, ret);
+}
+
+static void test_fs(void)
+{
+	const struct flash_area *fa;
+	int sock, ret;
+
+	ret = flash_area_open(FLASH_AREA_ID(storage), &fa);
+	zassert_equal(ret, 0, "flash_area_open failed (%d)", ret);
+
+	ret = flash_area_erase(fa, 0, fa->fa_size);
+	zassert_equal(ret, 0, "Cannot erase partition (%d)", ret);
+
+	flash_area_close(fa);
+
+	ret = fs_mount(&mnt);
+	zassert_equal(ret, 0, "Cannot mount (%d)", ret);
+
+	create_file(FILE_PATH, FILE_SIZE);
+	create_file(EMPTY_PATH, 0);
+
+	sock = connect_to_server();
+
+	do_request(sock, HTTP_GET, "/file");
+	zassert_equal(status_code, 200, "Invalid status %d", status_code);
+	zassert_equal(body_len, FILE_SIZE, "Invalid body length %zd",
+		      body_len);
+
+	/* do_request() checks that the connection is kept open */
+	do_request(sock, HTTP_GET, "/empty");
+	zassert_equal(status_code, 200, "Invalid status %d", status_code);
+	zassert_equal(body_len, 0, "Invalid body length %zd", body_len);
+
+	do_request(sock, HTTP_GET, "/missing");
+	zassert_equal(status_code, 404, "Invalid status %d", status_code);
+
+	do_request(sock, HTTP_GET, "/file");
+	zassert_equal(status_code, 200, "Invalid status %d", status_code);
+
+	(void)close(sock);
+
+	ret = fs_unmount(&mnt);
+	zassert_equal(ret, 0, "Cannot unmount (%d)", ret);
+}
+#else
+static void test_fs(void)
+{
+	ztest_test_skip();
+}
+#endif
+
+static void test_pipelined(void)
+{
+	static const char requests[] =
+		"GET / HTTP/1.1\r\nHost: " SERVER_ADDR "\r\n\r\n"
+		"GET /not_found HTTP/1.1\r\nHost: " SERVER_ADDR "\r\n\r\n"
+		"GET / HTTP/1.1\r\nHost: " SERVER_ADDR "\r\n"
+		"Connection: close\r\n\r\n";
+	int sock = connect_to_server();
+	size_t total = 0;
+	int ret, count = 0;
+	char *pos;
+
+	ret = send(sock, requests, sizeof(requests) - 1, 0);
+	zassert_equal(ret, sizeof(requests) - 1, "Cannot send (%d)", errno);
+
+	/* The server closes the connection after the last response */
+	do {
+		ret = recv(sock, raw_buf + total, sizeof(raw_buf) - 1 - total,
+			   0);
+		zassert_true(ret >= 0, "Cannot receive (%d)", errno);
+		total += ret;
+	} while (ret > 0 && total < sizeof(raw_buf) - 1);
+
+	raw_buf[total] = '\0';
+
+	for (pos = (char *)raw_buf; (pos = strstr(pos, "HTTP/1.1 ")) != NULL;
+	     pos++) {
+		count++;
+	}
+
+	zassert_equal(count, 3, "Got %d responses instead of 3", count);
+	zassert_not_null(strstr((char *)raw_buf, "404 Not Found"),
+			 "No 404 response");
+
+	(void)close(sock);
+}
+
+static void print_rate(const char *name, int count, int64_t elapsed)
+{
+	TC_PRINT("%s: %d requests in %d ms (%d requests/sec)\n", name, count,
+		 (int)elapsed, elapsed ? (int)(count * 1000 / elapsed) : 0);
+}
+
+static void test_benchmark_keep_alive(void)
+{
+	int sock = connect_to_server();
+	int64_t start = k_uptime_get();
+	int i;
+
+	for (i = 0; i < REQUEST_COUNT; i++) {
+		do_request(sock, HTTP_GET, "/");
+		zassert_equal(status_code, 200, "Invalid status %d",
+			      status_code);
+	}
+
+	print_rate("keep-alive", REQUEST_COUNT, k_uptime_delta(&start));
+
+	(void)close(sock);
+}
+
+static void test_benchmark_new_connection(void)
+{
+	int64_t start = k_uptime_get();
+	int i, sock;
+
+	for (i = 0; i < REQUEST_COUNT; i++) {
+		sock = connect_to_server();
+
+		do_request(sock, HTTP_GET, "/");
+		zassert_equal(status_code, 200, "Invalid status %d",
+			      status_code);
+
+		(void)close(sock);
+	}
+
+	print_rate("new connection per request", REQUEST_COUNT,
+		   k_uptime_delta(&start));
+}
+
+static void test_stop(void)
+{
+	int ret;
+
+	http_server_stop(&server_ctx);
+
+	ret = k_thread_join(&server_thread, K_MSEC(1000));
+	zassert_equal(ret, 0, "Server did not stop (%d)", ret);
+	zassert_equal(server_ret, 0, "Server failed (%d)", server_ret);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(http_server,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_static),
+			 ztest_unit_test(test_errors),
+			 ztest_unit_test(test_chunked),
+			 ztest_unit_test(test_fs),
+			 ztest_unit_test(test_pipelined),
+			 ztest_unit_test(test_benchmark_keep_alive),
+			 ztest_unit_test(test_benchmark_new_connection),
+			 ztest_unit_test(test_stop));
+
+	ztest_run_test_suite(http_server);
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <ztest.h>
+
+#include <net/socket.h>
+#include <net/tls_credentials.h>
+
+#define SERVER_ADDR "192.0.2.1"
+#define SERVER_PORT 4244
+#define SERVER_HOSTNAME "localhost"
+
+#define SERVER_CERTIFICATE_TAG 1
+
+#define CLIENT_COUNT 2
+
+#define SERVER_STACK_SIZE 8192
+#define SERVER_PRIORITY K_PRIO_PREEMPT(8)
+
+static const unsigned char server_certificate[] = {
+#include "echo-apps-cert.der.inc"
+};
+
+/* This is the private key in pkcs#8 format. */
+static const unsigned char private_key[] = {
+#include "echo-apps-key.der.inc"
+};
+
+K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+
+static int client_socks[CLIENT_COUNT];
+
+/* Result of the server socket setup, checked by the test thread since
+ * assertions can only fail the test from the thread running it.
+ */
+static int server_ret;
+static K_SEM_DEFINE(server_ready, 0, 1);
+
+static int server_setup(void)
+{
+	static const sec_tag_t sec_tags[] = { SERVER_CERTIFICATE_TAG };
+	int role = TLS_DTLS_ROLE_SERVER;
+	int multi_peer = 1;
+	struct sockaddr_in addr;
+	int sock, ret;
+
+	sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_DTLS_1_2);
+	if (sock < 0) {
+		LOG_ERR("Cannot create server socket (%d)", errno);
+		return -errno;
+	}
+
+	ret = setsockopt(sock, SOL_TLS, TLS_SEC_TAG_LIST, sec_tags,
+			 sizeof(sec_tags));
+	if (ret < 0) {
+		LOG_ERR("Cannot set credentials (%d)", errno);
+		return -errno;
+	}
+
+	ret = setsockopt(sock, SOL_TLS, TLS_DTLS_ROLE, &role, sizeof(role));
+	if (ret < 0) {
+		LOG_ERR("Cannot set role (%d)", errno);
+		return -errno;
+	}
+
+	ret = setsockopt(sock, SOL_TLS, TLS_DTLS_MULTI_PEER, &multi_peer,
+			 sizeof(multi_peer));
+	if (ret < 0) {
+		LOG_ERR("Cannot enable multi-peer mode (%d)", errno);
+		return -errno;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(SERVER_PORT);
+
+	ret = bind(sock, (struct sockaddr *)&addr, sizeof(addr));
+	if (ret < 0) {
+		LOG_ERR("Cannot bind (%d)", errno);
+		return -errno;
+	}
+
+	return sock;
+}
+
+/* Echo server serving all the clients with one socket. */
+static void server(void *p1, void *p2, void *p3)
+{
+	struct sockaddr_in addr;
+	socklen_t addrlen;
+	uint8_t buf[32];
+	int sock, ret;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	sock = server_setup();
+	server_ret = sock < 0 ? sock : 0;
+	k_sem_give(&server_ready);
+
+	if (sock < 0) {
+		return;
+	}
+
+	while (true) {
+		addrlen = sizeof(addr);
+
+		ret = recvfrom(sock, buf, sizeof(buf), 0,
+			       (struct sockaddr *)&addr, &addrlen);
+		if (ret < 0) {
+			continue;
+		}
+
+		(void)sendto(sock, buf, ret, 0, (struct sockaddr *)&addr,
+			     addrlen);
+	}
+}
+
+static int client_connect(void)
+{
+	int verify = TLS_PEER_VERIFY_NONE;
+	struct sockaddr_in addr;
+	int sock, ret;
+
+	sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_DTLS_1_2);
+	zassert_true(sock >= 0, "Cannot create socket (%d)", errno);
+
+	ret = setsockopt(sock, SOL_TLS, TLS_HOSTNAME, SERVER_HOSTNAME,
+			 sizeof(SERVER_HOSTNAME));
+	zassert_equal(ret, 0, "Cannot set hostname (%d)", errno);
+
+	ret = setsockopt(sock, SOL_TLS, TLS_PEER_VERIFY, &verify,
+			 sizeof(verify));
+	zassert_equal(ret, 0, "Cannot set peer verification (%d)", errno);
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(SERVER_PORT);
+	inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr);
+
+	ret = connect(sock, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(ret, 0, "Cannot connect (%d)", errno);
+
+	return sock;
+}
+
+static void test_init(void)
+{
+	int ret;
+
+	ret = tls_credential_add(SERVER_CERTIFICATE_TAG,
+				 TLS_CREDENTIAL_SERVER_CERTIFICATE,
+				 server_certificate,
+				 sizeof(server_certificate));
+	zassert_equal(ret, 0, "Cannot add certificate (%d)", ret);
+
+	ret = tls_credential_add(SERVER_CERTIFICATE_TAG,
+				 TLS_CREDENTIAL_PRIVATE_KEY,
+				 private_key, sizeof(private_key));
+	zassert_equal(ret, 0, "Cannot add private key (%d)", ret);
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack),
+			server, NULL, NULL, NULL,
+			SERVER_PRIORITY, 0, K_NO_WAIT);
+
+	ret = k_sem_take(&server_ready, K_SECONDS(1));
+	zassert_equal(ret, 0, "Server did not start");
+	zassert_equal(server_ret, 0, "Server setup failed (%d)", server_ret);
+}
+
+static void test_many_peers(void)
+{
+	char msg[16], reply[16];
+	int i, ret;
+
+	/* The handshake is done when the first datagram is sent. */
+	for (i = 0; i < CLIENT_COUNT; i++) {
+		client_socks[i] = client_connect();
+
+		snprintk(msg, sizeof(msg), "client %d", i);
+		ret = send(client_socks[i], msg, strlen(msg), 0);
+		zassert_equal(ret, strlen(msg), "Cannot send (%d)", errno);
+	}
+
+	/* All the sessions are still alive, each client gets its own
+	 * echo.
+	 */
+	for (i = 0; i < CLIENT_COUNT; i++) {
+		snprintk(msg, sizeof(msg), "client %d", i);
+
+		memset(reply, 0, sizeof(reply));
+		ret = recv(client_socks[i], reply, sizeof(reply) - 1, 0);
+		zassert_equal(ret, strlen(msg), "Cannot receive (%d)", errno);
+		zassert_mem_equal(reply, msg, ret, "Invalid echo %s", reply);
+	}
+
+	for (i = CLIENT_COUNT - 1; i >= 0; i--) {
+		ret = send(client_socks[i], "again", 5, 0);
+		zassert_equal(ret, 5, "Cannot send (%d)", errno);
+
+		ret = recv(client_socks[i], reply, sizeof(reply), 0);
+		zassert_equal(ret, 5, "Cannot receive (%d)", errno);
+	}
+
+	for (i = 0; i < CLIENT_COUNT; i++) {
+		(void)close(client_socks[i]);
+	}
+}
+
+static void test_multi_peer_option(void)
+{
+	socklen_t optlen = sizeof(int);
+	int sock, ret, multi_peer;
+
+	sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_DTLS_1_2);
+	zassert_true(sock >= 0, "Cannot create socket (%d)", errno);
+
+	ret = getsockopt(sock, SOL_TLS, TLS_DTLS_MULTI_PEER, &multi_peer,
+			 &optlen);
+	zassert_equal(ret, 0, "Cannot get multi-peer mode (%d)", errno);
+	zassert_equal(multi_peer, 0, "Multi-peer mode enabled by default");
+
+	multi_peer = 2;
+	ret = setsockopt(sock, SOL_TLS, TLS_DTLS_MULTI_PEER, &multi_peer,
+			 sizeof(multi_peer));
+	zassert_equal(ret, -1, "Invalid value accepted");
+	zassert_equal(errno, EINVAL, "Invalid errno %d", errno);
+
+	(void)close(sock);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(dtls_multi_peer,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_many_peers),
+			 ztest_unit_test(test_multi_peer_option));
+
+	ztest_run_test_suite(dtls_multi_peer);
+}
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_SOCKETS_LOG_LEVEL);
+
+#include <ztest.h>
+
+#include <net/socket.h>
+#include <net/tls_credentials.h>
+
+#define SERVER_ADDR "192.0.2.1"
+#define SERVER_PORT 4243
+#define SERVER_HOSTNAME "localhost"
+
+#define SERVER_CERTIFICATE_TAG 1
+
+/* Number of handshakes done in each measurement */
+#define HANDSHAKE_COUNT 5
+
+#define SERVER_STACK_SIZE 8192
+#define SERVER_PRIORITY K_PRIO_PREEMPT(8)
+
+static const unsigned char server_certificate[] = {
+#include "echo-apps-cert.der.inc"
+};
+
+/* This is the private key in pkcs#8 format. */
+static const unsigned char private_key[] = {
+#include "echo-apps-key.der.inc"
+};
+
+K_THREAD_STACK_DEFINE(server_stack, SERVER_STACK_SIZE);
+static struct k_thread server_thread;
+
+/* Result of the server socket setup, checked by the test thread since
+ * assertions can only fail the test from the thread running it.
+ */
+static int server_ret;
+static K_SEM_DEFINE(server_ready, 0, 1);
+
+static int server_setup(void)
+{
+	static const sec_tag_t sec_tags[] = { SERVER_CERTIFICATE_TAG };
+	int cache = TLS_SESSION_CACHE_ENABLED;
+	struct sockaddr_in addr;
+	int sock, ret;
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TLS_1_2);
+	if (sock < 0) {
+		LOG_ERR("Cannot create server socket (%d)", errno);
+		return -errno;
+	}
+
+	ret = setsockopt(sock, SOL_TLS, TLS_SEC_TAG_LIST, sec_tags,
+			 sizeof(sec_tags));
+	if (ret < 0) {
+		LOG_ERR("Cannot set credentials (%d)", errno);
+		return -errno;
+	}
+
+	ret = setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE, &cache,
+			 sizeof(cache));
+	if (ret < 0) {
+		LOG_ERR("Cannot enable session cache (%d)", errno);
+		return -errno;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(SERVER_PORT);
+
+	ret = bind(sock, (struct sockaddr *)&addr, sizeof(addr));
+	if (ret < 0) {
+		LOG_ERR("Cannot bind (%d)", errno);
+		return -errno;
+	}
+
+	ret = listen(sock, 1);
+	if (ret < 0) {
+		LOG_ERR("Cannot listen (%d)", errno);
+		return -errno;
+	}
+
+	return sock;
+}
+
+/* Local mbedTLS server stub. It accepts connections with session tickets
+ * and session caching enabled, and reads until the client closes the
+ * connection.
+ */
+static void server(void *p1, void *p2, void *p3)
+{
+	uint8_t buf[16];
+	int sock, client, ret;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	sock = server_setup();
+	server_ret = sock < 0 ? sock : 0;
+	k_sem_give(&server_ready);
+
+	if (sock < 0) {
+		return;
+	}
+
+	while (true) {
+		client = accept(sock, NULL, NULL);
+		if (client < 0) {
+			continue;
+		}
+
+		do {
+			ret = recv(client, buf, sizeof(buf), 0);
+		} while (ret > 0);
+
+		(void)close(client);
+	}
+}
+
+static int client_socket(int cache)
+{
+	int sock, ret;
+	int verify = TLS_PEER_VERIFY_NONE;
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TLS_1_2);
+	zassert_true(sock >= 0, "Cannot create socket (%d)", errno);
+
+	ret = setsockopt(sock, SOL_TLS, TLS_HOSTNAME, SERVER_HOSTNAME,
+			 sizeof(SERVER_HOSTNAME));
+	zassert_equal(ret, 0, "Cannot set hostname (%d)", errno);
+
+	ret = setsockopt(sock, SOL_TLS, TLS_PEER_VERIFY, &verify,
+			 sizeof(verify));
+	zassert_equal(ret, 0, "Cannot set peer verification (%d)", errno);
+
+	ret = setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE, &cache,
+			 sizeof(cache));
+	zassert_equal(ret, 0, "Cannot set session cache (%d)", errno);
+
+	return sock;
+}
+
+/* Connect to the server and return the time the handshake took. */
+static uint32_t handshake(int cache)
+{
+	struct sockaddr_in addr;
+	uint32_t start, cycles;
+	int sock, ret;
+
+	sock = client_socket(cache);
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(SERVER_PORT);
+	inet_pton(AF_INET, SERVER_ADDR, &addr.sin_addr);
+
+	start = k_cycle_get_32();
+
+	/* connect() returns after the TLS handshake */
+	ret = connect(sock, (struct sockaddr *)&addr, sizeof(addr));
+	cycles = k_cycle_get_32() - start;
+	zassert_equal(ret, 0, "Cannot connect (%d)", errno);
+
+	ret = send(sock, "ping", 4, 0);
+	zassert_equal(ret, 4, "Cannot send (%d)", errno);
+
+	(void)close(sock);
+
+	return k_cyc_to_us_floor32(cycles);
+}
+
+static void test_init(void)
+{
+	int ret;
+
+	ret = tls_credential_add(SERVER_CERTIFICATE_TAG,
+				 TLS_CREDENTIAL_SERVER_CERTIFICATE,
+				 server_certificate,
+				 sizeof(server_certificate));
+	zassert_equal(ret, 0, "Cannot add certificate (%d)", ret);
+
+	ret = tls_credential_add(SERVER_CERTIFICATE_TAG,
+				 TLS_CREDENTIAL_PRIVATE_KEY,
+				 private_key, sizeof(private_key));
+	zassert_equal(ret, 0, "Cannot add private key (%d)", ret);
+
+	k_thread_create(&server_thread, server_stack,
+			K_THREAD_STACK_SIZEOF(server_stack),
+			server, NULL, NULL, NULL,
+			SERVER_PRIORITY, 0, K_NO_WAIT);
+
+	ret = k_sem_take(&server_ready, K_SECONDS(1));
+	zassert_equal(ret, 0, "Server did not start");
+	zassert_equal(server_ret, 0, "Server setup failed (%d)", server_ret);
+}
+
+static void test_session_cache_option(void)
+{
+	int sock, ret, cache;
+	socklen_t optlen = sizeof(cache);
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TLS_1_2);
+	zassert_true(sock >= 0, "Cannot create socket (%d)", errno);
+
+	ret = getsockopt(sock, SOL_TLS, TLS_SESSION_CACHE, &cache, &optlen);
+	zassert_equal(ret, 0, "Cannot get session cache (%d)", errno);
+	zassert_equal(cache, TLS_SESSION_CACHE_DISABLED,
+		      "Session cache enabled by default");
+
+	cache = 2;
+	ret = setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE, &cache,
+			 sizeof(cache));
+	zassert_equal(ret, -1, "Invalid value accepted");
+	zassert_equal(errno, EINVAL, "Invalid errno %d", errno);
+
+	cache = TLS_SESSION_CACHE_ENABLED;
+	ret = setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE, &cache,
+			 sizeof(cache));
+	zassert_equal(ret, 0, "Cannot enable session cache (%d)", errno);
+
+	ret = getsockopt(sock, SOL_TLS, TLS_SESSION_CACHE, &cache, &optlen);
+	zassert_equal(ret, 0, "Cannot get session cache (%d)", errno);
+	zassert_equal(cache, TLS_SESSION_CACHE_ENABLED,
+		      "Session cache not enabled");
+
+	ret = setsockopt(sock, SOL_TLS, TLS_SESSION_CACHE_PURGE, NULL, 0);
+	zassert_equal(ret, 0, "Cannot purge session cache (%d)", errno);
+
+	(void)close(sock);
+}
+
+static void test_handshake_benchmark(void)
+{
+	uint32_t full = 0, resumed = 0;
+	int i;
+
+	for (i = 0; i < HANDSHAKE_COUNT; i++) {
+		full += handshake(TLS_SESSION_CACHE_DISABLED);
+	}
+
+	/* The first handshake with the cache enabled is a full one, the
+	 * following ones resume the stored session.
+	 */
+	(void)handshake(TLS_SESSION_CACHE_ENABLED);
+
+	for (i = 0; i < HANDSHAKE_COUNT; i++) {
+		resumed += handshake(TLS_SESSION_CACHE_ENABLED);
+	}
+
+	full /= HANDSHAKE_COUNT;
+	resumed /= HANDSHAKE_COUNT;
+
+	TC_PRINT("full handshake: %u us, resumed handshake: %u us\n",
+		 full, resumed);
+
+	zassert_true(resumed < full, "Session was not resumed");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(tls_session,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_session_cache_option),
+			 ztest_unit_test(test_handshake_benchmark));
+
+	ztest_run_test_suite(tls_session);
+}
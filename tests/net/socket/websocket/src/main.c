@@ -269,67 +269,86 @@ static void test_recv_two_msg(void)
 	test_recv_2(sizeof(frame1) + FRAME1_HDR_SIZE / 2);
 }
 
+static struct websocket_context verify_ctx;
+static size_t verify_total_read;
+
+static void verify_init(void)
+{
+	memset(&verify_ctx, 0, sizeof(verify_ctx));
+
+	verify_ctx.tmp_buf = temp_recv_buf;
+	verify_ctx.tmp_buf_len = sizeof(temp_recv_buf);
+
+	verify_total_read = 0;
+}
+
+/* Called by the websocket library for every sent chunk of data. The first
+ * chunk of a message starts with the websocket header and the payload might
+ * be sent in several chunks if it is masked or streamed.
+ */
 int verify_sent_and_received_msg(struct msghdr *msg, bool split_msg)
 {
-	static struct websocket_context ctx;
 	uint32_t msg_type = -1;
 	uint64_t remaining = -1;
-	size_t split_len = 0, total_read = 0;
-	int ret;
-
-	memset(&ctx, 0, sizeof(ctx));
-
-	ctx.tmp_buf = temp_recv_buf;
-	ctx.tmp_buf_len = sizeof(temp_recv_buf);
+	size_t split_len = 0, total_read, total_sent = 0;
+	int ret, i = 0;
 
 	/* Read first the header */
-	ret = test_recv_buf(msg->msg_iov[0].iov_base,
-			    msg->msg_iov[0].iov_len,
-			    &ctx, &msg_type, &remaining,
-			    recv_buf, sizeof(recv_buf));
-	zassert_equal(ret, -EAGAIN, "Msg header not found");
-
-	/* Then the first split if it is enabled */
-	if (split_msg) {
-		split_len = msg->msg_iov[1].iov_len / 2;
-
-		ret = test_recv_buf(msg->msg_iov[1].iov_base,
-				    split_len,
-				    &ctx, &msg_type, &remaining,
+	if (!verify_ctx.header_received) {
+		ret = test_recv_buf(msg->msg_iov[0].iov_base,
+				    msg->msg_iov[0].iov_len,
+				    &verify_ctx, &msg_type, &remaining,
 				    recv_buf, sizeof(recv_buf));
-		zassert_true(ret > 0, "Cannot read data (%d)", ret);
+		zassert_equal(ret, -EAGAIN, "Msg header not found");
 
-		total_read = ret;
+		total_sent += msg->msg_iov[0].iov_len;
+		i++;
 	}
 
-	/* Then the data */
-	while (remaining > 0) {
-		ret = test_recv_buf((uint8_t *)msg->msg_iov[1].iov_base +
-								total_read,
-				    msg->msg_iov[1].iov_len - total_read,
-				    &ctx, &msg_type, &remaining,
-				    recv_buf, sizeof(recv_buf));
-		zassert_true(ret > 0, "Cannot read data (%d)", ret);
-
-		if (memcmp(recv_buf, lorem_ipsum + total_read, ret) != 0) {
-			LOG_HEXDUMP_ERR(lorem_ipsum + total_read, ret,
-					"Received message should be");
-			LOG_HEXDUMP_ERR(recv_buf, ret, "but it was instead");
-			zassert_true(false, "Invalid received message "
-				     "after %d bytes", total_read);
+	for (; i < msg->msg_iovlen; i++) {
+		total_read = 0;
+		total_sent += msg->msg_iov[i].iov_len;
+
+		/* Then the first split if it is enabled */
+		if (split_msg) {
+			split_len = msg->msg_iov[i].iov_len / 2;
+			split_msg = false;
+		} else {
+			split_len = msg->msg_iov[i].iov_len;
 		}
 
-		total_read += ret;
-	}
+		/* Then the data */
+		while (total_read < msg->msg_iov[i].iov_len) {
+			ret = test_recv_buf((uint8_t *)msg->msg_iov[i].iov_base +
+								total_read,
+					    MAX(split_len, total_read) -
+								total_read,
+					    &verify_ctx, &msg_type, &remaining,
+					    recv_buf, sizeof(recv_buf));
+			zassert_true(ret > 0, "Cannot read data (%d)", ret);
+
+			if (memcmp(recv_buf, lorem_ipsum + verify_total_read,
+				   ret) != 0) {
+				LOG_HEXDUMP_ERR(lorem_ipsum + verify_total_read,
+						ret,
+						"Received message should be");
+				LOG_HEXDUMP_ERR(recv_buf, ret,
+						"but it was instead");
+				zassert_true(false, "Invalid received message "
+					     "after %zd bytes",
+					     verify_total_read);
+			}
 
-	zassert_equal(total_read, test_msg_len,
-		      "Msg body not valid, received %d instead of %zd",
-		      total_read, test_msg_len);
+			total_read += ret;
+			verify_total_read += ret;
+			split_len = msg->msg_iov[i].iov_len;
+		}
+	}
 
-	NET_DBG("Received %zd header and %zd body",
-		msg->msg_iov[0].iov_len, total_read);
+	NET_DBG("Received %zd bytes, %zd of payload in total", total_sent,
+		verify_total_read);
 
-	return msg->msg_iov[0].iov_len + total_read;
+	return total_sent;
 }
 
 static void test_send_and_recv_lorem_ipsum(void)
@@ -338,9 +357,7 @@ static void test_send_and_recv_lorem_ipsum(void)
 	int ret;
 
 	memset(&ctx, 0, sizeof(ctx));
-
-	ctx.tmp_buf = temp_recv_buf;
-	ctx.tmp_buf_len = sizeof(temp_recv_buf);
+	verify_init();
 
 	test_msg_len = sizeof(lorem_ipsum) - 1;
 
@@ -351,6 +368,9 @@ static void test_send_and_recv_lorem_ipsum(void)
 	zassert_equal(ret, test_msg_len,
 		      "Should have sent %zd bytes but sent %d instead",
 		      test_msg_len, ret);
+	zassert_equal(verify_total_read, test_msg_len,
+		      "Msg body not valid, received %zd instead of %zd",
+		      verify_total_read, test_msg_len);
 }
 
 static void test_recv_two_large_split_msg(void)
@@ -359,9 +379,7 @@ static void test_recv_two_large_split_msg(void)
 	int ret;
 
 	memset(&ctx, 0, sizeof(ctx));
-
-	ctx.tmp_buf = temp_recv_buf;
-	ctx.tmp_buf_len = sizeof(temp_recv_buf);
+	verify_init();
 
 	test_msg_len = sizeof(lorem_ipsum) - 1;
 
@@ -371,6 +389,68 @@ static void test_recv_two_large_split_msg(void)
 	zassert_equal(ret, test_msg_len,
 		      "1st should have sent %zd bytes but sent %d instead",
 		      test_msg_len, ret);
+	zassert_equal(verify_total_read, test_msg_len,
+		      "Msg body not valid, received %zd instead of %zd",
+		      verify_total_read, test_msg_len);
+}
+
+struct stream_data {
+	size_t pos;
+	size_t max_len;
+};
+
+/* Give the payload in odd sized pieces so that the masking needs to handle
+ * unaligned data and a masking key offset that is not zero.
+ */
+static int stream_payload_cb(uint8_t *buf, size_t len, void *user_data)
+{
+	struct stream_data *data = user_data;
+
+	len = MIN(len, data->max_len);
+
+	memcpy(buf, lorem_ipsum + data->pos, len);
+	data->pos += len;
+
+	return len;
+}
+
+static void send_stream(bool mask, size_t max_len)
+{
+	static struct websocket_context ctx;
+	struct stream_data data = {
+		.pos = 0,
+		.max_len = max_len,
+	};
+	int ret;
+
+	memset(&ctx, 0, sizeof(ctx));
+	verify_init();
+
+	test_msg_len = sizeof(lorem_ipsum) - 1;
+
+	ret = websocket_send_stream(POINTER_TO_INT(&ctx), test_msg_len,
+				    stream_payload_cb, &data,
+				    WEBSOCKET_OPCODE_DATA_TEXT, mask, true,
+				    SYS_FOREVER_MS);
+	zassert_equal(ret, test_msg_len,
+		      "Should have sent %zd bytes but sent %d instead",
+		      test_msg_len, ret);
+	zassert_equal(data.pos, test_msg_len,
+		      "Payload callback gave %zd bytes instead of %zd",
+		      data.pos, test_msg_len);
+	zassert_equal(verify_total_read, test_msg_len,
+		      "Msg body not valid, received %zd instead of %zd",
+		      verify_total_read, test_msg_len);
+}
+
+static void test_send_stream_masked(void)
+{
+	send_stream(true, 37);
+}
+
+static void test_send_stream_unmasked(void)
+{
+	send_stream(false, 61);
 }
 
 void test_main(void)
@@ -390,7 +470,9 @@ void test_main(void)
 			 ztest_unit_test(test_recv_whole_msg),
 			 ztest_unit_test(test_recv_two_msg),
 			 ztest_unit_test(test_send_and_recv_lorem_ipsum),
-			 ztest_unit_test(test_recv_two_large_split_msg)
+			 ztest_unit_test(test_recv_two_large_split_msg),
+			 ztest_unit_test(test_send_stream_masked),
+			 ztest_unit_test(test_send_stream_unmasked)
 		);
 
 	ztest_run_test_suite(websocket);
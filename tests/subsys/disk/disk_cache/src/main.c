@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Checks when the writes through the disk sector cache reach the media,
+ * using a RAM disk whose sectors the test can inspect.
+ */
+
+#include <ztest.h>
+#include <disk/disk_access.h>
+
+#define DISK_NAME "CACHE_TEST"
+#define SECTOR_SIZE CONFIG_DISK_CACHE_SECTOR_SIZE
+#define SECTOR_COUNT 16
+
+static uint8_t media[SECTOR_COUNT][SECTOR_SIZE];
+static uint8_t buf[SECTOR_SIZE];
+
+static int test_disk_init(struct disk_info *disk)
+{
+	return 0;
+}
+
+static int test_disk_status(struct disk_info *disk)
+{
+	return DISK_STATUS_OK;
+}
+
+static int test_disk_read(struct disk_info *disk, uint8_t *data_buf,
+			  uint32_t start_sector, uint32_t num_sector)
+{
+	if (start_sector + num_sector > SECTOR_COUNT) {
+		return -EIO;
+	}
+
+	memcpy(data_buf, media[start_sector], num_sector * SECTOR_SIZE);
+	return 0;
+}
+
+static int test_disk_write(struct disk_info *disk, const uint8_t *data_buf,
+			   uint32_t start_sector, uint32_t num_sector)
+{
+	if (start_sector + num_sector > SECTOR_COUNT) {
+		return -EIO;
+	}
+
+	memcpy(media[start_sector], data_buf, num_sector * SECTOR_SIZE);
+	return 0;
+}
+
+static int test_disk_ioctl(struct disk_info *disk, uint8_t cmd, void *buff)
+{
+	switch (cmd) {
+	case DISK_IOCTL_CTRL_SYNC:
+		return 0;
+	case DISK_IOCTL_GET_SECTOR_COUNT:
+		*(uint32_t *)buff = SECTOR_COUNT;
+		return 0;
+	case DISK_IOCTL_GET_SECTOR_SIZE:
+		*(uint32_t *)buff = SECTOR_SIZE;
+		return 0;
+	default:
+		break;
+	}
+
+	return -EINVAL;
+}
+
+static const struct disk_operations test_disk_ops = {
+	.init = test_disk_init,
+	.status = test_disk_status,
+	.read = test_disk_read,
+	.write = test_disk_write,
+	.ioctl = test_disk_ioctl,
+};
+
+static struct disk_info test_disk = {
+	.name = DISK_NAME,
+	.ops = &test_disk_ops,
+};
+
+static void write_sector(uint32_t sector, uint8_t value)
+{
+	int err;
+
+	memset(buf, value, sizeof(buf));
+
+	err = disk_access_write(DISK_NAME, buf, sector, 1);
+	zassert_equal(err, 0, "Cannot write sector %u (%d)", sector, err);
+}
+
+static void check_sector(uint32_t sector, uint8_t value)
+{
+	int err;
+
+	err = disk_access_read(DISK_NAME, buf, sector, 1);
+	zassert_equal(err, 0, "Cannot read sector %u (%d)", sector, err);
+
+	for (int i = 0; i < SECTOR_SIZE; i++) {
+		zassert_equal(buf[i], value, "Sector %u reads %x instead of %x",
+			      sector, buf[i], value);
+	}
+}
+
+static bool media_has(uint32_t sector, uint8_t value)
+{
+	for (int i = 0; i < SECTOR_SIZE; i++) {
+		if (media[sector][i] != value) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void test_init(void)
+{
+	int err;
+
+	err = disk_access_register(&test_disk);
+	zassert_equal(err, 0, "Cannot register disk (%d)", err);
+
+	err = disk_access_init(DISK_NAME);
+	zassert_equal(err, 0, "Cannot init disk (%d)", err);
+
+	/* fill the cache with the sectors used by the tests */
+	check_sector(2, 0);
+	check_sector(3, 0);
+}
+
+static void test_write_sync(void)
+{
+	int err;
+
+	write_sector(2, 0xa5);
+
+	/* later reads see the written data, from the cache or not */
+	check_sector(2, 0xa5);
+
+	if (IS_ENABLED(CONFIG_DISK_CACHE_WRITE_BACK)) {
+		zassert_true(media_has(2, 0), "Write not kept in the cache");
+	} else {
+		zassert_true(media_has(2, 0xa5), "Write not done to the media");
+	}
+
+	err = disk_access_ioctl(DISK_NAME, DISK_IOCTL_CTRL_SYNC, NULL);
+	zassert_equal(err, 0, "Cannot sync (%d)", err);
+
+	zassert_true(media_has(2, 0xa5), "Sync did not write the sector");
+	check_sector(2, 0xa5);
+}
+
+static void test_reinit(void)
+{
+	int err;
+
+	write_sector(3, 0x5a);
+
+	/* The media could have been changed, the modified sector is
+	 * dropped rather than written to it.
+	 */
+	err = disk_access_init(DISK_NAME);
+	zassert_equal(err, 0, "Cannot init disk (%d)", err);
+
+	if (IS_ENABLED(CONFIG_DISK_CACHE_WRITE_BACK)) {
+		zassert_true(media_has(3, 0), "Dropped sector was written");
+		check_sector(3, 0);
+	} else {
+		zassert_true(media_has(3, 0x5a), "Write not done to the media");
+		check_sector(3, 0x5a);
+	}
+}
+
+static void test_unregister(void)
+{
+	int err;
+
+	write_sector(4, 0x3c);
+
+	/* the disk is still there, its modified sectors are written */
+	err = disk_access_unregister(&test_disk);
+	zassert_equal(err, 0, "Cannot unregister disk (%d)", err);
+
+	zassert_true(media_has(4, 0x3c), "Sector lost on unregister");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(disk_cache,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_write_sync),
+			 ztest_unit_test(test_reinit),
+			 ztest_unit_test(test_unregister));
+
+	ztest_run_test_suite(disk_cache);
+}
@@ -596,6 +596,75 @@ void test_delete(void)
 		     " any footprint in the storage");
 }
 
+static int flash_sim_read_calls_find(struct stats_hdr *hdr, void *arg,
+				     const char *name, uint16_t off)
+{
+	if (!strcmp(name, "flash_read_calls")) {
+		uint32_t **flash_read_stat = (uint32_t **) arg;
+		*flash_read_stat = (uint32_t *)((uint8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+static void lookup_benchmark(uint16_t id_count)
+{
+	int err;
+	ssize_t len;
+	uint16_t id;
+	uint32_t data, reads, start, cycles;
+	uint32_t *flash_read_stat;
+
+	err = nvs_clear(&fs);
+	zassert_true(err == 0,  "nvs_clear call failure: %d", err);
+
+	/* Room for 1000 ids without garbage collection */
+	fs.sector_size = 8 * 1024;
+	fs.sector_count = 4;
+
+	err = nvs_init(&fs, DT_CHOSEN_ZEPHYR_FLASH_CONTROLLER_LABEL);
+	zassert_true(err == 0,  "nvs_init call failure: %d", err);
+
+	for (id = 0; id < id_count; id++) {
+		data = id;
+		len = nvs_write(&fs, id, &data, sizeof(data));
+		zassert_true(len == sizeof(data), "nvs_write failed: %d", len);
+	}
+
+	stats_walk(sim_stats, flash_sim_read_calls_find, &flash_read_stat);
+	*flash_read_stat = 0;
+
+	start = k_cycle_get_32();
+
+	for (id = 0; id < id_count; id++) {
+		len = nvs_read(&fs, id, &data, sizeof(data));
+		zassert_true(len == sizeof(data),
+			     "nvs_read unexpected failure: %d", len);
+		zassert_equal(data, id, "Invalid data for id %d", id);
+	}
+
+	cycles = k_cycle_get_32() - start;
+	reads = *flash_read_stat;
+
+	TC_PRINT("%u ids: %u us, %u flash reads per nvs_read\n", id_count,
+		 k_cyc_to_us_floor32(cycles) / id_count, reads / id_count);
+
+	/* With the lookup cache the ate and the data are read directly */
+	if (IS_ENABLED(CONFIG_NVS_LOOKUP_CACHE)) {
+		zassert_true(reads < 3 * id_count,
+			     "Too many flash reads: %u", reads);
+	}
+}
+
+/**
+ * Time reading all the ids, with and without the lookup cache
+ */
+void test_nvs_lookup_benchmark(void)
+{
+	lookup_benchmark(100);
+	lookup_benchmark(1000);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_nvs,
@@ -615,7 +684,9 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(test_nvs_full_sector,
 				 setup, teardown),
 			 ztest_unit_test_setup_teardown(test_delete, setup,
-				 teardown)
+				 teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_lookup_benchmark, setup, teardown)
 			);
 
 	ztest_run_test_suite(test_nvs);
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2020 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <ztest.h>
+#include <settings/settings.h>
+#include <stats/stats.h>
+#include <storage/flash_map.h>
+
+/* Number of updates of the same setting */
+#define UPDATE_COUNT 100
+
+static struct stats_hdr *wb_stats;
+
+struct load_result {
+	uint32_t value;
+	bool found;
+};
+
+static int stat_find(struct stats_hdr *hdr, void *arg, const char *name,
+		     uint16_t off)
+{
+	const char **wanted = (const char **)arg;
+
+	if (!strcmp(name, wanted[0])) {
+		wanted[1] = (const char *)hdr + off;
+	}
+
+	return 0;
+}
+
+static uint32_t stat_get(const char *name)
+{
+	const char *wanted[2] = { name, NULL };
+
+	stats_walk(wb_stats, stat_find, wanted);
+	zassert_not_null(wanted[1], "No %s stat", name);
+
+	return *(const uint32_t *)wanted[1];
+}
+
+static int direct_loader(const char *key, size_t len, settings_read_cb read_cb,
+			 void *cb_arg, void *param)
+{
+	struct load_result *result = param;
+	int rc;
+
+	if (key != NULL || len == 0) {
+		return 0;
+	}
+
+	rc = read_cb(cb_arg, &result->value, sizeof(result->value));
+	zassert_equal(rc, sizeof(result->value), "Cannot read (%d)", rc);
+	result->found = true;
+
+	return 0;
+}
+
+static struct load_result load(const char *name)
+{
+	struct load_result result = { 0 };
+	int rc;
+
+	rc = settings_load_subtree_direct(name, direct_loader, &result);
+	zassert_equal(rc, 0, "Cannot load %s (%d)", name, rc);
+
+	return result;
+}
+
+static void test_init(void)
+{
+	const struct flash_area *fap;
+	int rc;
+
+	rc = flash_area_open(FLASH_AREA_ID(storage), &fap);
+	zassert_equal(rc, 0, "Cannot open storage (%d)", rc);
+	rc = flash_area_erase(fap, 0, fap->fa_size);
+	zassert_equal(rc, 0, "Cannot erase storage (%d)", rc);
+	flash_area_close(fap);
+
+	rc = settings_subsys_init();
+	zassert_equal(rc, 0, "settings_subsys_init failed (%d)", rc);
+
+	wb_stats = stats_group_find("settings_wb_stats");
+	zassert_not_null(wb_stats, "No write-back stats");
+}
+
+static void test_coalesce(void)
+{
+	uint32_t saves, writes, value;
+	struct load_result result;
+	int rc;
+
+	saves = stat_get("saves");
+	writes = stat_get("writes");
+
+	for (value = 0; value < UPDATE_COUNT; value++) {
+		rc = settings_save_one("wb/counter", &value, sizeof(value));
+		zassert_equal(rc, 0, "Cannot save (%d)", rc);
+	}
+
+	zassert_equal(stat_get("writes"), writes, "Update was not buffered");
+
+	rc = settings_flush();
+	zassert_equal(rc, 0, "Cannot flush (%d)", rc);
+
+	TC_PRINT("%u saves, %u writes to flash\n", stat_get("saves") - saves,
+		 stat_get("writes") - writes);
+
+	zassert_equal(stat_get("writes"), writes + 1,
+		      "Updates were not coalesced");
+
+	result = load("wb/counter");
+	zassert_true(result.found, "Setting not stored");
+	zassert_equal(result.value, UPDATE_COUNT - 1, "Wrong value %u",
+		      result.value);
+}
+
+static void test_delete(void)
+{
+	uint32_t value = 1U;
+	int rc;
+
+	rc = settings_save_one("wb/temp", &value, sizeof(value));
+	zassert_equal(rc, 0, "Cannot save (%d)", rc);
+
+	rc = settings_delete("wb/temp");
+	zassert_equal(rc, 0, "Cannot delete (%d)", rc);
+
+	rc = settings_delete("wb/counter");
+	zassert_equal(rc, 0, "Cannot delete (%d)", rc);
+
+	/* Loading writes the buffered settings first */
+	zassert_false(load("wb/temp").found, "Deleted setting loaded");
+	zassert_false(load("wb/counter").found, "Deleted setting loaded");
+}
+
+static void test_null_value(void)
+{
+	uint32_t saves = stat_get("saves");
+	int rc;
+
+	rc = settings_save_one("wb/null", NULL, sizeof(uint32_t));
+	zassert_equal(rc, -EINVAL, "NULL value accepted (%d)", rc);
+	zassert_equal(stat_get("saves"), saves, "NULL value buffered");
+}
+
+static void test_threshold(void)
+{
+	char name[16];
+	uint32_t writes, value;
+
+	writes = stat_get("writes");
+
+	for (value = 0; value < CONFIG_SETTINGS_WRITE_BACK_THRESHOLD;
+	     value++) {
+		snprintk(name, sizeof(name), "wb/key%u", value);
+		zassert_equal(settings_save_one(name, &value, sizeof(value)),
+			      0, "Cannot save %s", name);
+	}
+
+	zassert_equal(stat_get("writes"),
+		      writes + CONFIG_SETTINGS_WRITE_BACK_THRESHOLD,
+		      "Buffer not written at the threshold");
+}
+
+static void test_delay(void)
+{
+	uint32_t writes, value = 2U;
+	int rc;
+
+	writes = stat_get("writes");
+
+	rc = settings_save_one("wb/delayed", &value, sizeof(value));
+	zassert_equal(rc, 0, "Cannot save (%d)", rc);
+
+	k_sleep(K_MSEC(CONFIG_SETTINGS_WRITE_BACK_DELAY / 2));
+	zassert_equal(stat_get("writes"), writes, "Written too early");
+
+	k_sleep(K_MSEC(CONFIG_SETTINGS_WRITE_BACK_DELAY));
+	zassert_equal(stat_get("writes"), writes + 1, "Not written");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(settings_write_back,
+			 ztest_unit_test(test_init),
+			 ztest_unit_test(test_coalesce),
+			 ztest_unit_test(test_delete),
+			 ztest_unit_test(test_null_value),
+			 ztest_unit_test(test_threshold),
+			 ztest_unit_test(test_delay));
+
+	ztest_run_test_suite(settings_write_back);
+}